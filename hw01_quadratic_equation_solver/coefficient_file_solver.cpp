@@ -0,0 +1,315 @@
+#include "coefficient_file_solver.h"
+#include "mapped_file.h"
+#include "root_columns.h"
+#include "work_stealing.h"
+
+#include <cassert>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace coefficient_file_details
+{
+    const size_t block_size = 256;               // equations solved by one call of try_solve_quadratic_equations
+    const size_t binary_chunk_size = 1 << 16;    // equations in one chunk of a binary file
+    const size_t csv_chunk_size = 1 << 20;       // bytes in one chunk of a CSV file (approximately)
+
+    const char *status_name(int status)
+    {
+        switch (status) {
+            case SOLVER_OVERFLOW:         return "overflow";
+            case SOLVER_NOT_FINITE_INPUT: return "not_finite_input";
+            default:                      return "ok";
+        }
+    }
+
+/*
+Solves n equations, which coefficients go one after another (a, b, c, a, b, c, ...) in coefficients,
+and passes the results of every block to write(offset of the block, its size, nroots, first_roots, second_roots, statuses)
+*/
+    template<typename Writer>
+    void solve_binary_chunk(const double *coefficients, size_t n, Writer &&write)
+    {
+        double a[block_size], b[block_size], c[block_size];
+        double first_roots[block_size], second_roots[block_size];
+        int nroots[block_size];
+        solver_status statuses[block_size];
+
+        for (size_t i = 0; i < n; i += block_size) {
+            size_t size = (n - i < block_size ? n - i : block_size);
+            for (size_t j = 0; j < size; j++) {
+                a[j] = coefficients[3 * (i + j)];
+                b[j] = coefficients[3 * (i + j) + 1];
+                c[j] = coefficients[3 * (i + j) + 2];
+            }
+            try_solve_quadratic_equations(a, b, c, size, nroots, first_roots, second_roots, statuses);
+            write(i, size, nroots, first_roots, second_roots, statuses);
+        }
+    }
+
+    void solve_binary_file(const char *file_in_path, const char *file_out_path, unsigned nthreads, result_file_format format)
+    {
+        mapped_file file_in(file_in_path);
+        if (file_in.size() % (3 * sizeof(double)) != 0) {
+            throw std::invalid_argument((std::string)"solve_coefficient_file: size of " + file_in_path +
+                                        " is not a multiple of the size of three doubles");
+        }
+        size_t n = file_in.size() / (3 * sizeof(double));
+        const double *coefficients = (const double *)file_in.data();
+        const size_t nchunks = (n + binary_chunk_size - 1) / binary_chunk_size;
+
+        if (format != NATIVE_RESULTS) {
+            // chunks begin at multiples of 64, so the threads do not share words of the validity bitmaps
+            root_columns columns(file_out_path, n, format == COLUMNAR_RESULTS_WITH_VALIDITY);
+            run_work_stealing(nchunks, nthreads, [&](size_t chunk) {
+                size_t begin = chunk * binary_chunk_size;
+                size_t end = (n - begin < binary_chunk_size ? n : begin + binary_chunk_size);
+                solve_binary_chunk(coefficients + 3 * begin, end - begin,
+                                   [&](size_t offset, size_t size, const int *nroots, const double *first_roots,
+                                       const double *second_roots, const solver_status *statuses) {
+                    columns.write(begin + offset, size, nroots, first_roots, second_roots, statuses);
+                });
+            });
+            return;
+        }
+
+        mapped_file file_out(file_out_path, n * sizeof(solved_equation));
+        solved_equation *results = (solved_equation *)file_out.data();
+        run_work_stealing(nchunks, nthreads, [&](size_t chunk) {
+            size_t begin = chunk * binary_chunk_size;
+            size_t end = (n - begin < binary_chunk_size ? n : begin + binary_chunk_size);
+            solve_binary_chunk(coefficients + 3 * begin, end - begin,
+                               [&](size_t offset, size_t size, const int *nroots, const double *first_roots,
+                                   const double *second_roots, const solver_status *statuses) {
+                for (size_t j = 0; j < size; j++) {
+                    results[begin + offset + j] = {nroots[j], statuses[j], first_roots[j], second_roots[j]};
+                }
+            });
+        });
+    }
+
+/*
+Skips spaces and tabs
+*/
+    inline const char *skip_blanks(const char *cur, const char *end)
+    {
+        while (cur < end && (*cur == ' ' || *cur == '\t' || *cur == '\r')) {
+            cur++;
+        }
+        return cur;
+    }
+
+/*
+Reads number and the separator (',' or the end of the line) after it. Returns nullptr on failure
+*/
+    const char *read_coefficient(const char *cur, const char *end, double &value, bool last)
+    {
+        cur = skip_blanks(cur, end);
+        std::from_chars_result res = std::from_chars(cur, end, value);
+        if (res.ec != std::errc()) {
+            return nullptr;
+        }
+        cur = skip_blanks(res.ptr, end);
+        if (last) {
+            return (cur == end || *cur == '\n' ? cur : nullptr);
+        }
+        return (cur < end && *cur == ',' ? cur + 1 : nullptr);
+    }
+
+    void append_root(std::string &text, double root)
+    {
+        text += ',';
+        if (!std::isnan(root)) {
+            char buffer[32] = {};
+            text.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), root).ptr);
+        }
+    }
+
+    void append_results(std::string &text, const int *nroots, const double *first_roots, const double *second_roots,
+                        const solver_status *statuses, size_t n)
+    {
+        for (size_t i = 0; i < n; i++) {
+            if (statuses[i] == SOLVER_OK) {
+                text += std::to_string(nroots[i]);
+            } else {
+                text += status_name(statuses[i]);
+            }
+            append_root(text, first_roots[i]);
+            append_root(text, second_roots[i]);
+            text += '\n';
+        }
+    }
+
+/*
+Solves equations from lines [begin, end) of CSV file and passes the results of every block
+to write(nroots, first_roots, second_roots, statuses, size of the block).
+offset is the offset of begin in the file (for error messages).
+*/
+    template<typename Writer>
+    void solve_csv_chunk(const char *begin, const char *end, uint64_t offset, Writer &&write)
+    {
+        double a[block_size], b[block_size], c[block_size];
+        double first_roots[block_size], second_roots[block_size];
+        int nroots[block_size];
+        solver_status statuses[block_size];
+        size_t size = 0;
+
+        for (const char *cur = begin; cur < end; cur++) {
+            const char *line_begin = cur;
+            cur = skip_blanks(cur, end);
+            if (cur == end) {
+                break;
+            }
+            if (*cur == '\n') { // empty line
+                continue;
+            }
+            cur = read_coefficient(cur, end, a[size], false);
+            cur = (cur ? read_coefficient(cur, end, b[size], false) : nullptr);
+            cur = (cur ? read_coefficient(cur, end, c[size], true) : nullptr);
+            if (cur == nullptr) {
+                throw std::invalid_argument("solve_coefficient_file: cannot parse the line at byte " +
+                                            std::to_string(offset + (line_begin - begin)));
+            }
+            if (++size == block_size) {
+                try_solve_quadratic_equations(a, b, c, size, nroots, first_roots, second_roots, statuses);
+                write(nroots, first_roots, second_roots, statuses, size);
+                size = 0;
+            }
+        }
+        try_solve_quadratic_equations(a, b, c, size, nroots, first_roots, second_roots, statuses);
+        write(nroots, first_roots, second_roots, statuses, size);
+    }
+
+/*
+Results of a chunk of CSV file, column by column
+*/
+    struct chunk_columns
+    {
+        std::vector<int> nroots;
+        std::vector<double> first_roots, second_roots;
+        std::vector<solver_status> statuses;
+    };
+
+/*
+Solves the chunks of CSV file and writes all the results to the root columns file, when their number is known
+*/
+    void solve_csv_file_to_columns(const char *data, const std::vector<uint64_t> &chunk_begins, const char *file_out_path,
+                                   unsigned nthreads, bool validity)
+    {
+        size_t nchunks = chunk_begins.size() - 1;
+        std::vector<chunk_columns> results(nchunks);
+        run_work_stealing(nchunks, nthreads, [&](size_t chunk) {
+            chunk_columns &cur = results[chunk];
+            solve_csv_chunk(data + chunk_begins[chunk], data + chunk_begins[chunk + 1], chunk_begins[chunk],
+                            [&](const int *nroots, const double *first_roots, const double *second_roots,
+                                const solver_status *statuses, size_t size) {
+                cur.nroots.insert(cur.nroots.end(), nroots, nroots + size);
+                cur.first_roots.insert(cur.first_roots.end(), first_roots, first_roots + size);
+                cur.second_roots.insert(cur.second_roots.end(), second_roots, second_roots + size);
+                cur.statuses.insert(cur.statuses.end(), statuses, statuses + size);
+            });
+        });
+
+        uint64_t n = 0;
+        for (const chunk_columns &cur : results) {
+            n += cur.nroots.size();
+        }
+        root_columns columns(file_out_path, n, validity);
+        uint64_t begin = 0;
+        for (chunk_columns &cur : results) {
+            columns.write(begin, cur.nroots.size(), cur.nroots.data(), cur.first_roots.data(),
+                          cur.second_roots.data(), cur.statuses.data());
+            begin += cur.nroots.size();
+            cur = chunk_columns();
+        }
+    }
+
+    void solve_csv_file(const char *file_in_path, const char *file_out_path, unsigned nthreads, result_file_format format)
+    {
+        mapped_file file_in(file_in_path);
+        const char *data = file_in.data();
+        const uint64_t size = file_in.size();
+
+        std::vector<uint64_t> chunk_begins = {0}; // chunks end after '\n'
+        while (chunk_begins.back() < size) {
+            uint64_t next = chunk_begins.back() + csv_chunk_size;
+            if (next >= size) {
+                next = size;
+            } else {
+                const char *newline = (const char *)memchr(data + next, '\n', size - next);
+                next = (newline != nullptr ? newline - data + 1 : size);
+            }
+            chunk_begins.push_back(next);
+        }
+        size_t nchunks = chunk_begins.size() - 1;
+
+        if (format != NATIVE_RESULTS) {
+            solve_csv_file_to_columns(data, chunk_begins, file_out_path, nthreads, format == COLUMNAR_RESULTS_WITH_VALIDITY);
+            return;
+        }
+
+        std::unique_ptr<FILE, int (*)(FILE *)> file_out(fopen(file_out_path, "wb"), fclose);
+        if (file_out == nullptr) {
+            throw std::runtime_error((std::string)"solve_coefficient_file: cannot open " + file_out_path);
+        }
+
+        /* Chunks are written in order: the thread which finished the chunk next_chunk_to_write writes it and all the following finished chunks */
+        std::vector<std::string> results(nchunks);
+        std::vector<bool> solved(nchunks, false);
+        size_t next_chunk_to_write = 0;
+        std::mutex write_mutex;
+
+        run_work_stealing(nchunks, nthreads, [&](size_t chunk) {
+            std::string text;
+            solve_csv_chunk(data + chunk_begins[chunk], data + chunk_begins[chunk + 1], chunk_begins[chunk],
+                            [&](const int *nroots, const double *first_roots, const double *second_roots,
+                                const solver_status *statuses, size_t size) {
+                append_results(text, nroots, first_roots, second_roots, statuses, size);
+            });
+
+            std::lock_guard<std::mutex> lock(write_mutex);
+            results[chunk] = std::move(text);
+            solved[chunk] = true;
+            for (; next_chunk_to_write < nchunks && solved[next_chunk_to_write]; next_chunk_to_write++) {
+                std::string &cur = results[next_chunk_to_write];
+                if (fwrite(cur.data(), 1, cur.size(), file_out.get()) != cur.size()) {
+                    throw std::runtime_error((std::string)"solve_coefficient_file: error occurred while writing in " + file_out_path);
+                }
+                std::string().swap(cur);
+            }
+        });
+
+        if (fclose(file_out.release()) != 0) {
+            throw std::runtime_error((std::string)"solve_coefficient_file: cannot close " + file_out_path);
+        }
+    }
+}
+
+
+/* See description in coefficient_file_solver.h */
+
+void solve_coefficient_file(const char *file_in_path, const char *file_out_path,
+                            coefficient_file_format format, unsigned nthreads, result_file_format results)
+{
+    assert(file_in_path != nullptr && file_out_path != nullptr);
+    if (results != NATIVE_RESULTS && results != COLUMNAR_RESULTS && results != COLUMNAR_RESULTS_WITH_VALIDITY) {
+        throw std::invalid_argument("solve_coefficient_file: unknown result format");
+    }
+
+    switch (format) {
+        case BINARY_COEFFICIENTS:
+            coefficient_file_details::solve_binary_file(file_in_path, file_out_path, nthreads, results);
+            break;
+        case CSV_COEFFICIENTS:
+            coefficient_file_details::solve_csv_file(file_in_path, file_out_path, nthreads, results);
+            break;
+        default:
+            throw std::invalid_argument("solve_coefficient_file: unknown format");
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef __COEFFICIENT_FILE_SOLVER_HEADER
+#define __COEFFICIENT_FILE_SOLVER_HEADER
+
+#include <cstdint>
+
+#include "quadratic_equation_solver.h"
+
+enum coefficient_file_format {
+    BINARY_COEFFICIENTS, //!< Input is an array of (double a, double b, double c), output is an array of solved_equation
+    CSV_COEFFICIENTS     //!< Input lines are "a,b,c", output lines are "nroots,first_root,second_root"
+};
+
+enum result_file_format {
+    NATIVE_RESULTS,                //!< Output format follows the input format (see coefficient_file_format)
+    COLUMNAR_RESULTS,              //!< Output is a root columns file (see root_columns.h)
+    COLUMNAR_RESULTS_WITH_VALIDITY //!< Output is a root columns file with validity bitmaps
+};
+
+//! One record of the binary output file
+struct solved_equation
+{
+    int32_t nroots;      //!< Number of roots (see solve_quadratic_equation)
+    int32_t status;      //!< solver_status of the equation
+    double first_root;   //!< The first root or NAN
+    double second_root;  //!< The second root or NAN
+};
+
+///-------------------------------------------------------------------------------------
+//! Solves every quadratic equation from the file and writes the results to another file in the same order
+//!
+//! @param [in] file_in_path   Path to the file with coefficients
+//! @param [in] file_out_path  Path to the file where to write the roots
+//! @param [in] format         Format of the input file (and of the output file with @c NATIVE_RESULTS)
+//! @param [in] nthreads       Number of threads (0 means the number of hardware threads)
+//! @param [in] results        Format of the output file
+//!
+//! @attention If @c file_out_path exists, it will be overwritten
+//!
+//! @note The input file is mapped to memory and split into chunks, which are solved by
+//!       @c nthreads threads with work stealing (see run_work_stealing).
+//!       Binary results are written directly to the mapped output file, CSV chunks are
+//!       written as soon as all the previous chunks are written.
+//!       Root columns of binary input are written directly to the mapped output file too, the ones of
+//!       CSV input are kept in memory until all the chunks are solved (the number of equations is not known before).
+//!
+//! @note Equations are solved with @c try_solve_quadratic_equations. In CSV output not calculated
+//!       roots are left empty and failed equations have "overflow" or "not_finite_input" instead
+//!       of the number of roots.
+//!
+//! @note Errors in the files are reported with std::invalid_argument, input/output errors
+//!       are reported with std::runtime_error.
+//!
+///-------------------------------------------------------------------------------------
+void solve_coefficient_file(const char *file_in_path, const char *file_out_path,
+                            coefficient_file_format format, unsigned nthreads,
+                            result_file_format results = NATIVE_RESULTS);
+
+#endif
@@ -0,0 +1,412 @@
+#include "linear_system_solver.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace linear_details
+{
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+
+    bool all_finite(const double *values, size_t n)
+    {
+        for (size_t i = 0; i < n; i++) {
+            if (!std::isfinite(values[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+/*
+Row of the band elimination: coefficients of the columns first, first + 1, ... and the right-hand side
+*/
+    struct band_row
+    {
+        size_t first;
+        std::vector<double> values;
+        double rhs;
+    };
+
+/*
+Solves the tridiagonal system with Gaussian elimination with partial pivoting like try_solve_linear_system.
+Row i enters the elimination at column i - 1, so only the rows that can have nonzero coefficients
+in the current column are compared, and every row keeps the coefficients from the current column to its
+last nonzero one (at most 3 of them, unless columns are skipped).
+*/
+    solver_status solve_band(const double *lower, const double *diagonal, const double *upper, const double *rhs,
+                             size_t size, int &nsolutions, double *solution)
+    {
+        std::vector<band_row> active, pivots;
+        size_t next_row = 0, skipped_columns = 0;
+        bool consistent = true;
+
+        for (size_t column = 0; column < size; column++) {
+            for (; next_row < size && next_row <= column + 1; next_row++) {
+                band_row row = {next_row == 0 ? 0 : next_row - 1, {}, rhs[next_row]};
+                if (next_row > 0) {
+                    row.values.push_back(lower[next_row]);
+                }
+                row.values.push_back(diagonal[next_row]);
+                if (next_row + 1 < size) {
+                    row.values.push_back(upper[next_row]);
+                }
+                active.push_back(row);
+            }
+
+            // every active row begins from the current column
+            size_t pivot = active.size();
+            for (size_t i = 0; i < active.size(); i++) {
+                if (std::fabs(active[i].values[0]) >= EPS &&
+                    (pivot == active.size() || std::fabs(active[i].values[0]) > std::fabs(active[pivot].values[0]))) {
+                    pivot = i;
+                }
+            }
+            if (pivot == active.size()) {
+                skipped_columns++;
+            } else {
+                std::swap(active[pivot], active.back());
+                const band_row &pivot_row = active.back();
+                for (size_t i = 0; i + 1 < active.size(); i++) {
+                    band_row &row = active[i];
+                    double factor = row.values[0] / pivot_row.values[0];
+                    if (row.values.size() < pivot_row.values.size()) {
+                        row.values.resize(pivot_row.values.size(), 0);
+                    }
+                    for (size_t j = 1; j < pivot_row.values.size(); j++) {
+                        row.values[j] -= factor * pivot_row.values[j];
+                    }
+                    row.rhs -= factor * pivot_row.rhs;
+                }
+                pivots.push_back(std::move(active.back()));
+                active.pop_back();
+            }
+
+            // the current column is eliminated from the other rows
+            for (size_t i = 0; i < active.size(); i++) {
+                band_row &row = active[i];
+                row.values.erase(row.values.begin());
+                row.first++;
+                if (row.values.empty()) { // no coefficients are left
+                    consistent = consistent && std::fabs(row.rhs) < EPS;
+                    std::swap(row, active.back());
+                    active.pop_back();
+                    i--;
+                }
+            }
+        }
+
+        if (!consistent) {
+            nsolutions = 0;
+            return SOLVER_OK;
+        }
+        if (skipped_columns > 0) {
+            nsolutions = INF_ROOTS;
+            return SOLVER_OK;
+        }
+        for (size_t k = size; k-- > 0;) { // the k-th pivot row begins from the column k
+            const band_row &row = pivots[k];
+            double sum = row.rhs;
+            for (size_t j = 1; j < row.values.size(); j++) {
+                sum -= row.values[j] * solution[k + j];
+            }
+            solution[k] = sum / row.values[0];
+        }
+        if (!all_finite(solution, size)) {
+            std::fill(solution, solution + size, nan);
+            return SOLVER_OVERFLOW;
+        }
+        nsolutions = 1;
+        return SOLVER_OK;
+    }
+
+/*
+Solves the tridiagonal system with the Thomas algorithm, buffer is resized to size numbers.
+Returns false if a pivot is less than EPS, then solution is not calculated.
+*/
+    bool solve_thomas(const double *lower, const double *diagonal, const double *upper, const double *rhs,
+                      size_t size, double *solution, std::vector<double> &buffer)
+    {
+        buffer.resize(size);
+        double *upper_ratio = buffer.data(); // upper[i] / pivot of the row i after the elimination
+        double pivot = diagonal[0];
+        for (size_t i = 0;; i++) {
+            if (std::fabs(pivot) < EPS) {
+                return false;
+            }
+            double inverse = 1 / pivot; // one division on the critical path instead of two
+            solution[i] = (i == 0 ? rhs[0] : rhs[i] - lower[i] * solution[i - 1]) * inverse;
+            if (i + 1 == size) {
+                break;
+            }
+            upper_ratio[i] = upper[i] * inverse;
+            pivot = diagonal[i + 1] - lower[i + 1] * upper_ratio[i];
+        }
+        for (size_t i = size - 1; i-- > 0;) {
+            solution[i] -= upper_ratio[i] * solution[i + 1];
+        }
+        return true;
+    }
+
+/*
+Solves K tridiagonal systems of the same size with the Thomas algorithm at once: the systems are
+stored one after another (every array has K * size numbers), their steps are interleaved, so the
+divisions of different systems overlap instead of waiting for each other.
+Returns the bit mask of the systems with a pivot less than EPS or a not finite solution.
+*/
+    template<int K>
+    int solve_thomas_interleaved(const double *lower, const double *diagonal, const double *upper, const double *rhs,
+                                 size_t size, double *solution, std::vector<double> &buffer)
+    {
+        buffer.resize(K * size);
+        double *upper_ratio = buffer.data();
+        double pivot[K], previous[K] = {};
+        int failed = 0;
+        for (int k = 0; k < K; k++) {
+            pivot[k] = diagonal[k * size];
+        }
+        for (size_t i = 0; i < size; i++) {
+            for (int k = 0; k < K; k++) {
+                size_t j = k * size + i;
+                failed |= (std::fabs(pivot[k]) < EPS) << k;
+                double inverse = 1 / pivot[k];
+                previous[k] = (rhs[j] - (i == 0 ? 0 : lower[j] * previous[k])) * inverse;
+                solution[j] = previous[k];
+                if (i + 1 < size) {
+                    upper_ratio[j] = upper[j] * inverse;
+                    pivot[k] = diagonal[j + 1] - lower[j + 1] * upper_ratio[j];
+                }
+            }
+        }
+        for (size_t i = size - 1; i-- > 0;) {
+            for (int k = 0; k < K; k++) {
+                size_t j = k * size + i;
+                solution[j] -= upper_ratio[j] * solution[j + 1];
+            }
+        }
+        for (int k = 0; k < K; k++) {
+            failed |= !all_finite(solution + k * size, size) << k;
+        }
+        return failed;
+    }
+
+    solver_status try_solve_tridiagonal(const double *lower, const double *diagonal, const double *upper, const double *rhs,
+                                        size_t size, int &nsolutions, double *solution, std::vector<double> &buffer)
+    {
+        nsolutions = 0;
+        if (size == 0) {
+            nsolutions = 1; // the empty x
+            return SOLVER_OK;
+        }
+        if (!all_finite(diagonal, size) || !all_finite(rhs, size) ||
+            !all_finite(lower + 1, size - 1) || !all_finite(upper, size - 1)) {
+            std::fill(solution, solution + size, nan);
+            return SOLVER_NOT_FINITE_INPUT;
+        }
+        if (!solve_thomas(lower, diagonal, upper, rhs, size, solution, buffer)) {
+            std::fill(solution, solution + size, nan);
+            return solve_band(lower, diagonal, upper, rhs, size, nsolutions, solution);
+        }
+        if (!all_finite(solution, size)) {
+            std::fill(solution, solution + size, nan);
+            return SOLVER_OVERFLOW;
+        }
+        nsolutions = 1;
+        return SOLVER_OK;
+    }
+}
+
+
+/* See description in linear_system_solver.h */
+
+template<int N>
+solver_status try_solve_linear_system(const double *matrix, const double *rhs, int &nsolutions, double *solution) noexcept
+{
+    static_assert(N >= 1 && N <= MAX_LINEAR_SYSTEM_SIZE, "size of the system is out of range");
+
+    nsolutions = 0;
+    std::fill(solution, solution + N, linear_details::nan);
+    if (!linear_details::all_finite(matrix, N * N) || !linear_details::all_finite(rhs, N)) {
+        return SOLVER_NOT_FINITE_INPUT;
+    }
+
+    double m[N][N + 1]; // the last column is the right-hand side
+    double *rows[N];    // rows are swapped by swapping the pointers
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            m[i][j] = matrix[i * N + j];
+        }
+        m[i][N] = rhs[i];
+        rows[i] = m[i];
+    }
+
+    int rank = 0; // rows 0, ..., rank - 1 have pivots
+    for (int column = 0; column < N; column++) {
+        int pivot = rank;
+        for (int i = rank + 1; i < N; i++) {
+            if (std::fabs(rows[i][column]) > std::fabs(rows[pivot][column])) {
+                pivot = i;
+            }
+        }
+        if (std::fabs(rows[pivot][column]) < EPS) {
+            continue; // the column is skipped, the system is singular
+        }
+        std::swap(rows[pivot], rows[rank]);
+        for (int i = rank + 1; i < N; i++) {
+            double factor = rows[i][column] / rows[rank][column];
+            for (int j = column + 1; j <= N; j++) {
+                rows[i][j] -= factor * rows[rank][j];
+            }
+        }
+        rank++;
+    }
+
+    if (rank < N) {
+        for (int i = rank; i < N; i++) {
+            if (std::fabs(rows[i][N]) >= EPS) {
+                return SOLVER_OK; // 0 = b, no solutions
+            }
+        }
+        nsolutions = INF_ROOTS;
+        return SOLVER_OK;
+    }
+    for (int i = N - 1; i >= 0; i--) {
+        double sum = rows[i][N];
+        for (int j = i + 1; j < N; j++) {
+            sum -= rows[i][j] * solution[j];
+        }
+        solution[i] = sum / rows[i][i];
+    }
+    if (!linear_details::all_finite(solution, N)) {
+        std::fill(solution, solution + N, linear_details::nan);
+        return SOLVER_OVERFLOW;
+    }
+    nsolutions = 1;
+    return SOLVER_OK;
+}
+
+
+/* See description in linear_system_solver.h */
+
+template<int N>
+int solve_linear_system(const double *matrix, const double *rhs, double *solution)
+{
+    assert(matrix != nullptr && rhs != nullptr && solution != nullptr);
+    assert(linear_details::all_finite(matrix, N * N));
+    assert(linear_details::all_finite(rhs, N));
+
+    int nsolutions = 0;
+    if (try_solve_linear_system<N>(matrix, rhs, nsolutions, solution) != SOLVER_OK) {
+        throw std::runtime_error("Got not finite value, solving the linear system of " + std::to_string(N) +
+                                 " equations in file: " + __FILE__);
+    }
+    return nsolutions;
+}
+
+
+/* See description in linear_system_solver.h */
+
+template<int N>
+void try_solve_linear_systems(const double *matrices, const double *rhs, size_t n,
+                              int *nsolutions, double *solutions, solver_status *statuses) noexcept
+{
+    assert(n == 0 || (matrices != nullptr && rhs != nullptr));
+    assert(n == 0 || (nsolutions != nullptr && solutions != nullptr && statuses != nullptr));
+
+    for (size_t i = 0; i < n; i++) {
+        statuses[i] = try_solve_linear_system<N>(matrices + i * N * N, rhs + i * N, nsolutions[i], solutions + i * N);
+    }
+}
+
+
+/* See description in linear_system_solver.h */
+
+solver_status try_solve_tridiagonal_system(const double *lower, const double *diagonal, const double *upper, const double *rhs,
+                                           size_t size, int &nsolutions, double *solution)
+{
+    std::vector<double> buffer;
+    return linear_details::try_solve_tridiagonal(lower, diagonal, upper, rhs, size, nsolutions, solution, buffer);
+}
+
+
+/* See description in linear_system_solver.h */
+
+int solve_tridiagonal_system(const double *lower, const double *diagonal, const double *upper, const double *rhs,
+                             size_t size, double *solution)
+{
+    assert(size == 0 || (lower != nullptr && diagonal != nullptr && upper != nullptr && rhs != nullptr && solution != nullptr));
+    assert(size == 0 || linear_details::all_finite(diagonal, size));
+    assert(size == 0 || linear_details::all_finite(rhs, size));
+    assert(size == 0 || linear_details::all_finite(lower + 1, size - 1));
+    assert(size == 0 || linear_details::all_finite(upper, size - 1));
+
+    int nsolutions = 0;
+    if (try_solve_tridiagonal_system(lower, diagonal, upper, rhs, size, nsolutions, solution) != SOLVER_OK) {
+        throw std::runtime_error("Got not finite value, solving the tridiagonal system of " + std::to_string(size) +
+                                 " equations in file: " + __FILE__);
+    }
+    return nsolutions;
+}
+
+
+/* See description in linear_system_solver.h */
+
+void try_solve_tridiagonal_systems(const double *lower, const double *diagonal, const double *upper, const double *rhs,
+                                   size_t size, size_t n, int *nsolutions, double *solutions, solver_status *statuses)
+{
+    assert(n == 0 || size == 0 || (lower != nullptr && diagonal != nullptr && upper != nullptr && rhs != nullptr));
+    assert(n == 0 || (nsolutions != nullptr && statuses != nullptr));
+
+    const int interleaved = 4;
+    std::vector<double> buffer;
+    size_t i = 0;
+    if (size > 0) {
+        for (; i + interleaved <= n; i += interleaved) {
+            size_t offset = i * size;
+            bool finite = linear_details::all_finite(diagonal + offset, interleaved * size) &&
+                          linear_details::all_finite(lower + offset, interleaved * size) &&
+                          linear_details::all_finite(upper + offset, interleaved * size) &&
+                          linear_details::all_finite(rhs + offset, interleaved * size);
+            int failed = (finite ? linear_details::solve_thomas_interleaved<interleaved>(lower + offset, diagonal + offset,
+                                                                                          upper + offset, rhs + offset, size,
+                                                                                          solutions + offset, buffer)
+                                 : (1 << interleaved) - 1);
+            for (int k = 0; k < interleaved; k++, offset += size) {
+                if (failed & (1 << k)) { // pivoting, or the error status
+                    statuses[i + k] = linear_details::try_solve_tridiagonal(lower + offset, diagonal + offset, upper + offset,
+                                                                            rhs + offset, size, nsolutions[i + k],
+                                                                            solutions + offset, buffer);
+                } else {
+                    statuses[i + k] = SOLVER_OK;
+                    nsolutions[i + k] = 1;
+                }
+            }
+        }
+    }
+    for (; i < n; i++) {
+        size_t offset = i * size;
+        statuses[i] = linear_details::try_solve_tridiagonal(lower + offset, diagonal + offset, upper + offset, rhs + offset,
+                                                            size, nsolutions[i], solutions + offset, buffer);
+    }
+}
+
+
+#define INSTANTIATE_LINEAR_SYSTEM_SOLVER(N)                                                                          \
+    template int solve_linear_system<N>(const double *, const double *, double *);                                  \
+    template solver_status try_solve_linear_system<N>(const double *, const double *, int &, double *) noexcept;    \
+    template void try_solve_linear_systems<N>(const double *, const double *, size_t, int *, double *,              \
+                                              solver_status *) noexcept;
+
+INSTANTIATE_LINEAR_SYSTEM_SOLVER(1)
+INSTANTIATE_LINEAR_SYSTEM_SOLVER(2)
+INSTANTIATE_LINEAR_SYSTEM_SOLVER(3)
+INSTANTIATE_LINEAR_SYSTEM_SOLVER(4)
+INSTANTIATE_LINEAR_SYSTEM_SOLVER(5)
+INSTANTIATE_LINEAR_SYSTEM_SOLVER(6)
+INSTANTIATE_LINEAR_SYSTEM_SOLVER(7)
+INSTANTIATE_LINEAR_SYSTEM_SOLVER(8)
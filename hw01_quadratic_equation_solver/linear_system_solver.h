@@ -0,0 +1,140 @@
+#ifndef __LINEAR_SYSTEM_SOLVER_HEADER
+#define __LINEAR_SYSTEM_SOLVER_HEADER
+
+#include <cstddef>
+
+#include "quadratic_equation_solver.h"
+
+//! Maximum size of the systems solved by @c solve_linear_system
+constexpr int MAX_LINEAR_SYSTEM_SIZE = 8;
+
+///-------------------------------------------------------------------------------------
+//! Solves the system of @c N linear equations \f$ A x = b \f$
+//!
+//! @param [in]  matrix    Array of N * N coefficients of A, row by row
+//! @param [in]  rhs       Array of N right-hand sides b
+//! @param [out] solution  Array of N numbers where to write x
+//!
+//! @return Number of solutions: 1, 0 or @c INF_ROOTS
+//!
+//! @note @c N is from 1 to @c MAX_LINEAR_SYSTEM_SIZE. The size is a template parameter, so the
+//!       loops have constant bounds and are unrolled, and the matrix is copied to the stack.
+//!       The system is solved with Gaussian elimination with partial pivoting. A column which pivot
+//!       is less than @c EPS (see @c is_zero) is skipped, then the system is singular: if the rows left
+//!       without pivots have zero (less than @c EPS) right-hand sides, the number of solutions is infinite,
+//!       otherwise there are no solutions (as in @c solve_linear_equation). If the number of solutions
+//!       is not 1, @c solution is filled with @c NAN.
+//!       Throws std::runtime_error if the solution is not finite.
+//!
+///-------------------------------------------------------------------------------------
+
+template<int N>
+int solve_linear_system(const double *matrix, const double *rhs, double *solution);
+
+
+///-------------------------------------------------------------------------------------
+//! Solves the system like @c solve_linear_system, but without asserting or throwing exceptions
+//!
+//! @param [in]  matrix      Array of N * N coefficients of A, row by row
+//! @param [in]  rhs         Array of N right-hand sides b
+//! @param [out] nsolutions  Reference to the number of solutions
+//! @param [out] solution    Array of N numbers where to write x
+//!
+//! @return Status, see @c try_solve_quadratic_equation
+//!
+//! @note If the status is not @c SOLVER_OK, @c nsolutions is 0, @c solution is filled with @c NAN.
+//!
+///-------------------------------------------------------------------------------------
+
+template<int N>
+solver_status try_solve_linear_system(const double *matrix, const double *rhs, int &nsolutions, double *solution) noexcept;
+
+
+///-------------------------------------------------------------------------------------
+//! Solves @c n systems of the same size @c N
+//!
+//! @param [in]  matrices    Array of n * N * N coefficients, the matrix of the i-th system begins from matrices[i * N * N]
+//! @param [in]  rhs         Array of n * N right-hand sides, the ones of the i-th system begin from rhs[i * N]
+//! @param [in]  n           Number of systems
+//! @param [out] nsolutions  Array where to write the number of solutions of each system
+//! @param [out] solutions   Array of n * N numbers, the solution of the i-th system is written to solutions[i * N], ...
+//! @param [out] statuses    Array where to write the status of each system
+//!
+//! @note For every i writes exactly what @c try_solve_linear_system<N> would write and puts its return value to @c statuses[i].
+//!
+///-------------------------------------------------------------------------------------
+
+template<int N>
+void try_solve_linear_systems(const double *matrices, const double *rhs, size_t n,
+                              int *nsolutions, double *solutions, solver_status *statuses) noexcept;
+
+
+///-------------------------------------------------------------------------------------
+//! Solves the tridiagonal system of @c size linear equations
+//! \f$ l_i x_{i - 1} + d_i x_i + u_i x_{i + 1} = r_i \f$
+//!
+//! @param [in]  lower     Array of @c size coefficients l (lower[0] is not used)
+//! @param [in]  diagonal  Array of @c size coefficients d
+//! @param [in]  upper     Array of @c size coefficients u (upper[size - 1] is not used)
+//! @param [in]  rhs       Array of @c size right-hand sides r
+//! @param [in]  size      Number of equations
+//! @param [out] solution  Array of @c size numbers where to write x
+//!
+//! @return Number of solutions: 1, 0 or @c INF_ROOTS
+//!
+//! @note The system is solved with the Thomas algorithm in O(size) time. If its pivot is less than @c EPS
+//!       (the matrix is singular or not diagonally dominant), the system is solved again with Gaussian
+//!       elimination with partial pivoting, which keeps only the nonzero band of every row, and
+//!       singular systems are classified like in @c solve_linear_system.
+//!       Throws std::runtime_error if the solution is not finite.
+//!
+///-------------------------------------------------------------------------------------
+
+int solve_tridiagonal_system(const double *lower, const double *diagonal, const double *upper, const double *rhs,
+                             size_t size, double *solution);
+
+
+///-------------------------------------------------------------------------------------
+//! Solves the tridiagonal system like @c solve_tridiagonal_system, but without asserting or throwing exceptions
+//!
+//! @param [in]  lower       Array of @c size coefficients l (lower[0] is not used)
+//! @param [in]  diagonal    Array of @c size coefficients d
+//! @param [in]  upper       Array of @c size coefficients u (upper[size - 1] is not used)
+//! @param [in]  rhs         Array of @c size right-hand sides r
+//! @param [in]  size        Number of equations
+//! @param [out] nsolutions  Reference to the number of solutions
+//! @param [out] solution    Array of @c size numbers where to write x
+//!
+//! @return Status, see @c try_solve_quadratic_equation
+//!
+//! @note If the status is not @c SOLVER_OK, @c nsolutions is 0, @c solution is filled with @c NAN.
+//!       The buffers are allocated on the heap, so std::bad_alloc is the only exception that can be thrown.
+//!
+///-------------------------------------------------------------------------------------
+
+solver_status try_solve_tridiagonal_system(const double *lower, const double *diagonal, const double *upper, const double *rhs,
+                                           size_t size, int &nsolutions, double *solution);
+
+
+///-------------------------------------------------------------------------------------
+//! Solves @c n tridiagonal systems of the same size
+//!
+//! @param [in]  lower       Array of n * size coefficients l, the ones of the i-th system begin from lower[i * size]
+//! @param [in]  diagonal    Array of n * size coefficients d, stored the same way
+//! @param [in]  upper       Array of n * size coefficients u, stored the same way
+//! @param [in]  rhs         Array of n * size right-hand sides, stored the same way
+//! @param [in]  size        Number of equations in every system
+//! @param [in]  n           Number of systems
+//! @param [out] nsolutions  Array where to write the number of solutions of each system
+//! @param [out] solutions   Array of n * size numbers, the solution of the i-th system is written to solutions[i * size], ...
+//! @param [out] statuses    Array where to write the status of each system
+//!
+//! @note For every i writes exactly what @c try_solve_tridiagonal_system would write and puts its return value
+//!       to @c statuses[i]. The buffer of the Thomas algorithm is allocated once for all systems.
+//!
+///-------------------------------------------------------------------------------------
+
+void try_solve_tridiagonal_systems(const double *lower, const double *diagonal, const double *upper, const double *rhs,
+                                   size_t size, size_t n, int *nsolutions, double *solutions, solver_status *statuses);
+
+#endif
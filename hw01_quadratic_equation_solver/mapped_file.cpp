@@ -0,0 +1,161 @@
+#include "mapped_file.h"
+
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+static std::string last_error_message(const char *what, const char *path)
+{
+    return std::string("mapped_file: cannot ") + what + " " + path + ": error code " + std::to_string(GetLastError());
+}
+
+/* See description in mapped_file.h */
+
+mapped_file::mapped_file(const char *path)
+{
+    file_handle_ = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file_handle_ == INVALID_HANDLE_VALUE) {
+        file_handle_ = nullptr;
+        throw std::runtime_error(last_error_message("open", path));
+    }
+    LARGE_INTEGER file_size = {};
+    if (GetFileSizeEx(file_handle_, &file_size) == 0) {
+        CloseHandle(file_handle_);
+        throw std::runtime_error(last_error_message("get size of", path));
+    }
+    size_ = file_size.QuadPart;
+    if (size_ == 0) {
+        return;
+    }
+    mapping_handle_ = CreateFileMappingA(file_handle_, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping_handle_ == NULL) {
+        CloseHandle(file_handle_);
+        throw std::runtime_error(last_error_message("map", path));
+    }
+    data_ = (char *)MapViewOfFile(mapping_handle_, FILE_MAP_READ, 0, 0, 0);
+    if (data_ == NULL) {
+        CloseHandle(mapping_handle_);
+        CloseHandle(file_handle_);
+        throw std::runtime_error(last_error_message("map", path));
+    }
+}
+
+/* See description in mapped_file.h */
+
+mapped_file::mapped_file(const char *path, uint64_t size)
+{
+    file_handle_ = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file_handle_ == INVALID_HANDLE_VALUE) {
+        file_handle_ = nullptr;
+        throw std::runtime_error(last_error_message("open", path));
+    }
+    size_ = size;
+    if (size_ == 0) {
+        return;
+    }
+    mapping_handle_ = CreateFileMappingA(file_handle_, NULL, PAGE_READWRITE, (DWORD)(size >> 32), (DWORD)size, NULL);
+    if (mapping_handle_ == NULL) {
+        CloseHandle(file_handle_);
+        throw std::runtime_error(last_error_message("map", path));
+    }
+    data_ = (char *)MapViewOfFile(mapping_handle_, FILE_MAP_WRITE, 0, 0, 0);
+    if (data_ == NULL) {
+        CloseHandle(mapping_handle_);
+        CloseHandle(file_handle_);
+        throw std::runtime_error(last_error_message("map", path));
+    }
+}
+
+mapped_file::~mapped_file()
+{
+    if (data_ != nullptr) {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_handle_ != nullptr) {
+        CloseHandle(mapping_handle_);
+    }
+    if (file_handle_ != nullptr) {
+        CloseHandle(file_handle_);
+    }
+}
+
+#else
+
+static std::string last_error_message(const char *what, const char *path)
+{
+    return std::string("mapped_file: cannot ") + what + " " + path + ": " + strerror(errno);
+}
+
+/* See description in mapped_file.h */
+
+mapped_file::mapped_file(const char *path)
+{
+    fd_ = open(path, O_RDONLY);
+    if (fd_ < 0) {
+        throw std::runtime_error(last_error_message("open", path));
+    }
+    struct stat file_stat = {};
+    if (fstat(fd_, &file_stat) != 0) {
+        close(fd_);
+        throw std::runtime_error(last_error_message("get size of", path));
+    }
+    size_ = file_stat.st_size;
+    if (size_ == 0) {
+        return;
+    }
+    void *data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (data == MAP_FAILED) {
+        close(fd_);
+        throw std::runtime_error(last_error_message("map", path));
+    }
+    data_ = (char *)data;
+    madvise(data_, size_, MADV_SEQUENTIAL); // only a hint, errors are not important
+}
+
+/* See description in mapped_file.h */
+
+mapped_file::mapped_file(const char *path, uint64_t size)
+{
+    fd_ = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) {
+        throw std::runtime_error(last_error_message("open", path));
+    }
+    size_ = size;
+    if (size_ == 0) {
+        return;
+    }
+    if (ftruncate(fd_, size_) != 0) {
+        close(fd_);
+        throw std::runtime_error(last_error_message("set size of", path));
+    }
+    void *data = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (data == MAP_FAILED) {
+        close(fd_);
+        throw std::runtime_error(last_error_message("map", path));
+    }
+    data_ = (char *)data;
+}
+
+mapped_file::~mapped_file()
+{
+    if (data_ != nullptr) {
+        munmap(data_, size_);
+    }
+    if (fd_ >= 0) {
+        close(fd_);
+    }
+}
+
+#endif
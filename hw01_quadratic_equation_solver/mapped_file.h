@@ -0,0 +1,57 @@
+#ifndef __MAPPED_FILE_HEADER
+#define __MAPPED_FILE_HEADER
+
+#include <cstdint>
+
+///-------------------------------------------------------------------------------------
+//! File mapped to memory (with mmap on POSIX systems and MapViewOfFile on Windows).
+//! The mapping is released in the destructor.
+//!
+//! @note Errors are reported with std::runtime_error
+//!
+///-------------------------------------------------------------------------------------
+class mapped_file
+{
+public:
+///-------------------------------------------------------------------------------------
+//! Maps the whole existing file for reading
+//!
+//! @param [in] path  Path to the file
+//!
+///-------------------------------------------------------------------------------------
+    explicit mapped_file(const char *path);
+
+///-------------------------------------------------------------------------------------
+//! Creates (or truncates) the file, sets its size and maps it for reading and writing
+//!
+//! @param [in] path  Path to the file
+//! @param [in] size  Size of the file in bytes
+//!
+//! @attention If the file exists, it will be overwritten
+//!
+///-------------------------------------------------------------------------------------
+    mapped_file(const char *path, uint64_t size);
+
+    ~mapped_file();
+
+    mapped_file(const mapped_file &) = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+
+    //! Pointer to the first byte of the file (nullptr if the file is empty)
+    char *data() const { return data_; }
+
+    //! Size of the file in bytes
+    uint64_t size() const { return size_; }
+
+private:
+    char *data_ = nullptr;
+    uint64_t size_ = 0;
+#ifdef _WIN32
+    void *file_handle_ = nullptr;
+    void *mapping_handle_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
+
+#endif
@@ -0,0 +1,104 @@
+#include "perf_counters.h"
+
+#ifdef __linux__
+#include <cstring>
+#include <initializer_list>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/*
+Opens the hardware counter of the calling thread (in the group of group_fd, if it is not -1).
+Returns -1 on failure.
+*/
+static int open_counter(uint64_t config, int group_fd)
+{
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = (group_fd == -1);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+
+perf_counters::perf_counters()
+{
+    group_fd_ = open_counter(PERF_COUNT_HW_INSTRUCTIONS, -1);
+    if (group_fd_ == -1) {
+        return;
+    }
+    cycles_fd_ = open_counter(PERF_COUNT_HW_CPU_CYCLES, group_fd_);
+    branch_misses_fd_ = open_counter(PERF_COUNT_HW_BRANCH_MISSES, group_fd_);
+    if (cycles_fd_ == -1 || branch_misses_fd_ == -1) {
+        close_all();
+    }
+}
+
+perf_counters::~perf_counters()
+{
+    close_all();
+}
+
+void perf_counters::close_all()
+{
+    for (int *fd : {&branch_misses_fd_, &cycles_fd_, &group_fd_}) {
+        if (*fd != -1) {
+            close(*fd);
+            *fd = -1;
+        }
+    }
+}
+
+void perf_counters::start()
+{
+    if (available()) {
+        ioctl(group_fd_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(group_fd_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+}
+
+perf_counters::values perf_counters::stop()
+{
+    values result = {0, 0, 0};
+    if (!available()) {
+        return result;
+    }
+    ioctl(group_fd_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    uint64_t buffer[4] = {}; // number of counters, then their values in the order of opening
+    if (read(group_fd_, buffer, sizeof(buffer)) == (ssize_t)sizeof(buffer) && buffer[0] == 3) {
+        result.instructions = buffer[1];
+        result.cycles = buffer[2];
+        result.branch_misses = buffer[3];
+    }
+    return result;
+}
+
+#else
+
+perf_counters::perf_counters()
+{
+}
+
+perf_counters::~perf_counters()
+{
+}
+
+void perf_counters::close_all()
+{
+}
+
+void perf_counters::start()
+{
+}
+
+perf_counters::values perf_counters::stop()
+{
+    return {0, 0, 0};
+}
+
+#endif
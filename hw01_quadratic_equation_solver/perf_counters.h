@@ -0,0 +1,49 @@
+#ifndef __PERF_COUNTERS_HEADER
+#define __PERF_COUNTERS_HEADER
+
+#include <cstdint>
+
+///-------------------------------------------------------------------------------------
+//! Hardware counters of the calling thread (instructions, cycles and branch misses),
+//! read with perf_event_open on Linux.
+//!
+//! @note On other systems, or if the kernel does not allow to open the counters
+//!       (for example, because of perf_event_paranoid or in a container), @c available()
+//!       is false and all the counters are 0.
+//!
+///-------------------------------------------------------------------------------------
+class perf_counters
+{
+public:
+    //! Values of the counters between @c start and @c stop
+    struct values
+    {
+        uint64_t instructions;
+        uint64_t cycles;
+        uint64_t branch_misses;
+    };
+
+    perf_counters();
+    ~perf_counters();
+
+    perf_counters(const perf_counters &) = delete;
+    perf_counters &operator=(const perf_counters &) = delete;
+
+    //! True if the counters are opened
+    bool available() const { return group_fd_ != -1; }
+
+    //! Resets and enables the counters
+    void start();
+
+    //! Disables the counters and returns their values
+    values stop();
+
+private:
+    void close_all();
+
+    int group_fd_ = -1;            // instructions, the leader of the group
+    int cycles_fd_ = -1;
+    int branch_misses_fd_ = -1;
+};
+
+#endif
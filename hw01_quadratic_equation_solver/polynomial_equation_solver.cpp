@@ -0,0 +1,380 @@
+#include "polynomial_equation_solver.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <string>
+
+namespace polynomial_details
+{
+    const double pi = 3.14159265358979323846;
+    const int newton_iterations = 4;     // refining iterations for every root
+    const int aberth_iterations = 500;   // maximum iterations of Aberth's method
+    const double discriminant_rounding = 64 * DBL_EPSILON; // relative error of the discriminant of the cubic
+
+/*
+Calculates the value of the polynomial and its derivative at x with Horner's method
+*/
+    double evaluate(const double *coefficients, int degree, double x, double &derivative)
+    {
+        double value = coefficients[0];
+        derivative = 0;
+        for (int i = 1; i <= degree; i++) {
+            derivative = derivative * x + value;
+            value = value * x + coefficients[i];
+        }
+        return value;
+    }
+
+/*
+Refines the root with Newton's method while the value of the polynomial decreases
+*/
+    void refine_root(const double *coefficients, int degree, double &root)
+    {
+        double derivative = 0;
+        double value = evaluate(coefficients, degree, root, derivative);
+        for (int i = 0; i < newton_iterations && !(std::fabs(derivative) < DBL_MIN); i++) {
+            double next_root = root - value / derivative, next_derivative = 0;
+            double next_value = evaluate(coefficients, degree, next_root, next_derivative);
+            if (!(std::fabs(next_value) < std::fabs(value))) {
+                break;
+            }
+            root = next_root;
+            value = next_value;
+            derivative = next_derivative;
+        }
+    }
+
+    bool close_roots(double x, double y)
+    {
+        return std::fabs(x - y) < EPS * std::fmax(1, std::fmax(std::fabs(x), std::fabs(y)));
+    }
+
+/*
+Refines nfound roots of the polynomial, sorts them and writes the different ones to roots,
+fills the rest of max_roots elements with NAN. Returns the number of written roots.
+*/
+    int write_roots(const double *coefficients, int degree, double *found, int nfound, double *roots, int max_roots)
+    {
+        assert(nfound <= max_roots);
+
+        for (int i = 0; i < nfound; i++) {
+            refine_root(coefficients, degree, found[i]);
+            if (!std::isfinite(found[i])) {
+                throw std::runtime_error("Got not finite value, calculating the roots of the polynomial equation of degree " +
+                                         std::to_string(degree) + " in file: " + __FILE__);
+            }
+        }
+        std::sort(found, found + nfound);
+
+        int nroots = 0;
+        for (int i = 0; i < nfound; i++) {
+            if (nroots == 0 || !close_roots(roots[nroots - 1], found[i])) {
+                roots[nroots++] = found[i];
+            }
+        }
+        for (int i = nroots; i < max_roots; i++) {
+            roots[i] = NAN;
+        }
+        return nroots;
+    }
+
+/*
+Finds real roots of the polynomial (degree >= 1, the first coefficient is not zero) with Aberth's method.
+Returns the number of found roots, multiple roots may be found several times.
+*/
+    int aberth_roots(const double *coefficients, int degree, double *found)
+    {
+        typedef std::complex<double> complex;
+        assert(degree >= 1 && degree <= MAX_POLYNOMIAL_DEGREE);
+
+        /* Initial approximations are on the circle, which radius is the geometric mean of the absolute values of the roots */
+        complex z[MAX_POLYNOMIAL_DEGREE];
+        double radius = std::pow(std::fabs(coefficients[degree] / coefficients[0]), 1.0 / degree);
+        if (!(radius > DBL_MIN) || !std::isfinite(radius)) {
+            radius = 1;
+        }
+        for (int k = 0; k < degree; k++) {
+            z[k] = std::polar(radius, 2 * pi * k / degree + 0.4);
+        }
+
+        /* A root is not changed any more when the value of the polynomial at it is less than
+           the rounding error of Horner's method, so the value is just rounding noise */
+        bool converged[MAX_POLYNOMIAL_DEGREE] = {};
+        int nconverged = 0;
+        for (int iteration = 0; iteration < aberth_iterations && nconverged < degree; iteration++) {
+            for (int k = 0; k < degree; k++) {
+                if (converged[k]) {
+                    continue;
+                }
+                complex value = coefficients[0], derivative = 0;
+                double error_bound = std::fabs(coefficients[0]), z_abs = std::abs(z[k]);
+                for (int i = 1; i <= degree; i++) {
+                    derivative = derivative * z[k] + value;
+                    value = value * z[k] + coefficients[i];
+                    error_bound = error_bound * z_abs + std::fabs(coefficients[i]);
+                }
+                if (std::abs(value) <= 4 * DBL_EPSILON * error_bound) {
+                    converged[k] = true;
+                    nconverged++;
+                    continue;
+                }
+                complex ratio = value / derivative, repulsion = 0;
+                for (int j = 0; j < degree; j++) {
+                    if (j != k) {
+                        repulsion += 1.0 / (z[k] - z[j]);
+                    }
+                }
+                complex step = ratio / (1.0 - ratio * repulsion);
+                if (std::isfinite(step.real()) && std::isfinite(step.imag())) {
+                    z[k] -= step;
+                }
+            }
+        }
+
+        int nfound = 0;
+        for (int k = 0; k < degree; k++) {
+            if (std::fabs(z[k].imag()) < EPS * std::fmax(1, std::abs(z[k]))) {
+                found[nfound++] = z[k].real();
+            }
+        }
+        return nfound;
+    }
+
+/*
+Finds the roots of x^3 + b x^2 + c x + d = 0. Returns the number of found roots.
+*/
+    int normalized_cubic_roots(double b, double c, double d, double *found)
+    {
+        /* x = t - shift, t^3 + p t + q = 0 */
+        double shift = b / 3;
+        double p = c - b * shift;
+        double q = shift * (2 * shift * shift - c) + d;
+        double half_q = q / 2, third_p = p / 3;
+        double discriminant = half_q * half_q + third_p * third_p * third_p;
+
+        /* The discriminant is a sixth power of the distances between the roots, so it is compared to zero
+           relatively to its terms (comparing it to EPS would merge roots as far as 0.1 from each other) */
+        double rounding = discriminant_rounding * std::fmax(half_q * half_q, std::fabs(third_p * third_p * third_p));
+        if (std::fabs(discriminant) <= rounding) {
+            if (std::fabs(p) < EPS) { // triple root
+                found[0] = -shift;
+                return 1;
+            }
+            found[0] = 3 * q / p - shift;     // single root
+            found[1] = -3 * q / (2 * p) - shift; // double root
+            return 2;
+        } else if (discriminant > 0) {
+            /* Cardano's formula, u^3 = -q / 2 -+ sqrt(discriminant) is taken without cancellation */
+            double u = std::cbrt(-half_q - std::copysign(std::sqrt(discriminant), half_q));
+            found[0] = u - third_p / u - shift;
+            return 1;
+        } else { // discriminant < 0, so p < 0
+            /* t = 2 r cos(angle), then 2 r^3 cos(3 angle) = -q */
+            double r = std::sqrt(-third_p);
+            double angle = std::acos(std::fmax(-1, std::fmin(1, -half_q / (r * r * r)))) / 3;
+            for (int k = 0; k < 3; k++) {
+                found[k] = 2 * r * std::cos(angle - 2 * pi * k / 3) - shift;
+            }
+            return 3;
+        }
+    }
+
+/*
+Finds the roots of x^4 + b x^3 + c x^2 + d x + e = 0. Returns the number of found roots.
+*/
+    int normalized_quartic_roots(double b, double c, double d, double e, double *found)
+    {
+        /* x = y - shift, y^4 + p y^2 + q y + r = 0 */
+        double shift = b / 4, shift_square = shift * shift;
+        double p = c - 6 * shift_square;
+        double q = d - 2 * c * shift + 8 * shift_square * shift;
+        double r = e - d * shift + c * shift_square - 3 * shift_square * shift_square;
+        int nfound = 0;
+
+        /* Ferrari's method: m is the positive root of the resolvent cubic m^3 + p m^2 + (p^2 / 4 - r) m - q^2 / 8 = 0, then
+           y^4 + p y^2 + q y + r = (y^2 + p / 2 + m)^2 - (s y - q / (2 s))^2, where s = sqrt(2 m) */
+        double resolvent_roots[3] = {NAN, NAN, NAN};
+        int nresolvent = normalized_cubic_roots(p, p * p / 4 - r, -q * q / 8, resolvent_roots);
+        const double resolvent[] = {1, p, p * p / 4 - r, -q * q / 8};
+        double m = resolvent_roots[0];
+        for (int i = 0; i < nresolvent; i++) {
+            refine_root(resolvent, 3, resolvent_roots[i]);
+            m = std::fmax(m, resolvent_roots[i]);
+        }
+        if (!std::isfinite(m)) {
+            const double normalized[] = {1, b, c, d, e};
+            return aberth_roots(normalized, 4, found);
+        }
+
+        if (!(m > discriminant_rounding * (std::fabs(p) + std::sqrt(std::fabs(r))))) {
+            /* m is zero only if q is zero, so it is the biquadratic equation: z = y^2, z^2 + p z + r = 0 */
+            double z[2] = {NAN, NAN};
+            int nz = solve_quadratic_equation(1, p, r, z[0], z[1]);
+            for (int i = 0; i < nz; i++) {
+                if (std::fabs(z[i]) < EPS) {
+                    found[nfound++] = -shift;
+                } else if (z[i] > 0) {
+                    found[nfound++] = std::sqrt(z[i]) - shift;
+                    found[nfound++] = -std::sqrt(z[i]) - shift;
+                }
+            }
+            return nfound;
+        }
+
+        double s = std::sqrt(2 * m);
+        double y[4] = {NAN, NAN, NAN, NAN};
+        int ny = solve_quadratic_equation(1, -s, p / 2 + m + q / (2 * s), y[0], y[1]);
+        ny = (ny > 0 ? ny : 0);
+        int ny2 = solve_quadratic_equation(1, s, p / 2 + m - q / (2 * s), y[ny], y[ny + 1]);
+        ny += (ny2 > 0 ? ny2 : 0);
+        for (int i = 0; i < ny; i++) {
+            found[nfound++] = y[i] - shift;
+        }
+        return nfound;
+    }
+
+/*
+Writes the roots of the (at most quadratic) equation in ascending order, see solve_cubic_equation
+*/
+    int write_quadratic_roots(double a, double b, double c, double *roots, int max_roots)
+    {
+        double found[2] = {NAN, NAN};
+        int nfound = solve_quadratic_equation(a, b, c, found[0], found[1]);
+        if (nfound == INF_ROOTS) {
+            for (int i = 0; i < max_roots; i++) {
+                roots[i] = NAN;
+            }
+            return INF_ROOTS;
+        }
+        const double coefficients[] = {a, b, c};
+        return write_roots(coefficients, 2, found, nfound, roots, max_roots);
+    }
+}
+
+
+/* See description in polynomial_equation_solver.h */
+
+int solve_cubic_equation(double a, double b, double c, double d, double roots[3])
+{
+    assert(std::isfinite(a));
+    assert(std::isfinite(b));
+    assert(std::isfinite(c));
+    assert(std::isfinite(d));
+    assert(roots != nullptr);
+    using namespace polynomial_details;
+
+    if (is_zero(a)) {
+        return write_quadratic_roots(b, c, d, roots, 3);
+    }
+    double found[3] = {NAN, NAN, NAN};
+    int nfound = normalized_cubic_roots(b / a, c / a, d / a, found);
+    const double coefficients[] = {a, b, c, d};
+    return write_roots(coefficients, 3, found, nfound, roots, 3);
+}
+
+
+/* See description in polynomial_equation_solver.h */
+
+int solve_quartic_equation(double a, double b, double c, double d, double e, double roots[4])
+{
+    assert(std::isfinite(a));
+    assert(std::isfinite(b));
+    assert(std::isfinite(c));
+    assert(std::isfinite(d));
+    assert(std::isfinite(e));
+    assert(roots != nullptr);
+    using namespace polynomial_details;
+
+    if (is_zero(a)) {
+        roots[3] = NAN;
+        return solve_cubic_equation(b, c, d, e, roots);
+    }
+    double found[4] = {NAN, NAN, NAN, NAN};
+    int nfound = normalized_quartic_roots(b / a, c / a, d / a, e / a, found);
+    const double coefficients[] = {a, b, c, d, e};
+    return write_roots(coefficients, 4, found, nfound, roots, 4);
+}
+
+
+/* See description in polynomial_equation_solver.h */
+
+int solve_polynomial_equation(const double *coefficients, int degree, double *roots)
+{
+    assert(coefficients != nullptr);
+    assert(degree >= 0 && degree <= MAX_POLYNOMIAL_DEGREE);
+    assert(degree == 0 || roots != nullptr);
+    for (int i = 0; i <= degree; i++) {
+        assert(std::isfinite(coefficients[i]));
+    }
+    using namespace polynomial_details;
+
+    int first = 0;
+    while (first < degree && is_zero(coefficients[first])) {
+        first++;
+    }
+    const double *c = coefficients + first;
+    double *tail = roots + (degree - first);
+    for (double *cur = tail; cur < roots + degree; cur++) {
+        *cur = NAN;
+    }
+
+    switch (degree - first) {
+        case 0:
+            return (is_zero(c[0]) ? INF_ROOTS : 0);
+        case 1:
+        case 2:
+            return write_quadratic_roots((degree - first == 2 ? c[0] : 0), c[degree - first - 1], c[degree - first], roots, degree - first);
+        case 3:
+            return solve_cubic_equation(c[0], c[1], c[2], c[3], roots);
+        case 4:
+            return solve_quartic_equation(c[0], c[1], c[2], c[3], c[4], roots);
+        default: {
+            double found[MAX_POLYNOMIAL_DEGREE] = {};
+            int nfound = aberth_roots(c, degree - first, found);
+            return write_roots(c, degree - first, found, nfound, roots, degree - first);
+        }
+    }
+}
+
+
+/* See description in polynomial_equation_solver.h */
+
+void solve_cubic_equations(const double *a, const double *b, const double *c, const double *d, size_t n,
+                           int *nroots, double *roots)
+{
+    assert(n == 0 || (a != nullptr && b != nullptr && c != nullptr && d != nullptr));
+    assert(n == 0 || (nroots != nullptr && roots != nullptr));
+
+    for (size_t i = 0; i < n; i++) {
+        nroots[i] = solve_cubic_equation(a[i], b[i], c[i], d[i], roots + 3 * i);
+    }
+}
+
+
+/* See description in polynomial_equation_solver.h */
+
+void solve_quartic_equations(const double *a, const double *b, const double *c, const double *d, const double *e, size_t n,
+                             int *nroots, double *roots)
+{
+    assert(n == 0 || (a != nullptr && b != nullptr && c != nullptr && d != nullptr && e != nullptr));
+    assert(n == 0 || (nroots != nullptr && roots != nullptr));
+
+    for (size_t i = 0; i < n; i++) {
+        nroots[i] = solve_quartic_equation(a[i], b[i], c[i], d[i], e[i], roots + 4 * i);
+    }
+}
+
+
+/* See description in polynomial_equation_solver.h */
+
+void solve_each_polynomial_equation(const double *coefficients, int degree, size_t n, int *nroots, double *roots)
+{
+    assert(n == 0 || (coefficients != nullptr && nroots != nullptr));
+
+    for (size_t i = 0; i < n; i++) {
+        nroots[i] = solve_polynomial_equation(coefficients + i * (degree + 1), degree, roots + i * degree);
+    }
+}
@@ -0,0 +1,130 @@
+#ifndef __POLYNOMIAL_EQUATION_SOLVER_HEADER
+#define __POLYNOMIAL_EQUATION_SOLVER_HEADER
+
+#include <cstddef>
+
+#include "quadratic_equation_solver.h"
+
+//! Maximum degree of the equations solved by @c solve_polynomial_equation
+constexpr int MAX_POLYNOMIAL_DEGREE = 64;
+
+///-------------------------------------------------------------------------------------
+//! Solves the cubic equation \f$ a x^3 + b x^2 + c x + d = 0 \f$
+//!
+//! @param [in]  a      The cubic coefficient     (coefficient a)
+//! @param [in]  b      The quadratic coefficient (coefficient b)
+//! @param [in]  c      The linear coefficient    (coefficient c)
+//! @param [in]  d      The constant              (coefficient d)
+//! @param [out] roots  Array of 3 numbers where to write the roots
+//!
+//! @return Number of different real roots
+//!
+//! @note If the number of roots is infinite, returns @c INF_ROOTS. If @c a is zero (see @c is_zero),
+//!       solves the quadratic equation \f$ b x^2 + c x + d = 0 \f$.
+//!       The roots are written in ascending order, roots closer than @c EPS (relative to their
+//!       absolute values, if they are greater than 1) are written once. Unused elements of @c roots are @c NAN.
+//!       The depressed cubic is solved with Cardano's formula if it has one real root and
+//!       with the trigonometric formula if it has three, then the roots are refined with Newton's method.
+//!
+///-------------------------------------------------------------------------------------
+
+int solve_cubic_equation(double a, double b, double c, double d, double roots[3]);
+
+
+///-------------------------------------------------------------------------------------
+//! Solves the quartic equation \f$ a x^4 + b x^3 + c x^2 + d x + e = 0 \f$
+//!
+//! @param [in]  a      The quartic coefficient   (coefficient a)
+//! @param [in]  b      The cubic coefficient     (coefficient b)
+//! @param [in]  c      The quadratic coefficient (coefficient c)
+//! @param [in]  d      The linear coefficient    (coefficient d)
+//! @param [in]  e      The constant              (coefficient e)
+//! @param [out] roots  Array of 4 numbers where to write the roots
+//!
+//! @return Number of different real roots
+//!
+//! @note Roots are written like in @c solve_cubic_equation. If @c a is zero, solves the cubic equation.
+//!       The depressed quartic is split into two quadratic equations with Ferrari's method
+//!       (a root of the resolvent cubic is found with @c solve_cubic_equation).
+//!
+///-------------------------------------------------------------------------------------
+
+int solve_quartic_equation(double a, double b, double c, double d, double e, double roots[4]);
+
+
+///-------------------------------------------------------------------------------------
+//! Solves the polynomial equation \f$ c_0 x^n + c_1 x^{n - 1} + ... + c_n = 0 \f$
+//!
+//! @param [in]  coefficients  Array of @c degree + 1 coefficients, beginning from the highest power of x
+//! @param [in]  degree        Degree of the polynomial (n), not greater than @c MAX_POLYNOMIAL_DEGREE
+//! @param [out] roots         Array of @c degree numbers where to write the roots
+//!
+//! @return Number of different real roots
+//!
+//! @note Roots are written like in @c solve_cubic_equation. Leading zero coefficients (see @c is_zero) are skipped.
+//!       Equations of degree up to 4 are solved with the closed-form solvers, higher degrees are solved
+//!       with Aberth's method: all complex roots are found simultaneously, roots with
+//!       imaginary parts less than @c EPS are considered real and refined with Newton's method.
+//!
+///-------------------------------------------------------------------------------------
+
+int solve_polynomial_equation(const double *coefficients, int degree, double *roots);
+
+
+///-------------------------------------------------------------------------------------
+//! Solves @c n cubic equations given as separate coefficient arrays
+//!
+//! @param [in]  a       Array of the cubic coefficients
+//! @param [in]  b       Array of the quadratic coefficients
+//! @param [in]  c       Array of the linear coefficients
+//! @param [in]  d       Array of the constants
+//! @param [in]  n       Number of equations (size of every coefficient array)
+//! @param [out] nroots  Array where to write the number of roots of each equation
+//! @param [out] roots   Array of 3 * n numbers, roots of the i-th equation are written to roots[3 * i], ..., roots[3 * i + 2]
+//!
+//! @note For every i writes exactly what @c solve_cubic_equation(a[i], b[i], c[i], d[i], roots + 3 * i) would write and returns.
+//!
+///-------------------------------------------------------------------------------------
+
+void solve_cubic_equations(const double *a, const double *b, const double *c, const double *d, size_t n,
+                           int *nroots, double *roots);
+
+
+///-------------------------------------------------------------------------------------
+//! Solves @c n quartic equations given as separate coefficient arrays
+//!
+//! @param [in]  a       Array of the quartic coefficients
+//! @param [in]  b       Array of the cubic coefficients
+//! @param [in]  c       Array of the quadratic coefficients
+//! @param [in]  d       Array of the linear coefficients
+//! @param [in]  e       Array of the constants
+//! @param [in]  n       Number of equations (size of every coefficient array)
+//! @param [out] nroots  Array where to write the number of roots of each equation
+//! @param [out] roots   Array of 4 * n numbers, roots of the i-th equation are written to roots[4 * i], ..., roots[4 * i + 3]
+//!
+//! @note For every i writes exactly what @c solve_quartic_equation(a[i], b[i], c[i], d[i], e[i], roots + 4 * i) would write and returns.
+//!
+///-------------------------------------------------------------------------------------
+
+void solve_quartic_equations(const double *a, const double *b, const double *c, const double *d, const double *e, size_t n,
+                             int *nroots, double *roots);
+
+
+///-------------------------------------------------------------------------------------
+//! Solves @c n polynomial equations of the same degree
+//!
+//! @param [in]  coefficients  Array of n * (@c degree + 1) coefficients, coefficients of the i-th equation
+//!                            begin from coefficients[i * (degree + 1)] (see @c solve_polynomial_equation)
+//! @param [in]  degree        Degree of the polynomials
+//! @param [in]  n             Number of equations
+//! @param [out] nroots        Array where to write the number of roots of each equation
+//! @param [out] roots         Array of @c degree * n numbers, roots of the i-th equation begin from roots[i * degree]
+//!
+//! @note Calls @c solve_polynomial_equation for every equation in turn: the iterations of Aberth's method
+//!       (degree 5 and higher) are not vectorized across equations.
+//!
+///-------------------------------------------------------------------------------------
+
+void solve_each_polynomial_equation(const double *coefficients, int degree, size_t n, int *nroots, double *roots);
+
+#endif
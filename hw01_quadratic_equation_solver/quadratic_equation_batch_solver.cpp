@@ -0,0 +1,851 @@
+#include "quadratic_equation_solver.h"
+
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#if defined(__AVX512F__) || defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace batch_details
+{
+/*
+Every *_lanes structure wraps the instructions of one instruction set, so that
+solve_block below is written only once. reg holds (width) numbers of type scalar,
+mask holds the result of a comparison of two regs. A float reg holds twice as many
+numbers as a double reg of the same size.
+*/
+
+#if defined(__SSE2__)
+    struct sse2_double_lanes
+    {
+        typedef double scalar;
+        typedef __m128d reg;
+        typedef __m128d mask;
+        static constexpr size_t width = 2;
+
+        static reg load(const double *p)          { return _mm_loadu_pd(p); }
+        static void store(double *p, reg x)       { _mm_storeu_pd(p, x); }
+        static void store_counts(int *p, reg x)   { _mm_storel_epi64((__m128i *)p, _mm_cvttpd_epi32(x)); }
+        static reg set1(double x)                 { return _mm_set1_pd(x); }
+
+        static reg add(reg x, reg y)              { return _mm_add_pd(x, y); }
+        static reg sub(reg x, reg y)              { return _mm_sub_pd(x, y); }
+        static reg mul(reg x, reg y)              { return _mm_mul_pd(x, y); }
+#ifdef __FMA__
+        static reg mul_sub(reg x, reg y, reg z)   { return _mm_fmsub_pd(x, y, z); }
+#endif
+        static reg div(reg x, reg y)              { return _mm_div_pd(x, y); }
+        static reg sqrt(reg x)                    { return _mm_sqrt_pd(x); }
+        static reg neg(reg x)                     { return _mm_xor_pd(x, _mm_set1_pd(-0.0)); }
+        static reg abs(reg x)                     { return _mm_andnot_pd(_mm_set1_pd(-0.0), x); }
+
+        static mask less(reg x, reg y)            { return _mm_cmplt_pd(x, y); }
+        static mask less_equal(reg x, reg y)      { return _mm_cmple_pd(x, y); }
+        static mask mask_and(mask x, mask y)      { return _mm_and_pd(x, y); }
+        static mask mask_or(mask x, mask y)       { return _mm_or_pd(x, y); }
+        static mask mask_andnot(mask x, mask y)   { return _mm_andnot_pd(x, y); }
+        static int bits(mask x)                   { return _mm_movemask_pd(x); }
+
+        static reg select(mask m, reg if_true, reg if_false) { return _mm_or_pd(_mm_and_pd(m, if_true), _mm_andnot_pd(m, if_false)); }
+    };
+    struct sse2_float_lanes
+    {
+        typedef float scalar;
+        typedef __m128 reg;
+        typedef __m128 mask;
+        static constexpr size_t width = 4;
+
+        static reg load(const float *p)           { return _mm_loadu_ps(p); }
+        static void store(float *p, reg x)        { _mm_storeu_ps(p, x); }
+        static void store_counts(int *p, reg x)   { _mm_storeu_si128((__m128i *)p, _mm_cvttps_epi32(x)); }
+        static reg set1(float x)                  { return _mm_set1_ps(x); }
+
+        static reg add(reg x, reg y)              { return _mm_add_ps(x, y); }
+        static reg sub(reg x, reg y)              { return _mm_sub_ps(x, y); }
+        static reg mul(reg x, reg y)              { return _mm_mul_ps(x, y); }
+#ifdef __FMA__
+        static reg mul_sub(reg x, reg y, reg z)   { return _mm_fmsub_ps(x, y, z); }
+#endif
+        static reg div(reg x, reg y)              { return _mm_div_ps(x, y); }
+        static reg sqrt(reg x)                    { return _mm_sqrt_ps(x); }
+        static reg neg(reg x)                     { return _mm_xor_ps(x, _mm_set1_ps(-0.0f)); }
+        static reg abs(reg x)                     { return _mm_andnot_ps(_mm_set1_ps(-0.0f), x); }
+
+        static mask less(reg x, reg y)            { return _mm_cmplt_ps(x, y); }
+        static mask less_equal(reg x, reg y)      { return _mm_cmple_ps(x, y); }
+        static mask mask_and(mask x, mask y)      { return _mm_and_ps(x, y); }
+        static mask mask_or(mask x, mask y)       { return _mm_or_ps(x, y); }
+        static mask mask_andnot(mask x, mask y)   { return _mm_andnot_ps(x, y); }
+        static int bits(mask x)                   { return _mm_movemask_ps(x); }
+
+        static reg select(mask m, reg if_true, reg if_false) { return _mm_or_ps(_mm_and_ps(m, if_true), _mm_andnot_ps(m, if_false)); }
+    };
+#endif
+
+#if defined(__AVX512F__)
+    struct avx512_double_lanes
+    {
+        typedef double scalar;
+        typedef __m512d reg;
+        typedef __mmask8 mask;
+        static constexpr size_t width = 8;
+
+        static reg load(const double *p)          { return _mm512_loadu_pd(p); }
+        static void store(double *p, reg x)       { _mm512_storeu_pd(p, x); }
+        static void store_counts(int *p, reg x)   { _mm256_storeu_si256((__m256i *)p, _mm512_cvttpd_epi32(x)); }
+        static reg set1(double x)                 { return _mm512_set1_pd(x); }
+
+        static reg add(reg x, reg y)              { return _mm512_add_pd(x, y); }
+        static reg sub(reg x, reg y)              { return _mm512_sub_pd(x, y); }
+        static reg mul(reg x, reg y)              { return _mm512_mul_pd(x, y); }
+        static reg mul_sub(reg x, reg y, reg z)   { return _mm512_fmsub_pd(x, y, z); }
+        static reg div(reg x, reg y)              { return _mm512_div_pd(x, y); }
+        static reg sqrt(reg x)                    { return _mm512_sqrt_pd(x); }
+        static reg neg(reg x)                     { return _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(x),
+                                                                           _mm512_set1_epi64(INT64_MIN))); }
+        static reg abs(reg x)                     { return _mm512_abs_pd(x); }
+
+        static mask less(reg x, reg y)            { return _mm512_cmp_pd_mask(x, y, _CMP_LT_OQ); }
+        static mask less_equal(reg x, reg y)      { return _mm512_cmp_pd_mask(x, y, _CMP_LE_OQ); }
+        static mask mask_and(mask x, mask y)      { return x & y; }
+        static mask mask_or(mask x, mask y)       { return x | y; }
+        static mask mask_andnot(mask x, mask y)   { return ~x & y; }
+        static int bits(mask x)                   { return x; }
+
+        static reg select(mask m, reg if_true, reg if_false) { return _mm512_mask_blend_pd(m, if_false, if_true); }
+    };
+    struct avx512_float_lanes
+    {
+        typedef float scalar;
+        typedef __m512 reg;
+        typedef __mmask16 mask;
+        static constexpr size_t width = 16;
+
+        static reg load(const float *p)           { return _mm512_loadu_ps(p); }
+        static void store(float *p, reg x)        { _mm512_storeu_ps(p, x); }
+        static void store_counts(int *p, reg x)   { _mm512_storeu_si512((void *)p, _mm512_cvttps_epi32(x)); }
+        static reg set1(float x)                  { return _mm512_set1_ps(x); }
+
+        static reg add(reg x, reg y)              { return _mm512_add_ps(x, y); }
+        static reg sub(reg x, reg y)              { return _mm512_sub_ps(x, y); }
+        static reg mul(reg x, reg y)              { return _mm512_mul_ps(x, y); }
+        static reg mul_sub(reg x, reg y, reg z)   { return _mm512_fmsub_ps(x, y, z); }
+        static reg div(reg x, reg y)              { return _mm512_div_ps(x, y); }
+        static reg sqrt(reg x)                    { return _mm512_sqrt_ps(x); }
+        static reg neg(reg x)                     { return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(x),
+                                                                           _mm512_set1_epi32(INT32_MIN))); }
+        static reg abs(reg x)                     { return _mm512_abs_ps(x); }
+
+        static mask less(reg x, reg y)            { return _mm512_cmp_ps_mask(x, y, _CMP_LT_OQ); }
+        static mask less_equal(reg x, reg y)      { return _mm512_cmp_ps_mask(x, y, _CMP_LE_OQ); }
+        static mask mask_and(mask x, mask y)      { return x & y; }
+        static mask mask_or(mask x, mask y)       { return x | y; }
+        static mask mask_andnot(mask x, mask y)   { return ~x & y; }
+        static int bits(mask x)                   { return x; }
+
+        static reg select(mask m, reg if_true, reg if_false) { return _mm512_mask_blend_ps(m, if_false, if_true); }
+    };
+    typedef avx512_double_lanes native_double_lanes;
+    typedef avx512_float_lanes native_float_lanes;
+#elif defined(__AVX__)
+    struct avx_double_lanes
+    {
+        typedef double scalar;
+        typedef __m256d reg;
+        typedef __m256d mask;
+        static constexpr size_t width = 4;
+
+        static reg load(const double *p)          { return _mm256_loadu_pd(p); }
+        static void store(double *p, reg x)       { _mm256_storeu_pd(p, x); }
+        static void store_counts(int *p, reg x)   { _mm_storeu_si128((__m128i *)p, _mm256_cvttpd_epi32(x)); }
+        static reg set1(double x)                 { return _mm256_set1_pd(x); }
+
+        static reg add(reg x, reg y)              { return _mm256_add_pd(x, y); }
+        static reg sub(reg x, reg y)              { return _mm256_sub_pd(x, y); }
+        static reg mul(reg x, reg y)              { return _mm256_mul_pd(x, y); }
+#ifdef __FMA__
+        static reg mul_sub(reg x, reg y, reg z)   { return _mm256_fmsub_pd(x, y, z); }
+#endif
+        static reg div(reg x, reg y)              { return _mm256_div_pd(x, y); }
+        static reg sqrt(reg x)                    { return _mm256_sqrt_pd(x); }
+        static reg neg(reg x)                     { return _mm256_xor_pd(x, _mm256_set1_pd(-0.0)); }
+        static reg abs(reg x)                     { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), x); }
+
+        static mask less(reg x, reg y)            { return _mm256_cmp_pd(x, y, _CMP_LT_OQ); }
+        static mask less_equal(reg x, reg y)      { return _mm256_cmp_pd(x, y, _CMP_LE_OQ); }
+        static mask mask_and(mask x, mask y)      { return _mm256_and_pd(x, y); }
+        static mask mask_or(mask x, mask y)       { return _mm256_or_pd(x, y); }
+        static mask mask_andnot(mask x, mask y)   { return _mm256_andnot_pd(x, y); }
+        static int bits(mask x)                   { return _mm256_movemask_pd(x); }
+
+        static reg select(mask m, reg if_true, reg if_false) { return _mm256_blendv_pd(if_false, if_true, m); }
+    };
+    struct avx_float_lanes
+    {
+        typedef float scalar;
+        typedef __m256 reg;
+        typedef __m256 mask;
+        static constexpr size_t width = 8;
+
+        static reg load(const float *p)           { return _mm256_loadu_ps(p); }
+        static void store(float *p, reg x)        { _mm256_storeu_ps(p, x); }
+        static void store_counts(int *p, reg x)   { _mm256_storeu_si256((__m256i *)p, _mm256_cvttps_epi32(x)); }
+        static reg set1(float x)                  { return _mm256_set1_ps(x); }
+
+        static reg add(reg x, reg y)              { return _mm256_add_ps(x, y); }
+        static reg sub(reg x, reg y)              { return _mm256_sub_ps(x, y); }
+        static reg mul(reg x, reg y)              { return _mm256_mul_ps(x, y); }
+#ifdef __FMA__
+        static reg mul_sub(reg x, reg y, reg z)   { return _mm256_fmsub_ps(x, y, z); }
+#endif
+        static reg div(reg x, reg y)              { return _mm256_div_ps(x, y); }
+        static reg sqrt(reg x)                    { return _mm256_sqrt_ps(x); }
+        static reg neg(reg x)                     { return _mm256_xor_ps(x, _mm256_set1_ps(-0.0f)); }
+        static reg abs(reg x)                     { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), x); }
+
+        static mask less(reg x, reg y)            { return _mm256_cmp_ps(x, y, _CMP_LT_OQ); }
+        static mask less_equal(reg x, reg y)      { return _mm256_cmp_ps(x, y, _CMP_LE_OQ); }
+        static mask mask_and(mask x, mask y)      { return _mm256_and_ps(x, y); }
+        static mask mask_or(mask x, mask y)       { return _mm256_or_ps(x, y); }
+        static mask mask_andnot(mask x, mask y)   { return _mm256_andnot_ps(x, y); }
+        static int bits(mask x)                   { return _mm256_movemask_ps(x); }
+
+        static reg select(mask m, reg if_true, reg if_false) { return _mm256_blendv_ps(if_false, if_true, m); }
+    };
+    typedef avx_double_lanes native_double_lanes;
+    typedef avx_float_lanes native_float_lanes;
+#elif defined(__SSE2__)
+    typedef sse2_double_lanes native_double_lanes;
+    typedef sse2_float_lanes native_float_lanes;
+#endif
+
+/*
+scalar_lanes<T> runs the code written for *_lanes structures on one number of type T at a time,
+for the types and instruction sets without SIMD lanes
+*/
+    template<typename T>
+    struct scalar_lanes
+    {
+        typedef T scalar;
+        typedef T reg;
+        typedef bool mask;
+        static constexpr size_t width = 1;
+
+        static reg load(const T *p)               { return *p; }
+        static void store(T *p, reg x)            { *p = x; }
+        static void store_counts(int *p, reg x)   { *p = (int)x; }
+        static reg set1(T x)                      { return x; }
+
+        static reg add(reg x, reg y)              { return x + y; }
+        static reg sub(reg x, reg y)              { return x - y; }
+        static reg mul(reg x, reg y)              { return x * y; }
+#ifdef __FMA__
+        /* fused like mul_sub of the SIMD lanes, so that a single equation is rounded the same way as in a batch */
+        static reg mul_sub(reg x, reg y, reg z)   { return (std::is_same<T, long double>::value ? x * y - z : std::fma(x, y, -z)); }
+#else
+        static reg mul_sub(reg x, reg y, reg z)   { return x * y - z; }
+#endif
+        static reg div(reg x, reg y)              { return x / y; }
+        static reg sqrt(reg x)                    { return std::sqrt(x); }
+        static reg neg(reg x)                     { return -x; }
+        static reg abs(reg x)                     { return std::fabs(x); }
+
+        static mask less(reg x, reg y)            { return x < y; }
+        static mask less_equal(reg x, reg y)      { return x <= y; }
+        static mask mask_and(mask x, mask y)      { return x && y; }
+        static mask mask_or(mask x, mask y)       { return x || y; }
+        static mask mask_andnot(mask x, mask y)   { return !x && y; }
+        static int bits(mask x)                   { return (x ? 1 : 0); }
+
+        static reg select(mask m, reg if_true, reg if_false) { return (m ? if_true : if_false); }
+    };
+
+/*
+native_lanes<T>::type is the widest *_lanes structure for T, or void if the equations
+with coefficients of type T are solved one at a time (long double, __float128 and
+all types without SIMD instructions)
+*/
+    template<typename T>
+    struct native_lanes
+    {
+        typedef void type;
+    };
+
+#if defined(__AVX512F__) || defined(__AVX__) || defined(__SSE2__)
+    template<>
+    struct native_lanes<double>
+    {
+        typedef native_double_lanes type;
+    };
+
+    template<>
+    struct native_lanes<float>
+    {
+        typedef native_float_lanes type;
+    };
+#endif
+
+/*
+lanes_or_scalar<L, T> is L, or scalar_lanes<T> if L is void
+*/
+    template<typename L, typename T>
+    using lanes_or_scalar = typename std::conditional<std::is_void<L>::value, scalar_lanes<T>, L>::type;
+
+/*
+Calculates b * b - 4 * a * c rounded exactly like in solve_quadratic_equation
+*/
+    template<typename V>
+    inline typename V::reg rounded_discriminant(typename V::reg va, typename V::reg vb, typename V::reg vc)
+    {
+        const typename V::reg four = V::set1(4);
+#if defined(__GNUC__) && !defined(__clang__) && defined(__FP_FAST_FMA) && defined(__FP_FAST_FMAF)
+        /* GCC contracts b * b - 4 * a * c of solve_quadratic_equation to fused multiply-add, the lanes must round the same way */
+        return V::mul_sub(vb, vb, V::mul(V::mul(four, va), vc));
+#else
+        return V::sub(V::mul(vb, vb), V::mul(V::mul(four, va), vc));
+#endif
+    }
+
+#if defined(__AVX512F__) || defined(__AVX__) || defined(__SSE2__)
+///-------------------------------------------------------------------------------------
+//! Solves @c V::width quadratic equations at once, repeating every branch of
+//! @c solve_quadratic_equation with masks
+//!
+//! @param [in]  a             Pointer to @c V::width quadratic coefficients
+//! @param [in]  b             Pointer to @c V::width linear coefficients
+//! @param [in]  c             Pointer to @c V::width constants
+//! @param [out] nroots        Pointer where to write @c V::width numbers of roots
+//! @param [out] first_roots   Pointer where to write @c V::width first roots
+//! @param [out] second_roots  Pointer where to write @c V::width second roots
+//! @param [out] imaginary_parts  Pointer where to write @c V::width imaginary parts if @c complex_roots
+//!                               (see @c try_solve_quadratic_equation_complex), not used otherwise
+//!
+//! @return Bit mask of the lanes, that must be solved again with @c solve_quadratic_equation
+//!         (not finite coefficients or not finite results)
+//!
+///-------------------------------------------------------------------------------------
+    template<typename V, bool complex_roots>
+    inline int solve_block(const typename V::scalar *a, const typename V::scalar *b, const typename V::scalar *c,
+                           int *nroots, typename V::scalar *first_roots, typename V::scalar *second_roots,
+                           typename V::scalar *imaginary_parts)
+    {
+        typedef typename V::scalar scalar;
+        typedef typename V::reg reg;
+        typedef typename V::mask mask;
+
+        const reg eps = V::set1(solver_traits<scalar>::eps);
+        const reg max = V::set1(std::numeric_limits<scalar>::max());
+        const reg zero = V::set1(0), half = V::set1(0.5), one = V::set1(1), two = V::set1(2);
+        const reg nan = V::set1(std::numeric_limits<scalar>::quiet_NaN());
+
+        reg va = V::load(a), vb = V::load(b), vc = V::load(c);
+
+        mask a_zero = V::less(V::abs(va), eps);
+        mask b_zero = V::less(V::abs(vb), eps);
+        mask c_zero = V::less(V::abs(vc), eps);
+
+        reg discriminant = rounded_discriminant<V>(va, vb, vc);
+        mask d_zero = V::less(V::abs(discriminant), eps);
+        mask d_negative = V::mask_andnot(d_zero, V::less(discriminant, zero));
+        mask d_positive = V::mask_andnot(d_zero, V::less(zero, discriminant));
+
+        reg sqrt_d = V::sqrt(discriminant);
+        reg two_a = V::mul(two, va);
+        reg minus_b = V::neg(vb);
+
+        // one division gives the linear root -c / b, the vertex -b / 2a or the first root (-b + sqrt(D)) / 2a,
+        // whichever the lane needs, the numerators are the same as in solve_quadratic_equation
+        reg first_quotient = V::div(V::select(a_zero, V::neg(vc), V::select(d_positive, V::add(minus_b, sqrt_d), minus_b)),
+                                    V::select(a_zero, vb, two_a));
+
+        // a == 0: solve_linear_equation(b, c, first_root)
+        reg linear_nroots = V::select(b_zero, V::select(c_zero, V::set1(INF_ROOTS), zero), one);
+        reg linear_root   = V::select(b_zero, nan, first_quotient);
+
+        // a != 0
+        reg quadratic_nroots = V::select(d_zero, one, V::select(d_negative, (complex_roots ? two : zero), two));
+        reg quadratic_first  = (complex_roots ? first_quotient : V::select(d_negative, nan, first_quotient));
+        reg quadratic_second = V::select(d_positive, V::div(V::sub(minus_b, sqrt_d), two_a),
+                                         (complex_roots ? V::select(d_negative, first_quotient, nan) : nan));
+
+        reg vnroots = V::select(a_zero, linear_nroots, quadratic_nroots);
+        reg vfirst  = V::select(a_zero, linear_root, quadratic_first);
+        reg vsecond = V::select(a_zero, nan, quadratic_second);
+        reg vimaginary = zero;
+        if constexpr (complex_roots) {
+            vimaginary = V::select(V::mask_andnot(a_zero, d_negative), V::div(V::sqrt(V::neg(discriminant)), two_a), zero);
+            V::store(imaginary_parts, vimaginary);
+        }
+
+        V::store_counts(nroots, vnroots);
+        V::store(first_roots, vfirst);
+        V::store(second_roots, vsecond);
+
+        mask finite_input = V::mask_and(V::less_equal(V::abs(va), max),
+                            V::mask_and(V::less_equal(V::abs(vb), max), V::less_equal(V::abs(vc), max)));
+        mask finite_output = V::mask_and(V::mask_or(V::less_equal(vnroots, half), V::less_equal(V::abs(vfirst), max)),
+                                         V::mask_or(V::less_equal(vnroots, V::add(one, half)), V::less_equal(V::abs(vsecond), max)));
+        mask finite_discriminant = V::mask_or(a_zero, V::less_equal(V::abs(discriminant), max));
+        mask good = V::mask_and(finite_input, V::mask_and(finite_output, finite_discriminant));
+        if constexpr (complex_roots) {
+            good = V::mask_and(good, V::less_equal(V::abs(vimaginary), max));
+        }
+        return ~V::bits(good) & ((1 << V::width) - 1);
+    }
+#endif
+
+/*
+Returns the step that moves x, the rounded to nearest result of an operation, by at least one ulp:
+|x| * epsilon, but not less than the smallest normal number, so that the step and the moved x never
+are denormal numbers (they would make the next operations many times slower).
+*/
+    template<typename V>
+    inline typename V::reg rounding_step(typename V::reg x)
+    {
+        typedef typename V::scalar scalar;
+        const typename V::reg tiny = V::set1(std::numeric_limits<scalar>::min() / std::numeric_limits<scalar>::epsilon());
+        typename V::reg magnitude = V::abs(x);
+        return V::mul(V::select(V::less(magnitude, tiny), tiny, magnitude), V::set1(std::numeric_limits<scalar>::epsilon()));
+    }
+
+/*
+Moves x down (up), so that the exact result of the operation is not less (not greater) than the returned number
+*/
+    template<typename V>
+    inline typename V::reg round_down(typename V::reg x)
+    {
+        return V::sub(x, rounding_step<V>(x));
+    }
+
+    template<typename V>
+    inline typename V::reg round_up(typename V::reg x)
+    {
+        return V::add(x, rounding_step<V>(x));
+    }
+
+///-------------------------------------------------------------------------------------
+//! Bounds the roots of @c V::width quadratic equations at once with interval arithmetic
+//! (see @c solve_quadratic_equation_certified)
+//!
+//! @param [in]  a          Pointer to @c V::width quadratic coefficients
+//! @param [in]  b          Pointer to @c V::width linear coefficients
+//! @param [in]  c          Pointer to @c V::width constants
+//! @param [out] nroots     Pointer where to write @c V::width numbers of roots
+//! @param [out] first_lo   Pointer where to write @c V::width lower bounds of the first roots
+//! @param [out] first_hi   Pointer where to write @c V::width upper bounds of the first roots
+//! @param [out] second_lo  Pointer where to write @c V::width lower bounds of the second roots
+//! @param [out] second_hi  Pointer where to write @c V::width upper bounds of the second roots
+//!
+//! @return Bit mask of the lanes with not finite coefficients, discriminants or bounds
+//!
+///-------------------------------------------------------------------------------------
+    template<typename V>
+    inline int solve_block_certified(const typename V::scalar *a, const typename V::scalar *b, const typename V::scalar *c,
+                                     int *nroots, typename V::scalar *first_lo, typename V::scalar *first_hi,
+                                     typename V::scalar *second_lo, typename V::scalar *second_hi)
+    {
+        typedef typename V::scalar scalar;
+        typedef typename V::reg reg;
+        typedef typename V::mask mask;
+
+        const reg eps = V::set1(solver_traits<scalar>::eps);
+        const reg max = V::set1(std::numeric_limits<scalar>::max());
+        const reg zero = V::set1(0), half = V::set1(0.5), one = V::set1(1), two = V::set1(2), four = V::set1(4);
+        const reg nan = V::set1(std::numeric_limits<scalar>::quiet_NaN());
+        const reg inf = V::set1(std::numeric_limits<scalar>::infinity());
+
+        reg va = V::load(a), vb = V::load(b), vc = V::load(c);
+
+        mask a_zero = V::less(V::abs(va), eps);
+        mask b_zero = V::less(V::abs(vb), eps);
+        mask c_zero = V::less(V::abs(vc), eps);
+        mask a_negative = V::less(va, zero);
+        mask b_negative = V::less(vb, zero);
+
+        // the number of roots is the same as in solve_quadratic_equation
+        reg discriminant = rounded_discriminant<V>(va, vb, vc);
+        mask d_zero = V::less(V::abs(discriminant), eps);
+        mask d_positive = V::mask_andnot(d_zero, V::less(zero, discriminant));
+        reg linear_nroots = V::select(b_zero, V::select(c_zero, V::set1(INF_ROOTS), zero), one);
+        reg quadratic_nroots = V::select(d_zero, one, V::select(d_positive, two, zero));
+
+        // [d_lo, d_hi] contains b * b - 4 * a * c, 4 * a is exact
+        reg b_square = V::mul(vb, vb), four_ac = V::mul(V::mul(four, va), vc);
+        reg d_lo = round_down<V>(V::sub(round_down<V>(b_square), round_up<V>(four_ac)));
+        reg d_hi = round_up<V>(V::sub(round_up<V>(b_square), round_down<V>(four_ac)));
+        // sqrt(0) is exact, so the clamped bounds are not rounded
+        mask d_lo_positive = V::less(zero, d_lo), d_hi_positive = V::less(zero, d_hi);
+        reg sqrt_lo = V::select(d_lo_positive, round_down<V>(V::sqrt(V::select(d_lo_positive, d_lo, one))), zero);
+        reg sqrt_hi = V::select(d_hi_positive, round_up<V>(V::sqrt(V::select(d_hi_positive, d_hi, one))), zero);
+
+        // two roots: 2q = -(b + sign(b) sqrt(D)), the roots are 2q / 2a and 2c / 2q
+        reg q_lo = V::neg(round_up<V>(V::add(vb, V::select(b_negative, V::neg(sqrt_lo), sqrt_hi))));
+        reg q_hi = V::neg(round_down<V>(V::add(vb, V::select(b_negative, V::neg(sqrt_hi), sqrt_lo))));
+        reg two_a = V::mul(two, va), two_c = V::mul(two, vc);
+        reg big_lo = round_down<V>(V::div(V::select(a_negative, q_hi, q_lo), two_a));
+        reg big_hi = round_up<V>(V::div(V::select(a_negative, q_lo, q_hi), two_a));
+        reg small_1 = V::div(two_c, q_lo), small_2 = V::div(two_c, q_hi);
+        mask small_ordered = V::less(small_1, small_2);
+        mask q_has_zero = V::mask_and(V::less_equal(q_lo, zero), V::less_equal(zero, q_hi));
+        reg small_lo = V::select(q_has_zero, V::neg(inf), round_down<V>(V::select(small_ordered, small_1, small_2)));
+        reg small_hi = V::select(q_has_zero, inf, round_up<V>(V::select(small_ordered, small_2, small_1)));
+
+        // one root: -b / 2a, widened by the greatest possible sqrt(D) / 2a
+        reg vertex = V::div(V::neg(vb), two_a);
+        reg spread = round_up<V>(V::div(sqrt_hi, V::abs(two_a)));
+        reg vertex_lo = round_down<V>(V::sub(round_down<V>(vertex), spread));
+        reg vertex_hi = round_up<V>(V::add(round_up<V>(vertex), spread));
+
+        // a == 0: -c / b
+        reg linear_root = V::div(V::neg(vc), vb);
+        reg linear_lo = V::select(b_zero, nan, round_down<V>(linear_root));
+        reg linear_hi = V::select(b_zero, nan, round_up<V>(linear_root));
+
+        reg vnroots = V::select(a_zero, linear_nroots, quadratic_nroots);
+        reg vfirst_lo = V::select(a_zero, linear_lo,
+                                  V::select(d_zero, vertex_lo, V::select(d_positive, V::select(b_negative, big_lo, small_lo), nan)));
+        reg vfirst_hi = V::select(a_zero, linear_hi,
+                                  V::select(d_zero, vertex_hi, V::select(d_positive, V::select(b_negative, big_hi, small_hi), nan)));
+        mask two_roots = V::mask_andnot(a_zero, d_positive);
+        reg vsecond_lo = V::select(two_roots, V::select(b_negative, small_lo, big_lo), nan);
+        reg vsecond_hi = V::select(two_roots, V::select(b_negative, small_hi, big_hi), nan);
+
+        V::store_counts(nroots, vnroots);
+        V::store(first_lo, vfirst_lo);
+        V::store(first_hi, vfirst_hi);
+        V::store(second_lo, vsecond_lo);
+        V::store(second_hi, vsecond_hi);
+
+        mask finite_input = V::mask_and(V::less_equal(V::abs(va), max),
+                            V::mask_and(V::less_equal(V::abs(vb), max), V::less_equal(V::abs(vc), max)));
+        mask finite_first = V::mask_or(V::less_equal(vnroots, half),
+                                       V::mask_and(V::less_equal(V::abs(vfirst_lo), max), V::less_equal(V::abs(vfirst_hi), max)));
+        mask finite_second = V::mask_or(V::less_equal(vnroots, V::add(one, half)),
+                                        V::mask_and(V::less_equal(V::abs(vsecond_lo), max), V::less_equal(V::abs(vsecond_hi), max)));
+        mask finite_discriminant = V::mask_or(a_zero, V::less_equal(V::abs(discriminant), max));
+        mask good = V::mask_and(finite_input, V::mask_and(finite_discriminant, V::mask_and(finite_first, finite_second)));
+        return ~V::bits(good) & ((1 << V::width) - 1);
+    }
+
+/*
+Bounds the roots of a single equation exactly like solve_block_certified<scalar_lanes<T>>, but calculates
+only the bounds of its case, instead of copying the equation to SIMD lanes and calculating every case
+*/
+    template<typename T>
+    inline solver_status try_solve_certified_one(T a, T b, T c, int &nroots,
+                                                 root_enclosure<T> &first_root, root_enclosure<T> &second_root) noexcept
+    {
+        typedef scalar_lanes<T> S;
+        const T eps = solver_traits<T>::eps, max = std::numeric_limits<T>::max();
+        const T nan = std::numeric_limits<T>::quiet_NaN(), inf = std::numeric_limits<T>::infinity();
+
+        nroots = 0;
+        first_root = {nan, nan};
+        second_root = {nan, nan};
+        if (!(std::fabs(a) <= max && std::fabs(b) <= max && std::fabs(c) <= max)) {
+            return SOLVER_NOT_FINITE_INPUT;
+        }
+
+        if (std::fabs(a) < eps) {
+            if (std::fabs(b) < eps) {
+                nroots = (std::fabs(c) < eps ? INF_ROOTS : 0);
+                return SOLVER_OK;
+            }
+            T linear_root = -c / b;
+            T lo = round_down<S>(linear_root), hi = round_up<S>(linear_root);
+            if (!(std::fabs(lo) <= max && std::fabs(hi) <= max)) {
+                return SOLVER_OVERFLOW;
+            }
+            nroots = 1;
+            first_root = {lo, hi};
+            return SOLVER_OK;
+        }
+
+        // the number of roots is the same as in solve_quadratic_equation
+        T discriminant = rounded_discriminant<S>(a, b, c);
+        if (!(std::fabs(discriminant) <= max)) {
+            return SOLVER_OVERFLOW;
+        }
+        bool d_zero = std::fabs(discriminant) < eps;
+        if (!d_zero && !(0 < discriminant)) {
+            return SOLVER_OK;
+        }
+
+        // [d_lo, d_hi] contains b * b - 4 * a * c, 4 * a is exact
+        T b_square = b * b, four_ac = 4 * a * c, two_a = 2 * a;
+        T d_hi = round_up<S>(round_up<S>(b_square) - round_down<S>(four_ac));
+        T sqrt_hi = (0 < d_hi ? round_up<S>(std::sqrt(d_hi)) : 0);
+        root_enclosure<T> first = {0, 0}, second = {nan, nan};
+        if (d_zero) {
+            // one root: -b / 2a, widened by the greatest possible sqrt(D) / 2a
+            T vertex = -b / two_a;
+            T spread = round_up<S>(sqrt_hi / std::fabs(two_a));
+            first = {round_down<S>(round_down<S>(vertex) - spread), round_up<S>(round_up<S>(vertex) + spread)};
+        } else {
+            // two roots: 2q = -(b + sign(b) sqrt(D)), the roots are 2q / 2a and 2c / 2q
+            T d_lo = round_down<S>(round_down<S>(b_square) - round_up<S>(four_ac));
+            T sqrt_lo = (0 < d_lo ? round_down<S>(std::sqrt(d_lo)) : 0);
+            bool b_negative = b < 0;
+            T q_lo = -round_up<S>(b + (b_negative ? -sqrt_lo : sqrt_hi));
+            T q_hi = -round_down<S>(b + (b_negative ? -sqrt_hi : sqrt_lo));
+            bool a_negative = a < 0;
+            root_enclosure<T> big = {round_down<S>((a_negative ? q_hi : q_lo) / two_a),
+                                     round_up<S>((a_negative ? q_lo : q_hi) / two_a)};
+            root_enclosure<T> small = {-inf, inf};
+            if (!(q_lo <= 0 && 0 <= q_hi)) {
+                T two_c = 2 * c, small_1 = two_c / q_lo, small_2 = two_c / q_hi;
+                bool small_ordered = small_1 < small_2;
+                small = {round_down<S>(small_ordered ? small_1 : small_2), round_up<S>(small_ordered ? small_2 : small_1)};
+            }
+            first = (b_negative ? big : small);
+            second = (b_negative ? small : big);
+            if (!(std::fabs(second.lo) <= max && std::fabs(second.hi) <= max)) {
+                return SOLVER_OVERFLOW;
+            }
+        }
+        if (!(std::fabs(first.lo) <= max && std::fabs(first.hi) <= max)) {
+            return SOLVER_OVERFLOW;
+        }
+
+        nroots = (d_zero ? 1 : 2);
+        second_root = second;
+        first_root = first;
+        return SOLVER_OK;
+    }
+}
+
+
+namespace batch_details
+{
+/*
+Solves the scalar equation with try_solve_quadratic_equation or try_solve_quadratic_equation_complex
+*/
+    template<typename T, bool complex_roots>
+    inline solver_status try_solve_one(T a, T b, T c, int &nroots, T &first_root, T &second_root, T *imaginary_part) noexcept
+    {
+        if constexpr (complex_roots) {
+            return try_solve_quadratic_equation_complex(a, b, c, nroots, first_root, second_root, *imaginary_part);
+        } else {
+            return try_solve_quadratic_equation(a, b, c, nroots, first_root, second_root);
+        }
+    }
+
+/*
+try_solve_quadratic_equations and try_solve_quadratic_equations_complex (imaginary_parts is nullptr for the first one)
+*/
+    template<typename T, bool complex_roots>
+    void try_solve_all(const T *a, const T *b, const T *c, size_t n,
+                       int *nroots, T *first_roots, T *second_roots, T *imaginary_parts,
+                       solver_status *statuses) noexcept
+    {
+        if (n == 0) {
+            return;
+        }
+        assert(a != nullptr && b != nullptr && c != nullptr);
+        assert(nroots != nullptr && first_roots != nullptr && second_roots != nullptr && statuses != nullptr);
+        assert(first_roots != second_roots);
+        assert(!complex_roots || imaginary_parts != nullptr);
+
+        size_t i = 0;
+#if defined(__AVX512F__) || defined(__AVX__) || defined(__SSE2__)
+        typedef typename native_lanes<T>::type lanes;
+        if constexpr (!std::is_void<lanes>::value) {
+            for (; i + lanes::width <= n; i += lanes::width) {
+                int bad_lanes = solve_block<lanes, complex_roots>(a + i, b + i, c + i, nroots + i, first_roots + i, second_roots + i,
+                                                                  (complex_roots ? imaginary_parts + i : nullptr));
+                for (size_t j = i; j < i + lanes::width; j++, bad_lanes >>= 1) {
+                    if (bad_lanes & 1) {
+                        statuses[j] = try_solve_one<T, complex_roots>(a[j], b[j], c[j], nroots[j], first_roots[j], second_roots[j],
+                                                                      (complex_roots ? imaginary_parts + j : nullptr));
+                    } else {
+                        statuses[j] = SOLVER_OK;
+                    }
+                }
+            }
+        }
+#endif
+        for (; i < n; i++) {
+            statuses[i] = try_solve_one<T, complex_roots>(a[i], b[i], c[i], nroots[i], first_roots[i], second_roots[i],
+                                                          (complex_roots ? imaginary_parts + i : nullptr));
+        }
+    }
+
+/*
+solve_quadratic_equations and solve_quadratic_equations_complex (imaginary_parts is nullptr for the first one)
+*/
+    template<typename T, bool complex_roots>
+    void solve_all(const T *a, const T *b, const T *c, size_t n,
+                   int *nroots, T *first_roots, T *second_roots, T *imaginary_parts)
+    {
+        const size_t block_size = 256;
+        solver_status statuses[block_size];
+
+        for (size_t i = 0; i < n; i += block_size) {
+            size_t size = (n - i < block_size ? n - i : block_size);
+            try_solve_all<T, complex_roots>(a + i, b + i, c + i, size, nroots + i, first_roots + i, second_roots + i,
+                                            (complex_roots ? imaginary_parts + i : nullptr), statuses);
+            for (size_t j = 0; j < size; j++) {
+                if (statuses[j] != SOLVER_OK && complex_roots) {
+                    std::complex<T> first_root, second_root;
+                    nroots[i + j] = solve_quadratic_equation(a[i + j], b[i + j], c[i + j], first_root, second_root);
+                    first_roots[i + j] = first_root.real();
+                    second_roots[i + j] = second_root.real();
+                    imaginary_parts[i + j] = first_root.imag();
+                } else if (statuses[j] != SOLVER_OK) {
+                    nroots[i + j] = solve_quadratic_equation(a[i + j], b[i + j], c[i + j], first_roots[i + j], second_roots[i + j]);
+                }
+            }
+        }
+    }
+}
+
+
+/* See description in quadratic_equation_solver.h */
+
+template<typename T>
+void try_solve_quadratic_equations(const T *a, const T *b, const T *c, size_t n,
+                                   int *nroots, T *first_roots, T *second_roots,
+                                   solver_status *statuses) noexcept
+{
+    batch_details::try_solve_all<T, false>(a, b, c, n, nroots, first_roots, second_roots, nullptr, statuses);
+}
+
+
+/* See description in quadratic_equation_solver.h */
+
+template<typename T>
+void try_solve_quadratic_equations_complex(const T *a, const T *b, const T *c, size_t n,
+                                           int *nroots, T *first_roots, T *second_roots, T *imaginary_parts,
+                                           solver_status *statuses) noexcept
+{
+    batch_details::try_solve_all<T, true>(a, b, c, n, nroots, first_roots, second_roots, imaginary_parts, statuses);
+}
+
+
+/* See description in quadratic_equation_solver.h */
+
+template<typename T>
+void solve_quadratic_equations(const T *a, const T *b, const T *c, size_t n,
+                               int *nroots, T *first_roots, T *second_roots)
+{
+    batch_details::solve_all<T, false>(a, b, c, n, nroots, first_roots, second_roots, nullptr);
+}
+
+
+/* See description in quadratic_equation_solver.h */
+
+template<typename T>
+void solve_quadratic_equations_complex(const T *a, const T *b, const T *c, size_t n,
+                                       int *nroots, T *first_roots, T *second_roots, T *imaginary_parts)
+{
+    batch_details::solve_all<T, true>(a, b, c, n, nroots, first_roots, second_roots, imaginary_parts);
+}
+
+
+/* See description in quadratic_equation_solver.h */
+
+template<typename T>
+solver_status try_solve_quadratic_equation_certified(coefficient<T> a, coefficient<T> b, coefficient<T> c, int &nroots,
+                                                     root_enclosure<T> &first_root, root_enclosure<T> &second_root) noexcept
+{
+    solver_status status = batch_details::try_solve_certified_one<T>(a, b, c, nroots, first_root, second_root);
+    assert(nroots != 2 || &first_root != &second_root);
+    return status;
+}
+
+
+/* See description in quadratic_equation_solver.h */
+
+template<typename T>
+int solve_quadratic_equation_certified(coefficient<T> a, coefficient<T> b, coefficient<T> c,
+                                       root_enclosure<T> &first_root, root_enclosure<T> &second_root)
+{
+    assert(std::isfinite(a));
+    assert(std::isfinite(b));
+    assert(std::isfinite(c));
+
+    int nroots = 0;
+    if (try_solve_quadratic_equation_certified<T>(a, b, c, nroots, first_root, second_root) != SOLVER_OK) {
+        quadratic_details::throw_not_finite("the enclosures of the roots", a, b, c);
+    }
+    return nroots;
+}
+
+
+/* See description in quadratic_equation_solver.h */
+
+template<typename T>
+void solve_quadratic_equations_certified(const T *a, const T *b, const T *c, size_t n, int *nroots,
+                                         T *first_lo, T *first_hi, T *second_lo, T *second_hi)
+{
+    if (n == 0) {
+        return;
+    }
+    assert(a != nullptr && b != nullptr && c != nullptr && nroots != nullptr);
+    assert(first_lo != nullptr && first_hi != nullptr && second_lo != nullptr && second_hi != nullptr);
+
+    typedef batch_details::lanes_or_scalar<typename batch_details::native_lanes<T>::type, T> lanes;
+    auto solve_one = [&](size_t i) {
+        root_enclosure<T> first_root = {0, 0}, second_root = {0, 0};
+        nroots[i] = solve_quadratic_equation_certified<T>(a[i], b[i], c[i], first_root, second_root);
+        first_lo[i] = first_root.lo;
+        first_hi[i] = first_root.hi;
+        second_lo[i] = second_root.lo;
+        second_hi[i] = second_root.hi;
+    };
+
+    size_t i = 0;
+    for (; i + lanes::width <= n; i += lanes::width) {
+        int bad_lanes = batch_details::solve_block_certified<lanes>(a + i, b + i, c + i, nroots + i,
+                                                                    first_lo + i, first_hi + i, second_lo + i, second_hi + i);
+        for (size_t j = i; bad_lanes != 0; j++, bad_lanes >>= 1) {
+            if (bad_lanes & 1) {
+                solve_one(j); // asserts or throws the exception
+            }
+        }
+    }
+    for (; i < n; i++) {
+        solve_one(i);
+    }
+}
+
+
+#define INSTANTIATE_BATCH_SOLVER(T)                                                                 \
+    template void solve_quadratic_equations<T>(const T *, const T *, const T *, size_t,            \
+                                               int *, T *, T *);                                   \
+    template void try_solve_quadratic_equations<T>(const T *, const T *, const T *, size_t,        \
+                                                   int *, T *, T *, solver_status *) noexcept;     \
+    template void solve_quadratic_equations_complex<T>(const T *, const T *, const T *, size_t,    \
+                                                       int *, T *, T *, T *);                      \
+    template void try_solve_quadratic_equations_complex<T>(const T *, const T *, const T *, size_t,\
+                                                           int *, T *, T *, T *,                   \
+                                                           solver_status *) noexcept;
+
+INSTANTIATE_BATCH_SOLVER(float)
+INSTANTIATE_BATCH_SOLVER(double)
+INSTANTIATE_BATCH_SOLVER(long double)
+#ifdef __SIZEOF_FLOAT128__
+INSTANTIATE_BATCH_SOLVER(__float128)
+#endif
+
+
+#define INSTANTIATE_CERTIFIED_SOLVER(T)                                                                             \
+    template int solve_quadratic_equation_certified<T>(coefficient<T>, coefficient<T>, coefficient<T>,             \
+                                                       root_enclosure<T> &, root_enclosure<T> &);                  \
+    template solver_status try_solve_quadratic_equation_certified<T>(coefficient<T>, coefficient<T>, coefficient<T>,\
+                                                                     int &, root_enclosure<T> &,                    \
+                                                                     root_enclosure<T> &) noexcept;                \
+    template void solve_quadratic_equations_certified<T>(const T *, const T *, const T *, size_t, int *,          \
+                                                         T *, T *, T *, T *);
+
+INSTANTIATE_CERTIFIED_SOLVER(float)
+INSTANTIATE_CERTIFIED_SOLVER(double)
+INSTANTIATE_CERTIFIED_SOLVER(long double)
@@ -2,86 +2,425 @@
 
 #include <cassert>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
+
+#ifdef __SIZEOF_FLOAT128__
+#include <quadmath.h>
+#endif
+
+/*
+Math functions for every scalar type the solvers are instantiated for
+(std:: functions do not accept __float128, libquadmath is used for it)
+*/
+namespace solver_math
+{
+    template<typename T> inline T fabs(T num)             { return std::fabs(num); }
+    template<typename T> inline T sqrt(T num)             { return std::sqrt(num); }
+    template<typename T> inline T copysign(T num, T sign) { return std::copysign(num, sign); }
+    template<typename T> inline bool isfinite(T num)      { return std::isfinite(num); }
+
+#ifdef __SIZEOF_FLOAT128__
+    template<> inline __float128 fabs(__float128 num)                      { return fabsq(num); }
+    template<> inline __float128 sqrt(__float128 num)                      { return sqrtq(num); }
+    template<> inline __float128 copysign(__float128 num, __float128 sign) { return copysignq(num, sign); }
+    template<> inline bool isfinite(__float128 num)                        { return finiteq(num); }
+#endif
+}
 
 /* See description in quadratic_equation_solver.h */
 
-int solve_quadratic_equation(double a, double b, double c, double &first_root, double &second_root)
+[[noreturn]] void quadratic_details::throw_not_finite(const char *what, long double a, long double b, long double c)
 {
-    assert(std::isfinite(a));
-    assert(std::isfinite(b));
-    assert(std::isfinite(c));
-    first_root = NAN;
-    second_root = NAN;
+    throw std::runtime_error(std::string("Got not finite value, calculating ") + what + " of the quadratic equation "
+                             + std::to_string(a) + " * x^2 + " + std::to_string(b) + " * x + " +
+                             std::to_string(c) + "in file: " + __FILE__);
+}
 
-    if (is_zero(a)) {
-        return solve_linear_equation(b, c, first_root);
+/*
+Throws std::runtime_error about not finite value got while solving the linear equation.
+Kept out of line, so that the solvers themselves contain no string building.
+*/
+[[noreturn]] static void throw_not_finite(const char *what, long double a, long double b)
+{
+    throw std::runtime_error(std::string("Got not finite value, calculating ") + what + " of the linear equation "
+                             + std::to_string(a) + " * x + " + std::to_string(b) + "in file: " + __FILE__);
+}
+
+
+/*
+Solves the quadratic equation like try_solve_quadratic_equation. If imaginary_part is not nullptr,
+complex roots are calculated too (see try_solve_quadratic_equation_complex).
+*/
+template<typename T>
+static inline solver_status try_solve_quadratic(T a, T b, T c, int &nroots, T &first_root, T &second_root, T *imaginary_part) noexcept
+{
+    nroots = 0;
+    first_root = std::numeric_limits<T>::quiet_NaN();
+    second_root = std::numeric_limits<T>::quiet_NaN();
+    if (imaginary_part != nullptr) {
+        *imaginary_part = 0;
+    }
+    if (!solver_math::isfinite(a) || !solver_math::isfinite(b) || !solver_math::isfinite(c)) {
+        return SOLVER_NOT_FINITE_INPUT;
+    }
+
+    if (solver_math::fabs(a) < solver_traits<T>::eps) {
+        return try_solve_linear_equation<T>(b, c, nroots, first_root);
     } else { // a != 0
-        double discriminant = calculate_discriminant(a, b, c);
-        if (is_zero(discriminant)) {
+        T discriminant = 0;
+        solver_status status = try_calculate_discriminant<T>(a, b, c, discriminant);
+        if (status != SOLVER_OK) {
+            return status;
+        }
+        if (solver_math::fabs(discriminant) < solver_traits<T>::eps) {
             first_root = -b / (2 * a);
-            if (!std::isfinite(first_root)) {
-                throw std::runtime_error("Got not finite value, calculating the root of the quadratic equation "
-                                         + std::to_string(a) + " * x^2 + " + std::to_string(b) + " * x + " +
-                                         std::to_string(c) + "in file: " + __FILE__);
+            if (!solver_math::isfinite(first_root)) {
+                first_root = std::numeric_limits<T>::quiet_NaN();
+                return SOLVER_OVERFLOW;
             }
-            return 1;
+            nroots = 1;
         } else if (discriminant < 0) {
-            return 0;
+            if (imaginary_part != nullptr) {
+                assert(&first_root != &second_root);
+                first_root = -b / (2 * a);
+                second_root = first_root;
+                *imaginary_part = solver_math::sqrt(-discriminant) / (2 * a);
+                if (!solver_math::isfinite(first_root) || !solver_math::isfinite(*imaginary_part)) {
+                    first_root = std::numeric_limits<T>::quiet_NaN();
+                    second_root = std::numeric_limits<T>::quiet_NaN();
+                    *imaginary_part = 0;
+                    return SOLVER_OVERFLOW;
+                }
+                nroots = 2;
+            } else {
+                nroots = 0;
+            }
         } else { // discriminant > 0
             assert(&first_root != &second_root);
-            first_root = (-b + sqrt(discriminant)) / (2 * a);
-            second_root = (-b - sqrt(discriminant)) / (2 * a);
-            if (!std::isfinite(first_root) || !std::isfinite(second_root)) {
-                throw std::runtime_error("Got not finite value, calculating the root of the quadratic equation "
-                                         + std::to_string(a) + " * x^2 + " + std::to_string(b) + " * x + " +
-                                         std::to_string(c) + "in file: " + __FILE__);
+            first_root = (-b + solver_math::sqrt(discriminant)) / (2 * a);
+            second_root = (-b - solver_math::sqrt(discriminant)) / (2 * a);
+            if (!solver_math::isfinite(first_root) || !solver_math::isfinite(second_root)) {
+                first_root = std::numeric_limits<T>::quiet_NaN();
+                second_root = std::numeric_limits<T>::quiet_NaN();
+                return SOLVER_OVERFLOW;
             }
-            return 2;
+            nroots = 2;
+        }
+        return SOLVER_OK;
+    }
+}
+
+
+/* See description in quadratic_equation_solver.h */
+
+template<typename T>
+solver_status try_solve_quadratic_equation(coefficient<T> a, coefficient<T> b, coefficient<T> c,
+                                           int &nroots, T &first_root, T &second_root) noexcept
+{
+    return try_solve_quadratic<T>(a, b, c, nroots, first_root, second_root, nullptr);
+}
+
+
+/* See description in quadratic_equation_solver.h */
+
+template<typename T>
+solver_status try_solve_quadratic_equation_complex(coefficient<T> a, coefficient<T> b, coefficient<T> c,
+                                                   int &nroots, T &first_root, T &second_root, T &imaginary_part) noexcept
+{
+    return try_solve_quadratic<T>(a, b, c, nroots, first_root, second_root, &imaginary_part);
+}
+
+
+/* See description in quadratic_equation_solver.h */
+
+template<typename T>
+int solve_quadratic_equation(coefficient<T> a, coefficient<T> b, coefficient<T> c, T &first_root, T &second_root)
+{
+    assert(solver_math::isfinite(a));
+    assert(solver_math::isfinite(b));
+    assert(solver_math::isfinite(c));
+
+    int nroots = 0;
+    if (try_solve_quadratic_equation<T>(a, b, c, nroots, first_root, second_root) != SOLVER_OK) {
+        if (is_zero<T>(a)) {
+            return solve_linear_equation<T>(b, c, first_root);
+        }
+        calculate_discriminant<T>(a, b, c);
+        quadratic_details::throw_not_finite("the root", a, b, c);
+    }
+    return nroots;
+}
+
+
+/* See description in quadratic_equation_solver.h */
+
+template<typename T>
+int solve_quadratic_equation(coefficient<T> a, coefficient<T> b, coefficient<T> c,
+                             std::complex<T> &first_root, std::complex<T> &second_root)
+{
+    assert(solver_math::isfinite(a));
+    assert(solver_math::isfinite(b));
+    assert(solver_math::isfinite(c));
+
+    int nroots = 0;
+    T first_real = 0, second_real = 0, imaginary_part = 0;
+    if (try_solve_quadratic_equation_complex<T>(a, b, c, nroots, first_real, second_real, imaginary_part) != SOLVER_OK) {
+        if (is_zero<T>(a)) {
+            nroots = solve_linear_equation<T>(b, c, first_real);
+        } else {
+            calculate_discriminant<T>(a, b, c);
+            quadratic_details::throw_not_finite("the root", a, b, c);
+        }
+    }
+    assert(nroots < 2 || &first_root != &second_root);
+    first_root = std::complex<T>(first_real, imaginary_part);
+    second_root = std::complex<T>(second_real, -imaginary_part);
+    return nroots;
+}
+
+
+/*
+Returns x * y - product exactly, the rounding error of product = x * y (if it is not too close to overflow or underflow).
+Without FMA the numbers are split to halves of 26 bits (Veltkamp's split), so that the products of the halves are exact (Dekker's product).
+*/
+static inline double product_error(double x, double y, double product)
+{
+#ifdef __FMA__
+    return std::fma(x, y, -product);
+#else
+    const double splitter = 134217729.0; // 2^27 + 1
+    double x_big = splitter * x, y_big = splitter * y;
+    double x_hi = x_big - (x_big - x), y_hi = y_big - (y_big - y);
+    double x_lo = x - x_hi, y_lo = y - y_hi;
+    return ((x_hi * y_hi - product) + x_hi * y_lo + x_lo * y_hi) + x_lo * y_lo;
+#endif
+}
+
+
+/*
+Corrects discriminant = b * b - 4 * a * c (rounded) for the cancellation, when b * b is close to 4 * a * c.
+For double the rounding errors of both products are calculated exactly and added to it,
+for float it is calculated again in double, where the products are exact. Long double and __float128 are not corrected.
+*/
+template<typename T>
+static inline T accurate_discriminant(T a, T b, T c, T discriminant)
+{
+    (void)a, (void)b, (void)c;
+    return discriminant;
+}
+
+template<>
+inline float accurate_discriminant(float a, float b, float c, float discriminant)
+{
+    float corrected = (float)((double)b * b - (4.0 * a) * c);
+    return (corrected > 0 ? corrected : discriminant);
+}
+
+template<>
+inline double accurate_discriminant(double a, double b, double c, double discriminant)
+{
+    double b_square = b * b, four_ac = (4 * a) * c;
+#ifndef __FMA__
+    /* the split costs about 20 operations, the errors matter only if more than one bit of b * b is cancelled */
+    if (!(discriminant < 0.5 * b_square)) {
+        return discriminant;
+    }
+#endif
+    double corrected = discriminant + (product_error(b, b, b_square) - product_error(4 * a, c, four_ac));
+    // not corrected, if the split overflows (|4 * a| > 1e300) or the correction changes the sign of the discriminant
+    return (corrected > 0 ? corrected : discriminant);
+}
+
+
+/*
+Writes big_root and small_root to first_root and second_root: the big root goes first if b is negative.
+The sign of b is unpredictable, so for double the roots are swapped with bit masks instead of a branch.
+*/
+template<typename T>
+static inline void order_roots(T b, T big_root, T small_root, T &first_root, T &second_root)
+{
+    bool b_negative = (solver_math::copysign((T)1, b) < 0);
+    first_root = (b_negative ? big_root : small_root);
+    second_root = (b_negative ? small_root : big_root);
+}
+
+template<>
+inline void order_roots(double b, double big_root, double small_root, double &first_root, double &second_root)
+{
+    uint64_t big_bits = 0, small_bits = 0, b_bits = 0;
+    memcpy(&big_bits, &big_root, sizeof(double));
+    memcpy(&small_bits, &small_root, sizeof(double));
+    memcpy(&b_bits, &b, sizeof(double));
+    uint64_t b_negative_mask = 0 - (b_bits >> 63);
+    uint64_t first_bits = (big_bits & b_negative_mask) | (small_bits & ~b_negative_mask);
+    uint64_t second_bits = first_bits ^ big_bits ^ small_bits;
+    memcpy(&first_root, &first_bits, sizeof(double));
+    memcpy(&second_root, &second_bits, sizeof(double));
+}
+
+
+/*
+Solves the quadratic equation like try_solve_quadratic_equation_stable. Kept static inline (like try_solve_quadratic),
+so that solve_quadratic_equation_stable does not call the exported function and spill its arguments.
+*/
+template<typename T>
+static inline solver_status try_solve_quadratic_stable(T a, T b, T c, int &nroots, T &first_root, T &second_root) noexcept
+{
+    nroots = 0;
+    first_root = std::numeric_limits<T>::quiet_NaN();
+    second_root = std::numeric_limits<T>::quiet_NaN();
+    if (!solver_math::isfinite(a) || !solver_math::isfinite(b) || !solver_math::isfinite(c)) {
+        return SOLVER_NOT_FINITE_INPUT;
+    }
+
+    if (solver_math::fabs(a) < solver_traits<T>::eps) {
+        return try_solve_linear_equation<T>(b, c, nroots, first_root);
+    }
+    // the number of roots is the same as in solve_quadratic_equation, only the square root needs the accurate discriminant
+    T discriminant = b * b - 4 * a * c;
+    if (!solver_math::isfinite(discriminant)) {
+        return SOLVER_OVERFLOW;
+    }
+    if (solver_math::fabs(discriminant) < solver_traits<T>::eps) {
+        first_root = -b / (2 * a);
+        if (!solver_math::isfinite(first_root)) {
+            first_root = std::numeric_limits<T>::quiet_NaN();
+            return SOLVER_OVERFLOW;
         }
+        nroots = 1;
+    } else if (discriminant < 0) {
+        nroots = 0;
+    } else { // discriminant > 0
+        assert(&first_root != &second_root);
+        discriminant = accurate_discriminant<T>(a, b, c, discriminant);
+        /* -b and the square root have the same sign in q, so nothing is cancelled */
+        T q = -(b + solver_math::copysign(solver_math::sqrt(discriminant), b)); // 2q, multiplication by 0.5 is moved to the other operands
+        T big_root = q / (2 * a), small_root = (2 * c) / q;
+        // checked before ordering, so the roots are not read back from first_root and second_root
+        if (!solver_math::isfinite(big_root) || !solver_math::isfinite(small_root)) {
+            return SOLVER_OVERFLOW;
+        }
+        order_roots<T>(b, big_root, small_root, first_root, second_root);
+        nroots = 2;
     }
+    return SOLVER_OK;
 }
 
 
 /* See description in quadratic_equation_solver.h */
 
-int solve_linear_equation(double a, double b, double &root)
+template<typename T>
+solver_status try_solve_quadratic_equation_stable(coefficient<T> a, coefficient<T> b, coefficient<T> c,
+                                                  int &nroots, T &first_root, T &second_root) noexcept
 {
-    assert(std::isfinite(a));
-    assert(std::isfinite(b));
-    root = NAN;
+    return try_solve_quadratic_stable<T>(a, b, c, nroots, first_root, second_root);
+}
 
-    if (is_zero(a)) {
-        if (is_zero(b)) {
-            return INF_ROOTS;
+
+/* See description in quadratic_equation_solver.h */
+
+template<typename T>
+int solve_quadratic_equation_stable(coefficient<T> a, coefficient<T> b, coefficient<T> c, T &first_root, T &second_root)
+{
+    assert(solver_math::isfinite(a));
+    assert(solver_math::isfinite(b));
+    assert(solver_math::isfinite(c));
+
+    int nroots = 0;
+    if (try_solve_quadratic_stable<T>(a, b, c, nroots, first_root, second_root) != SOLVER_OK) {
+        if (is_zero<T>(a)) {
+            return solve_linear_equation<T>(b, c, first_root);
+        }
+        if (!solver_math::isfinite(b * b - 4 * a * c)) {
+            quadratic_details::throw_not_finite("the discriminant", a, b, c);
+        }
+        quadratic_details::throw_not_finite("the root", a, b, c);
+    }
+    return nroots;
+}
+
+
+/* See description in quadratic_equation_solver.h */
+
+template<typename T>
+solver_status try_solve_linear_equation(coefficient<T> a, coefficient<T> b, int &nroots, T &root) noexcept
+{
+    nroots = 0;
+    root = std::numeric_limits<T>::quiet_NaN();
+    if (!solver_math::isfinite(a) || !solver_math::isfinite(b)) {
+        return SOLVER_NOT_FINITE_INPUT;
+    }
+
+    if (solver_math::fabs(a) < solver_traits<T>::eps) {
+        if (solver_math::fabs(b) < solver_traits<T>::eps) {
+            nroots = INF_ROOTS;
         } else {
-            return 0;
+            nroots = 0;
         }
     } else { // b != 0
         root = - b / a;
-        if (!std::isfinite(root)) {
-            throw std::runtime_error("Got not finite value, calculating the root of the linear equation "
-                                     + std::to_string(a) + " * x + " + std::to_string(b) + "in file: " + __FILE__);
+        if (!solver_math::isfinite(root)) {
+            root = std::numeric_limits<T>::quiet_NaN();
+            return SOLVER_OVERFLOW;
         }
-        return 1;
+        nroots = 1;
     }
+    return SOLVER_OK;
 }
 
 
 /* See description in quadratic_equation_solver.h */
 
-double calculate_discriminant(double a, double b, double c)
+template<typename T>
+int solve_linear_equation(coefficient<T> a, coefficient<T> b, T &root)
 {
-    assert(std::isfinite(a));
-    assert(std::isfinite(b));
-    assert(std::isfinite(c));
+    assert(solver_math::isfinite(a));
+    assert(solver_math::isfinite(b));
 
-    double discriminant = b * b - 4 * a * c;
-    if (!std::isfinite(discriminant)) {
-        throw std::runtime_error("Got not finite value, calculating the discriminant of the quadratic equation "
-                                 + std::to_string(a) + " * x^2 + " + std::to_string(b) + " * x + " +
-                                 std::to_string(c) + "in file: " + __FILE__);
+    int nroots = 0;
+    if (try_solve_linear_equation<T>(a, b, nroots, root) != SOLVER_OK) {
+        throw_not_finite("the root", a, b);
+    }
+    return nroots;
+}
+
+
+/* See description in quadratic_equation_solver.h */
+
+template<typename T>
+solver_status try_calculate_discriminant(coefficient<T> a, coefficient<T> b, coefficient<T> c, T &discriminant) noexcept
+{
+    discriminant = std::numeric_limits<T>::quiet_NaN();
+    if (!solver_math::isfinite(a) || !solver_math::isfinite(b) || !solver_math::isfinite(c)) {
+        return SOLVER_NOT_FINITE_INPUT;
+    }
+
+    discriminant = b * b - 4 * a * c;
+    if (!solver_math::isfinite(discriminant)) {
+        discriminant = std::numeric_limits<T>::quiet_NaN();
+        return SOLVER_OVERFLOW;
+    }
+    return SOLVER_OK;
+}
+
+
+/* See description in quadratic_equation_solver.h */
+
+template<typename T>
+T calculate_discriminant(coefficient<T> a, coefficient<T> b, coefficient<T> c)
+{
+    assert(solver_math::isfinite(a));
+    assert(solver_math::isfinite(b));
+    assert(solver_math::isfinite(c));
+
+    T discriminant = 0;
+    if (try_calculate_discriminant<T>(a, b, c, discriminant) != SOLVER_OK) {
+        quadratic_details::throw_not_finite("the discriminant", a, b, c);
     }
     return discriminant;
 }
@@ -89,8 +428,34 @@ double calculate_discriminant(double a, double b, double c)
 
 /* See description in quadratic_equation_solver.h */
 
-bool is_zero(double num)
+template<typename T>
+bool is_zero(coefficient<T> num)
 {
-    assert(std::isfinite(num));
-    return std::fabs(num) < EPS;
+    assert(solver_math::isfinite(num));
+    return solver_math::fabs(num) < solver_traits<T>::eps;
 }
+
+
+#define INSTANTIATE_QUADRATIC_SOLVER(T)                                                                                     \
+    template int solve_quadratic_equation<T>(coefficient<T>, coefficient<T>, coefficient<T>, T &, T &);                    \
+    template solver_status try_solve_quadratic_equation<T>(coefficient<T>, coefficient<T>, coefficient<T>,                 \
+                                                           int &, T &, T &) noexcept;                                      \
+    template int solve_quadratic_equation<T>(coefficient<T>, coefficient<T>, coefficient<T>,                               \
+                                             std::complex<T> &, std::complex<T> &);                                        \
+    template solver_status try_solve_quadratic_equation_complex<T>(coefficient<T>, coefficient<T>, coefficient<T>,         \
+                                                                   int &, T &, T &, T &) noexcept;                         \
+    template int solve_quadratic_equation_stable<T>(coefficient<T>, coefficient<T>, coefficient<T>, T &, T &);             \
+    template solver_status try_solve_quadratic_equation_stable<T>(coefficient<T>, coefficient<T>, coefficient<T>,          \
+                                                                  int &, T &, T &) noexcept;                               \
+    template int solve_linear_equation<T>(coefficient<T>, coefficient<T>, T &);                                            \
+    template solver_status try_solve_linear_equation<T>(coefficient<T>, coefficient<T>, int &, T &) noexcept;              \
+    template T calculate_discriminant<T>(coefficient<T>, coefficient<T>, coefficient<T>);                                  \
+    template solver_status try_calculate_discriminant<T>(coefficient<T>, coefficient<T>, coefficient<T>, T &) noexcept;    \
+    template bool is_zero<T>(coefficient<T>);
+
+INSTANTIATE_QUADRATIC_SOLVER(float)
+INSTANTIATE_QUADRATIC_SOLVER(double)
+INSTANTIATE_QUADRATIC_SOLVER(long double)
+#ifdef __SIZEOF_FLOAT128__
+INSTANTIATE_QUADRATIC_SOLVER(__float128)
+#endif
@@ -1,9 +1,89 @@
 #ifndef __QUADRATIC_EQUATION_SOLVER_HEADER
 #define __QUADRATIC_EQUATION_SOLVER_HEADER
 
+#include <cassert>
+#include <cfloat>
+#include <complex>
+#include <cstddef>
+#include <limits>
+
 constexpr int INF_ROOTS = -1;
 constexpr double EPS = 1e-5;
 
+///-------------------------------------------------------------------------------------
+//! Properties of the scalar type @c T the solvers are instantiated for
+//! (float, double, long double and __float128 if the compiler supports it)
+//!
+//! @c eps is the precision of the comparison to zero (see @c is_zero).
+//!
+///-------------------------------------------------------------------------------------
+template<typename T>
+struct solver_traits;
+
+template<>
+struct solver_traits<float>
+{
+    static constexpr float eps = 1e-5f;
+};
+
+template<>
+struct solver_traits<double>
+{
+    static constexpr double eps = EPS;
+};
+
+template<>
+struct solver_traits<long double>
+{
+    static constexpr long double eps = 1e-5L;
+};
+
+#ifdef __SIZEOF_FLOAT128__
+template<>
+struct solver_traits<__float128>
+{
+    static constexpr __float128 eps = 1e-5L;
+};
+#endif
+
+namespace quadratic_details
+{
+    template<typename T>
+    struct identity
+    {
+        typedef T type;
+    };
+
+///-------------------------------------------------------------------------------------
+//! Throws std::runtime_error about not finite value got while solving the quadratic equation,
+//! with the same message for every solver. Kept out of line, so that the solvers themselves
+//! contain no string building.
+//!
+//! @param [in] what  What was being calculated, e.g. "the root"
+//! @param [in] a     The quadratic coefficient
+//! @param [in] b     The linear coefficient
+//! @param [in] c     The constant
+//!
+///-------------------------------------------------------------------------------------
+    [[noreturn]] void throw_not_finite(const char *what, long double a, long double b, long double c);
+}
+
+///-------------------------------------------------------------------------------------
+//! Type of the coefficients of the solvers for the scalar type @c T.
+//! @c T is not deduced from the coefficients, but from the roots, so
+//! @c solve_quadratic_equation(1, -5, 6, x1, x2) uses the type of @c x1 and @c x2.
+//!
+///-------------------------------------------------------------------------------------
+template<typename T>
+using coefficient = typename quadratic_details::identity<T>::type;
+
+//! Result of the solvers that do not throw exceptions (try_* functions)
+enum solver_status {
+    SOLVER_OK,               //!< Roots are calculated
+    SOLVER_OVERFLOW,         //!< Got not finite value while calculating
+    SOLVER_NOT_FINITE_INPUT  //!< One of the coefficients is not finite
+};
+
 ///-------------------------------------------------------------------------------------
 //! Solves the quadratic equation \f$ a x^2 + b x + c = 0 \f$
 //!
@@ -16,13 +96,303 @@ constexpr double EPS = 1e-5;
 //! @return Number of roots
 //!
 //! @note If the number of roots is infinite, returns @c INF_ROOTS.
+//!       @c T is float, double, long double or __float128, zero is compared with @c solver_traits<T>::eps.
 //!       If the function returns 1, the root is written in @c first_root.
 //!       If the function returns 2, @c first_root is calculated by the formula \f$ \frac{-b + \sqrt{D}}{2a} \f$,
 //!       @c second_root is calculated by formula \f$ \frac{-b + \sqrt{D}}{2a} \f$, where D is the discriminant.
 //!
 ///-------------------------------------------------------------------------------------
 
-int solve_quadratic_equation(double a, double b, double c, double &first_root, double &second_root);
+template<typename T>
+int solve_quadratic_equation(coefficient<T> a, coefficient<T> b, coefficient<T> c, T &first_root, T &second_root);
+
+
+///-------------------------------------------------------------------------------------
+//! Solves the quadratic equation \f$ a x^2 + b x + c = 0 \f$ without asserting or throwing exceptions
+//!
+//! @param [in]  a   The quadratic coefficient (coefficient a)
+//! @param [in]  b   The linear coefficient    (coefficient b)
+//! @param [in]  c   The constant              (coefficient c)
+//! @param [out] nroots       Reference to the number of roots
+//! @param [out] first_root   Reference to the first root
+//! @param [out] second_root  Reference to the second root
+//!
+//! @return @c SOLVER_OK if the roots are calculated, @c SOLVER_OVERFLOW if @c solve_quadratic_equation
+//!         would throw an exception, @c SOLVER_NOT_FINITE_INPUT if it would fail an assertion
+//!
+//! @note If the status is @c SOLVER_OK, writes the same as @c solve_quadratic_equation (@c nroots gets its return value).
+//!       Otherwise @c nroots is 0, roots are @c NAN.
+//!
+///-------------------------------------------------------------------------------------
+
+template<typename T>
+solver_status try_solve_quadratic_equation(coefficient<T> a, coefficient<T> b, coefficient<T> c,
+                                           int &nroots, T &first_root, T &second_root) noexcept;
+
+
+///-------------------------------------------------------------------------------------
+//! Solves the quadratic equation \f$ a x^2 + b x + c = 0 \f$ including complex roots
+//!
+//! @param [in]  a   The quadratic coefficient (coefficient a)
+//! @param [in]  b   The linear coefficient    (coefficient b)
+//! @param [in]  c   The constant              (coefficient c)
+//! @param [out] first_root  Reference to the first root
+//! @param [out] second_root  Reference to the second root
+//!
+//! @return Number of roots
+//!
+//! @note Works like @c solve_quadratic_equation with real roots, but if the discriminant is negative,
+//!       returns 2 and writes the complex conjugate roots \f$ \frac{-b \pm i \sqrt{-D}}{2a} \f$
+//!       (plus to @c first_root). Otherwise imaginary parts of the roots are 0.
+//!
+///-------------------------------------------------------------------------------------
+
+template<typename T>
+int solve_quadratic_equation(coefficient<T> a, coefficient<T> b, coefficient<T> c,
+                             std::complex<T> &first_root, std::complex<T> &second_root);
+
+
+///-------------------------------------------------------------------------------------
+//! Solves the quadratic equation including complex roots without asserting or throwing exceptions
+//!
+//! @param [in]  a   The quadratic coefficient (coefficient a)
+//! @param [in]  b   The linear coefficient    (coefficient b)
+//! @param [in]  c   The constant              (coefficient c)
+//! @param [out] nroots          Reference to the number of roots
+//! @param [out] first_root      Reference to the (real part of the) first root
+//! @param [out] second_root     Reference to the (real part of the) second root
+//! @param [out] imaginary_part  Reference to the imaginary part of the first root
+//!
+//! @return Status, see @c try_solve_quadratic_equation
+//!
+//! @note Writes the same as @c try_solve_quadratic_equation, but if the discriminant is negative, @c nroots is 2,
+//!       both real parts are \f$ \frac{-b}{2a} \f$ and @c imaginary_part is \f$ \frac{\sqrt{-D}}{2a} \f$
+//!       (the second root is conjugate to the first one). Otherwise @c imaginary_part is 0.
+//!
+///-------------------------------------------------------------------------------------
+
+template<typename T>
+solver_status try_solve_quadratic_equation_complex(coefficient<T> a, coefficient<T> b, coefficient<T> c,
+                                                   int &nroots, T &first_root, T &second_root, T &imaginary_part) noexcept;
+
+
+///-------------------------------------------------------------------------------------
+//! Solves the quadratic equation \f$ a x^2 + b x + c = 0 \f$ with formulas that do not lose precision
+//!
+//! @param [in]  a   The quadratic coefficient (coefficient a)
+//! @param [in]  b   The linear coefficient    (coefficient b)
+//! @param [in]  c   The constant              (coefficient c)
+//! @param [out] first_root  Reference to the first root
+//! @param [out] second_root  Reference to the second root
+//!
+//! @return Number of roots
+//!
+//! @note Works like @c solve_quadratic_equation (the roots are in the same order), but if |b| is much
+//!       greater than |a * c|, the root closer to zero is not calculated as a difference of close numbers.
+//!       If the function returns 2, the roots are \f$ \frac{q}{a} \f$ and \f$ \frac{c}{q} \f$,
+//!       where \f$ q = -\frac{b + sign(b) \sqrt{D}}{2} \f$.
+//!       The number of roots is the same as in @c solve_quadratic_equation. If there are 2 roots and
+//!       b * b is close to 4 * a * c, the rounding errors of both products are added to the discriminant
+//!       before the square root (with fused multiply-add if ARCH enables it, for example ARCH=-mfma,
+//!       or with Dekker's product otherwise), so close roots are not lost in the cancellation.
+//!       For float the discriminant is calculated in double, long double and __float128 are not corrected.
+//!
+///-------------------------------------------------------------------------------------
+
+template<typename T>
+int solve_quadratic_equation_stable(coefficient<T> a, coefficient<T> b, coefficient<T> c, T &first_root, T &second_root);
+
+
+///-------------------------------------------------------------------------------------
+//! Solves the quadratic equation like @c solve_quadratic_equation_stable, but without asserting or throwing exceptions
+//!
+//! @param [in]  a   The quadratic coefficient (coefficient a)
+//! @param [in]  b   The linear coefficient    (coefficient b)
+//! @param [in]  c   The constant              (coefficient c)
+//! @param [out] nroots       Reference to the number of roots
+//! @param [out] first_root   Reference to the first root
+//! @param [out] second_root  Reference to the second root
+//!
+//! @return Status, see @c try_solve_quadratic_equation
+//!
+///-------------------------------------------------------------------------------------
+
+template<typename T>
+solver_status try_solve_quadratic_equation_stable(coefficient<T> a, coefficient<T> b, coefficient<T> c,
+                                                  int &nroots, T &first_root, T &second_root) noexcept;
+
+
+///-------------------------------------------------------------------------------------
+//! Solves @c n quadratic equations \f$ a_i x^2 + b_i x + c_i = 0 \f$ given as separate coefficient arrays
+//!
+//! @param [in]  a             Array of the quadratic coefficients
+//! @param [in]  b             Array of the linear coefficients
+//! @param [in]  c             Array of the constants
+//! @param [in]  n             Number of equations (size of every array)
+//! @param [out] nroots        Array where to write the number of roots of each equation
+//! @param [out] first_roots   Array where to write the first root of each equation
+//! @param [out] second_roots  Array where to write the second root of each equation
+//!
+//! @note For every i writes exactly what @c solve_quadratic_equation(a[i], b[i], c[i], first_roots[i], second_roots[i])
+//!       would write and returns, including @c NAN in unused roots.
+//!       Equations are solved several at a time with SSE2, AVX or AVX-512 instructions (whichever the
+//!       compiler is allowed to use), a register holds twice as many floats as doubles.
+//!       Equations of long double and __float128 are solved one at a time. Lanes that would assert or throw are solved again with
+//!       @c solve_quadratic_equation, so assertions and exceptions are the same as in a loop of scalar calls.
+//!
+///-------------------------------------------------------------------------------------
+
+template<typename T>
+void solve_quadratic_equations(const T *a, const T *b, const T *c, size_t n,
+                               int *nroots, T *first_roots, T *second_roots);
+
+
+///-------------------------------------------------------------------------------------
+//! Solves @c n quadratic equations like @c solve_quadratic_equations, but without asserting or throwing exceptions
+//!
+//! @param [in]  a             Array of the quadratic coefficients
+//! @param [in]  b             Array of the linear coefficients
+//! @param [in]  c             Array of the constants
+//! @param [in]  n             Number of equations (size of every array)
+//! @param [out] nroots        Array where to write the number of roots of each equation
+//! @param [out] first_roots   Array where to write the first root of each equation
+//! @param [out] second_roots  Array where to write the second root of each equation
+//! @param [out] statuses      Array where to write the status of each equation
+//!
+//! @note For every i writes exactly what @c try_solve_quadratic_equation(a[i], b[i], c[i], nroots[i], first_roots[i], second_roots[i])
+//!       would write and puts its return value to @c statuses[i].
+//!
+///-------------------------------------------------------------------------------------
+
+template<typename T>
+void try_solve_quadratic_equations(const T *a, const T *b, const T *c, size_t n,
+                                   int *nroots, T *first_roots, T *second_roots,
+                                   solver_status *statuses) noexcept;
+
+
+///-------------------------------------------------------------------------------------
+//! Solves @c n quadratic equations like @c solve_quadratic_equations, including complex roots
+//!
+//! @param [in]  a                Array of the quadratic coefficients
+//! @param [in]  b                Array of the linear coefficients
+//! @param [in]  c                Array of the constants
+//! @param [in]  n                Number of equations (size of every array)
+//! @param [out] nroots           Array where to write the number of roots of each equation
+//! @param [out] first_roots      Array where to write the (real part of the) first root of each equation
+//! @param [out] second_roots     Array where to write the (real part of the) second root of each equation
+//! @param [out] imaginary_parts  Array where to write the imaginary part of the first root of each equation
+//!
+//! @note For every i writes exactly what @c try_solve_quadratic_equation_complex writes, so complex roots are
+//!       calculated in the same pass over the coefficients. Lanes that would assert or throw are solved again with
+//!       @c solve_quadratic_equation, as in @c solve_quadratic_equations.
+//!
+///-------------------------------------------------------------------------------------
+
+template<typename T>
+void solve_quadratic_equations_complex(const T *a, const T *b, const T *c, size_t n,
+                                       int *nroots, T *first_roots, T *second_roots, T *imaginary_parts);
+
+
+///-------------------------------------------------------------------------------------
+//! Solves @c n quadratic equations like @c solve_quadratic_equations_complex, but without asserting or throwing exceptions
+//!
+//! @param [in]  a                Array of the quadratic coefficients
+//! @param [in]  b                Array of the linear coefficients
+//! @param [in]  c                Array of the constants
+//! @param [in]  n                Number of equations (size of every array)
+//! @param [out] nroots           Array where to write the number of roots of each equation
+//! @param [out] first_roots      Array where to write the (real part of the) first root of each equation
+//! @param [out] second_roots     Array where to write the (real part of the) second root of each equation
+//! @param [out] imaginary_parts  Array where to write the imaginary part of the first root of each equation
+//! @param [out] statuses         Array where to write the status of each equation
+//!
+///-------------------------------------------------------------------------------------
+
+template<typename T>
+void try_solve_quadratic_equations_complex(const T *a, const T *b, const T *c, size_t n,
+                                           int *nroots, T *first_roots, T *second_roots, T *imaginary_parts,
+                                           solver_status *statuses) noexcept;
+
+
+//! Interval [lo, hi] that certainly contains a root (see @c solve_quadratic_equation_certified)
+template<typename T>
+struct root_enclosure
+{
+    T lo;
+    T hi;
+};
+
+///-------------------------------------------------------------------------------------
+//! Solves the quadratic equation \f$ a x^2 + b x + c = 0 \f$ and bounds the roots with intervals
+//!
+//! @param [in]  a   The quadratic coefficient (coefficient a)
+//! @param [in]  b   The linear coefficient    (coefficient b)
+//! @param [in]  c   The constant              (coefficient c)
+//! @param [out] first_root   Reference to the enclosure of the first root
+//! @param [out] second_root  Reference to the enclosure of the second root
+//!
+//! @return Number of roots, the same as @c solve_quadratic_equation returns
+//!
+//! @note @c T is float, double or long double. The roots are calculated with interval arithmetic in one pass:
+//!       the result of every operation is rounded to nearest and moved outward by one ulp, so the exact roots
+//!       of the equation with the given coefficients are between @c lo and @c hi despite all rounding errors.
+//!       If there are 2 roots, they are in the same order as in @c solve_quadratic_equation and their
+//!       enclosures are calculated with the formulas of @c solve_quadratic_equation_stable, so they are
+//!       several ulps wide even if |b| is much greater than |a * c|. If the discriminant is so close to zero,
+//!       that its sign is not certain, the square root of it is bounded by \f$ [0, \sqrt{D_{hi}}] \f$.
+//!       If there is 1 root, its enclosure contains \f$ \frac{-b}{2a} \f$ and all real roots of the equation.
+//!       Bounds of unused enclosures are @c NAN. Throws std::runtime_error if a bound is not finite.
+//!
+///-------------------------------------------------------------------------------------
+
+template<typename T>
+int solve_quadratic_equation_certified(coefficient<T> a, coefficient<T> b, coefficient<T> c,
+                                       root_enclosure<T> &first_root, root_enclosure<T> &second_root);
+
+
+///-------------------------------------------------------------------------------------
+//! Bounds the roots like @c solve_quadratic_equation_certified, but without asserting or throwing exceptions
+//!
+//! @param [in]  a   The quadratic coefficient (coefficient a)
+//! @param [in]  b   The linear coefficient    (coefficient b)
+//! @param [in]  c   The constant              (coefficient c)
+//! @param [out] nroots       Reference to the number of roots
+//! @param [out] first_root   Reference to the enclosure of the first root
+//! @param [out] second_root  Reference to the enclosure of the second root
+//!
+//! @return Status, see @c try_solve_quadratic_equation (@c SOLVER_OVERFLOW if a bound is not finite)
+//!
+//! @note If the status is not @c SOLVER_OK, @c nroots is 0, bounds are @c NAN.
+//!
+///-------------------------------------------------------------------------------------
+
+template<typename T>
+solver_status try_solve_quadratic_equation_certified(coefficient<T> a, coefficient<T> b, coefficient<T> c, int &nroots,
+                                                     root_enclosure<T> &first_root, root_enclosure<T> &second_root) noexcept;
+
+
+///-------------------------------------------------------------------------------------
+//! Bounds the roots of @c n quadratic equations like @c solve_quadratic_equation_certified
+//!
+//! @param [in]  a          Array of the quadratic coefficients
+//! @param [in]  b          Array of the linear coefficients
+//! @param [in]  c          Array of the constants
+//! @param [in]  n          Number of equations (size of every array)
+//! @param [out] nroots     Array where to write the number of roots of each equation
+//! @param [out] first_lo   Array where to write the lower bound of the first root of each equation
+//! @param [out] first_hi   Array where to write the upper bound of the first root of each equation
+//! @param [out] second_lo  Array where to write the lower bound of the second root of each equation
+//! @param [out] second_hi  Array where to write the upper bound of the second root of each equation
+//!
+//! @note For every i writes exactly what @c solve_quadratic_equation_certified(a[i], b[i], c[i], ...) would write.
+//!       Equations are bounded several at a time with SIMD instructions, like in @c solve_quadratic_equations.
+//!       Lanes that would assert or throw are solved again with @c solve_quadratic_equation_certified.
+//!
+///-------------------------------------------------------------------------------------
+
+template<typename T>
+void solve_quadratic_equations_certified(const T *a, const T *b, const T *c, size_t n, int *nroots,
+                                         T *first_lo, T *first_hi, T *second_lo, T *second_hi);
 
 
 ///-------------------------------------------------------------------------------------
@@ -38,11 +408,33 @@ int solve_quadratic_equation(double a, double b, double c, double &first_root, d
 //!
 ///-------------------------------------------------------------------------------------
 
-int solve_linear_equation(double a, double b, double &root);
+template<typename T>
+int solve_linear_equation(coefficient<T> a, coefficient<T> b, T &root);
+
+
+///-------------------------------------------------------------------------------------
+//! Solves the linear equation \f$ a x + b = 0 \f$ without asserting or throwing exceptions
+//!
+//! @param [in]  a   The linear coefficient (coefficient a)
+//! @param [in]  b   The constant           (coefficient b)
+//! @param [out] nroots Reference to the number of roots
+//! @param [out] root   Reference to the root
+//!
+//! @return Status, see @c try_solve_quadratic_equation
+//!
+//! @note If the status is @c SOLVER_OK, writes the same as @c solve_linear_equation (@c nroots gets its return value).
+//!       Otherwise @c nroots is 0, @c root is @c NAN.
+//!
+///-------------------------------------------------------------------------------------
+
+template<typename T>
+solver_status try_solve_linear_equation(coefficient<T> a, coefficient<T> b, int &nroots, T &root) noexcept;
 
 ///-------------------------------------------------------------------------------------
 //! Calculates the discriminant of the quadratic equation \f$ a x^2 + b x + c = 0 \f$
 //!
+//! @note Calculates in double unless @c T is specified explicitly (calculate_discriminant<float>(a, b, c)).
+//!
 //! @param [in]  a   The quadratic coefficient (coefficient a)
 //! @param [in]  b   The linear coefficient    (coefficient b)
 //! @param [in]  c   The constant              (coefficient c)
@@ -51,20 +443,200 @@ int solve_linear_equation(double a, double b, double &root);
 //!
 ///-------------------------------------------------------------------------------------
 
-double calculate_discriminant(double a, double b, double c);
+template<typename T = double>
+T calculate_discriminant(coefficient<T> a, coefficient<T> b, coefficient<T> c);
+
+
+///-------------------------------------------------------------------------------------
+//! Calculates the discriminant of the quadratic equation \f$ a x^2 + b x + c = 0 \f$ without asserting or throwing exceptions
+//!
+//! @param [in]  a   The quadratic coefficient (coefficient a)
+//! @param [in]  b   The linear coefficient    (coefficient b)
+//! @param [in]  c   The constant              (coefficient c)
+//! @param [out] discriminant Reference to the discriminant (@c NAN if the status is not @c SOLVER_OK)
+//!
+//! @return Status, see @c try_solve_quadratic_equation
+//!
+///-------------------------------------------------------------------------------------
+
+template<typename T>
+solver_status try_calculate_discriminant(coefficient<T> a, coefficient<T> b, coefficient<T> c, T &discriminant) noexcept;
 
 
 ///-------------------------------------------------------------------------------------
-//! Comparing double to zero
+//! Comparing number to zero
 //!
-//! @param [in] num The double number
+//! @param [in] num The number
 //!
 //! @return True if @c num is close to zero, false otherwise
 //!
-//! @note @c num is considered close to zero, if its absolute value is less than @c EPS.
+//! @note @c num is considered close to zero, if its absolute value is less than @c solver_traits<T>::eps.
+//!
+///-------------------------------------------------------------------------------------
+
+template<typename T = double>
+bool is_zero(coefficient<T> num);
+
+
+//! Roots of the quadratic equation, returned by the constexpr version of @c solve_quadratic_equation
+struct quadratic_roots
+{
+    int nroots;          //!< Number of roots (@c INF_ROOTS if infinite)
+    double first_root;   //!< The first root or @c NAN
+    double second_root;  //!< The second root or @c NAN
+};
+
+namespace quadratic_details
+{
+    constexpr double constexpr_fabs(double num)
+    {
+        return (num < 0 ? -num : num);
+    }
+
+    constexpr bool constexpr_isfinite(double num)
+    {
+        return constexpr_fabs(num) <= DBL_MAX; // false for NAN
+    }
+
+///-------------------------------------------------------------------------------------
+//! Calculates the square root with Newton's method, so that it can be calculated at compile time
+//!
+//! @param [in] num  Not negative finite number
+//!
+//! @return The square root of @c num correctly rounded (the same as std::sqrt)
+//!
+//! @note Scales @c num by powers of 4 to [1, 4), iterates to the nearest double and then
+//!       chooses between it and the next double comparing @c num with the exact square of their midpoint.
+//!
+///-------------------------------------------------------------------------------------
+    constexpr double newton_sqrt(double num)
+    {
+        assert(num >= 0 && constexpr_isfinite(num));
+        if (!(num > 0)) {
+            return num; // +0 or -0
+        }
+
+        double scale = 1; // sqrt(num) = sqrt(scaled) * scale
+        double scaled = num;
+        while (scaled >= 4) {
+            scaled *= 0.25;
+            scale *= 2;
+        }
+        while (scaled < 1) {
+            scaled *= 4;
+            scale *= 0.5;
+        }
+
+        double root = 1.5, prev_root = 0;
+        for (int i = 0; i < 100 && constexpr_fabs(root - prev_root) > 0; i++) {
+            prev_root = root;
+            root = 0.5 * (root + scaled / root);
+        }
+
+        /* root is within one ulp (2^-52 in [1, 2)) of the answer; step down so that the answer is root or root + ulp */
+        const double ulp = DBL_EPSILON;
+        root = (root - ulp >= 1 ? root - ulp : 1);
+        for (int i = 0; i < 2; i++) {
+            /* (root + ulp / 2)^2 = root^2 + root * ulp + ulp^2 / 4, excess = num - root^2 - root * ulp */
+#if defined(__GNUC__) && !defined(__clang__) && defined(__FP_FAST_FMA)
+            /* GCC contracts the products of Dekker's algorithm to fused multiply-add, which makes it inexact,
+               but fused multiply-add itself gives num - root^2 exactly */
+            double excess = __builtin_fma(-root, root, scaled) - root * ulp;
+#else
+            /* exact square of root: root_square + root_square_error (Dekker's product) */
+            double split = root * 134217729.0; // 2^27 + 1
+            double root_high = split - (split - root);
+            double root_low = root - root_high;
+            double root_square = root * root;
+            double root_square_error = ((root_high * root_high - root_square) + 2 * root_high * root_low) + root_low * root_low;
+            double excess = ((scaled - root_square) - root * ulp) - root_square_error;
+#endif
+            if (excess > ulp * ulp / 4) {
+                root += ulp;
+            } else {
+                break;
+            }
+        }
+        return root * scale;
+    }
+
+///-------------------------------------------------------------------------------------
+//! Square root, that can be calculated at compile time
+//!
+//! @note GCC can calculate @c __builtin_sqrt at compile time and uses the sqrt instruction at run time,
+//!       other compilers use @c newton_sqrt.
+//!
+///-------------------------------------------------------------------------------------
+    constexpr double constexpr_sqrt(double num)
+    {
+#if defined(__GNUC__) && !defined(__clang__)
+        return __builtin_sqrt(num);
+#else
+        return newton_sqrt(num);
+#endif
+    }
+
+/*
+Is called if the constexpr solver gets not finite value: solves the equation again
+with the out-of-line solver, which throws the exception. At compile time this is a
+compilation error.
+*/
+    inline quadratic_roots solve_at_runtime(double a, double b, double c)
+    {
+        quadratic_roots roots = {};
+        roots.nroots = solve_quadratic_equation(a, b, c, roots.first_root, roots.second_root);
+        return roots;
+    }
+}
+
+///-------------------------------------------------------------------------------------
+//! Solves the quadratic equation \f$ a x^2 + b x + c = 0 \f$, can be calculated at compile time
+//!
+//! @param [in]  a   The quadratic coefficient (coefficient a)
+//! @param [in]  b   The linear coefficient    (coefficient b)
+//! @param [in]  c   The constant              (coefficient c)
+//!
+//! @return Number of roots and the roots, exactly the same as @c solve_quadratic_equation(a, b, c, first_root, second_root) writes
+//!
+//! @note If the coefficients are constant expressions, the result is a constant expression, for example
+//!       @code static_assert(solve_quadratic_equation(1, -5, 6).nroots == 2); @endcode
+//!       If the calculation at compile time gets not finite value, the program does not compile.
 //!
 ///-------------------------------------------------------------------------------------
 
-bool is_zero(double num);
+constexpr quadratic_roots solve_quadratic_equation(double a, double b, double c)
+{
+    using namespace quadratic_details;
+    assert(constexpr_isfinite(a));
+    assert(constexpr_isfinite(b));
+    assert(constexpr_isfinite(c));
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+
+    if (constexpr_fabs(a) < EPS) {
+        if (constexpr_fabs(b) < EPS) {
+            return {(constexpr_fabs(c) < EPS ? INF_ROOTS : 0), nan, nan};
+        }
+        double root = - c / b;
+        return (constexpr_isfinite(root) ? quadratic_roots{1, root, nan} : solve_at_runtime(a, b, c));
+    }
+
+    double discriminant = b * b - 4 * a * c;
+    if (!constexpr_isfinite(discriminant)) {
+        return solve_at_runtime(a, b, c);
+    }
+    if (constexpr_fabs(discriminant) < EPS) {
+        double root = -b / (2 * a);
+        return (constexpr_isfinite(root) ? quadratic_roots{1, root, nan} : solve_at_runtime(a, b, c));
+    }
+    if (discriminant < 0) {
+        return {0, nan, nan};
+    }
+    double first_root = (-b + constexpr_sqrt(discriminant)) / (2 * a);
+    double second_root = (-b - constexpr_sqrt(discriminant)) / (2 * a);
+    if (!constexpr_isfinite(first_root) || !constexpr_isfinite(second_root)) {
+        return solve_at_runtime(a, b, c);
+    }
+    return {2, first_root, second_root};
+}
 
 #endif
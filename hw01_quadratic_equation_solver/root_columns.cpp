@@ -0,0 +1,158 @@
+#include "root_columns.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace root_columns_details
+{
+    const char MAGIC[8] = "QEROOTS";
+
+    inline uint64_t align(uint64_t offset)
+    {
+        return (offset + ROOT_COLUMNS_ALIGNMENT - 1) / ROOT_COLUMNS_ALIGNMENT * ROOT_COLUMNS_ALIGNMENT;
+    }
+
+    inline uint64_t bitmap_bytes(uint64_t count)
+    {
+        return (count + 63) / 64 * sizeof(uint64_t);
+    }
+
+/*
+Places the columns one after another, returns the header and the size of the file in file_size
+*/
+    root_columns_header layout(uint64_t count, bool validity, uint64_t &file_size)
+    {
+        root_columns_header header = {};
+        memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.byte_order = ROOT_COLUMNS_BYTE_ORDER;
+        header.version = ROOT_COLUMNS_VERSION;
+        header.flags = (validity ? ROOT_COLUMNS_VALIDITY : 0);
+        header.count = count;
+        header.nroots_offset = align(sizeof(root_columns_header));
+        header.status_offset = align(header.nroots_offset + count);
+        header.first_root_offset = align(header.status_offset + count);
+        header.second_root_offset = align(header.first_root_offset + count * sizeof(double));
+        file_size = align(header.second_root_offset + count * sizeof(double));
+        if (validity) {
+            header.first_valid_offset = file_size;
+            header.second_valid_offset = align(header.first_valid_offset + bitmap_bytes(count));
+            file_size = align(header.second_valid_offset + bitmap_bytes(count));
+        }
+        return header;
+    }
+
+    uint64_t file_size(uint64_t count, bool validity)
+    {
+        uint64_t size = 0;
+        layout(count, validity, size);
+        return size;
+    }
+
+/*
+Returns true if the aligned column of count elements of element_size bytes at offset fits into the file
+*/
+    bool column_fits(uint64_t offset, uint64_t count, uint64_t element_size, uint64_t file_size)
+    {
+        return offset >= sizeof(root_columns_header) && offset % ROOT_COLUMNS_ALIGNMENT == 0 && offset <= file_size &&
+               count <= (file_size - offset) / element_size;
+    }
+
+/*
+Writes bits [begin, begin + n) of the bitmap, bit i is set if values[i - begin] is a number.
+The other bits of the first and the last word are kept.
+*/
+    void write_validity(uint64_t *bitmap, uint64_t begin, size_t n, const double *values)
+    {
+        for (size_t i = 0; i < n; ) {
+            uint64_t index = begin + i;
+            unsigned shift = (unsigned)(index % 64);
+            size_t size = (n - i < 64 - shift ? n - i : 64 - shift);
+            uint64_t mask = (size == 64 ? ~(uint64_t)0 : (((uint64_t)1 << size) - 1) << shift);
+            uint64_t word = 0;
+            for (size_t j = 0; j < size; j++) {
+                word |= (uint64_t)!std::isnan(values[i + j]) << (shift + j);
+            }
+            bitmap[index / 64] = (bitmap[index / 64] & ~mask) | word;
+            i += size;
+        }
+    }
+}
+
+
+/* See description in root_columns.h */
+
+root_columns::root_columns(const char *path) :
+    file_(path),
+    writable_(false)
+{
+    using namespace root_columns_details;
+
+    const std::string where = (std::string)"root_columns: " + path;
+    if (file_.size() < sizeof(root_columns_header)) {
+        throw std::invalid_argument(where + " is too small for the header");
+    }
+    const root_columns_header &h = header();
+    if (memcmp(h.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::invalid_argument(where + " is not a root columns file");
+    }
+    if (h.byte_order != ROOT_COLUMNS_BYTE_ORDER) {
+        throw std::invalid_argument(where + " is written with another byte order");
+    }
+    if (h.version != ROOT_COLUMNS_VERSION || (h.flags & ~ROOT_COLUMNS_VALIDITY) != 0) {
+        throw std::invalid_argument(where + " has unsupported version " + std::to_string(h.version) +
+                                    " or flags " + std::to_string(h.flags));
+    }
+    bool fits = column_fits(h.nroots_offset, h.count, sizeof(int8_t), file_.size()) &&
+                column_fits(h.status_offset, h.count, sizeof(uint8_t), file_.size()) &&
+                column_fits(h.first_root_offset, h.count, sizeof(double), file_.size()) &&
+                column_fits(h.second_root_offset, h.count, sizeof(double), file_.size());
+    if (has_validity()) {
+        fits = fits && column_fits(h.first_valid_offset, (h.count + 63) / 64, sizeof(uint64_t), file_.size()) &&
+                       column_fits(h.second_valid_offset, (h.count + 63) / 64, sizeof(uint64_t), file_.size());
+    } else {
+        fits = fits && h.first_valid_offset == 0 && h.second_valid_offset == 0;
+    }
+    if (!fits) {
+        throw std::invalid_argument(where + " has columns outside of the file");
+    }
+}
+
+
+/* See description in root_columns.h */
+
+root_columns::root_columns(const char *path, uint64_t count, bool validity) :
+    file_(path, root_columns_details::file_size(count, validity)),
+    writable_(true)
+{
+    uint64_t size = 0;
+    root_columns_header h = root_columns_details::layout(count, validity, size);
+    memcpy(file_.data(), &h, sizeof(h));
+}
+
+
+/* See description in root_columns.h */
+
+void root_columns::write(uint64_t begin, size_t n, const int *nroots, const double *first_roots,
+                         const double *second_roots, const solver_status *statuses)
+{
+    assert(writable_);
+    assert(begin <= size() && n <= size() - begin);
+    assert(nroots != nullptr && first_roots != nullptr && second_roots != nullptr && statuses != nullptr);
+
+    const root_columns_header &h = header();
+    int8_t *nroots_column = (int8_t *)(file_.data() + h.nroots_offset) + begin;
+    uint8_t *status_column = (uint8_t *)(file_.data() + h.status_offset) + begin;
+    for (size_t i = 0; i < n; i++) {
+        nroots_column[i] = (int8_t)(statuses[i] == SOLVER_OK ? nroots[i] : 0);
+        status_column[i] = (uint8_t)statuses[i];
+    }
+    memcpy(file_.data() + h.first_root_offset + begin * sizeof(double), first_roots, n * sizeof(double));
+    memcpy(file_.data() + h.second_root_offset + begin * sizeof(double), second_roots, n * sizeof(double));
+    if (has_validity()) {
+        root_columns_details::write_validity((uint64_t *)(file_.data() + h.first_valid_offset), begin, n, first_roots);
+        root_columns_details::write_validity((uint64_t *)(file_.data() + h.second_valid_offset), begin, n, second_roots);
+    }
+}
@@ -0,0 +1,126 @@
+#ifndef __ROOT_COLUMNS_HEADER
+#define __ROOT_COLUMNS_HEADER
+
+#include <cstddef>
+#include <cstdint>
+
+#include "mapped_file.h"
+#include "quadratic_equation_solver.h"
+
+//! Flag of root_columns_header: the file has validity bitmaps of the roots
+const uint32_t ROOT_COLUMNS_VALIDITY = 1;
+
+//! Current version of the file format
+const uint32_t ROOT_COLUMNS_VERSION = 2;
+
+//! Byte order marker of root_columns_header, read as another number on a machine with another byte order
+const uint32_t ROOT_COLUMNS_BYTE_ORDER = 0x01020304;
+
+//! Every column begins at an offset which is a multiple of this
+const uint64_t ROOT_COLUMNS_ALIGNMENT = 64;
+
+///-------------------------------------------------------------------------------------
+//! Header at the beginning of a root columns file. All numbers are in the native byte order of the machine
+//! that wrote the file, so that the columns are read in place. A machine with another byte order rejects the file
+//! by @c byte_order.
+//!
+//! @note The columns of @c count elements follow the header:
+//!       - int8_t number of roots (see @c solve_quadratic_equation, 0 if the status is not @c SOLVER_OK),
+//!       - uint8_t solver_status,
+//!       - double first roots and double second roots (@c NAN if there is no such root),
+//!       - if @c ROOT_COLUMNS_VALIDITY is set, two bitmaps of uint64_t words, where bit (i % 64)
+//!         of word (i / 64) is set if the first (second) root of the i-th equation is a number.
+//!       The offsets of absent columns are 0.
+//!
+///-------------------------------------------------------------------------------------
+struct root_columns_header
+{
+    char magic[8];                //!< "QEROOTS" and '\0'
+    uint32_t byte_order;          //!< ROOT_COLUMNS_BYTE_ORDER
+    uint32_t version;             //!< ROOT_COLUMNS_VERSION
+    uint32_t flags;               //!< ROOT_COLUMNS_VALIDITY or 0
+    uint32_t reserved;            //!< 0
+    uint64_t count;               //!< Number of equations
+    uint64_t nroots_offset;       //!< Offset of the column of the numbers of roots from the beginning of the file
+    uint64_t status_offset;       //!< Offset of the column of statuses
+    uint64_t first_root_offset;   //!< Offset of the column of first roots
+    uint64_t second_root_offset;  //!< Offset of the column of second roots
+    uint64_t first_valid_offset;  //!< Offset of the validity bitmap of first roots
+    uint64_t second_valid_offset; //!< Offset of the validity bitmap of second roots
+};
+
+
+///-------------------------------------------------------------------------------------
+//! Roots of equations stored by columns in a file mapped to memory, so the columns are
+//! read and written in place, without parsing or formatting.
+//!
+//! @note Errors in the file are reported with std::invalid_argument, input/output errors
+//!       are reported with std::runtime_error (see @c mapped_file).
+//!
+///-------------------------------------------------------------------------------------
+class root_columns
+{
+public:
+///-------------------------------------------------------------------------------------
+//! Maps the existing file for reading and checks its header
+//!
+//! @param [in] path  Path to the file
+//!
+///-------------------------------------------------------------------------------------
+    explicit root_columns(const char *path);
+
+///-------------------------------------------------------------------------------------
+//! Creates (or truncates) the file for @c count equations and maps it for writing
+//!
+//! @param [in] path      Path to the file
+//! @param [in] count     Number of equations
+//! @param [in] validity  Whether to write the validity bitmaps
+//!
+//! @attention If the file exists, it will be overwritten
+//!
+///-------------------------------------------------------------------------------------
+    root_columns(const char *path, uint64_t count, bool validity);
+
+///-------------------------------------------------------------------------------------
+//! Writes the results of @c n equations beginning from the equation @c begin
+//!
+//! @param [in] begin         Index of the first equation
+//! @param [in] n             Number of equations
+//! @param [in] nroots        Array of n numbers of roots
+//! @param [in] first_roots   Array of n first roots
+//! @param [in] second_roots  Array of n second roots
+//! @param [in] statuses      Array of n statuses
+//!
+//! @note Numbers of roots of the failed equations are written as 0.
+//!       Threads may write different ranges at the same time if the ranges begin at multiples of 64
+//!       (otherwise they can share words of the bitmaps).
+//!
+///-------------------------------------------------------------------------------------
+    void write(uint64_t begin, size_t n, const int *nroots, const double *first_roots,
+               const double *second_roots, const solver_status *statuses);
+
+    //! Number of equations
+    uint64_t size() const { return header().count; }
+
+    //! Whether the file has the validity bitmaps
+    bool has_validity() const { return (header().flags & ROOT_COLUMNS_VALIDITY) != 0; }
+
+    const root_columns_header &header() const { return *(const root_columns_header *)file_.data(); }
+
+    const int8_t *nroots() const       { return (const int8_t *)column(header().nroots_offset); }
+    const uint8_t *statuses() const    { return (const uint8_t *)column(header().status_offset); }
+    const double *first_roots() const  { return (const double *)column(header().first_root_offset); }
+    const double *second_roots() const { return (const double *)column(header().second_root_offset); }
+
+    //! Validity bitmaps, nullptr if the file has none
+    const uint64_t *first_valid() const  { return (const uint64_t *)column(header().first_valid_offset); }
+    const uint64_t *second_valid() const { return (const uint64_t *)column(header().second_valid_offset); }
+
+private:
+    const char *column(uint64_t offset) const { return (offset != 0 ? file_.data() + offset : nullptr); }
+
+    mapped_file file_;
+    bool writable_;
+};
+
+#endif
@@ -0,0 +1,431 @@
+#include "quadratic_equation_solver.h"
+#include "polynomial_equation_solver.h"
+#include "linear_system_solver.h"
+#include "perf_counters.h"
+#include "work_stealing.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <vector>
+
+/*
+Coefficients of n equations
+*/
+struct equations
+{
+    std::vector<double> a, b, c;
+};
+
+/*
+Roots written by a solver
+*/
+struct solutions
+{
+    std::vector<int> nroots;
+    std::vector<double> x1, x2;
+};
+
+/*
+Result of a measurement: the best time of several runs and the counters of that run
+*/
+struct measurement
+{
+    double ns_per_solve;
+    bool has_counters;
+    double branch_misses_per_solve;
+    double ipc;
+};
+
+typedef int (*scalar_solver)(double, double, double, double &, double &);
+
+/*
+Solves the equation in long double and rounds the roots to double: the fallback pass that solve_quadratic_equation_stable replaces
+*/
+int solve_quadratic_equation_long_double(double a, double b, double c, double &first_root, double &second_root)
+{
+    long double first = 0, second = 0;
+    int nroots = solve_quadratic_equation<long double>(a, b, c, first, second);
+    first_root = (double)first;
+    second_root = (double)second;
+    return nroots;
+}
+
+/*
+Equations with two roots and |b| much greater than |a * c| (one root is much closer to zero than the other)
+*/
+equations generate_cancelling(size_t n, std::mt19937_64 &rng)
+{
+    std::uniform_real_distribution<double> mantissa(1, 10);
+    std::uniform_int_distribution<int> exponent(3, 7);
+    std::bernoulli_distribution sign(0.5);
+    equations eq;
+    for (size_t i = 0; i < n; i++) {
+        eq.a.push_back(mantissa(rng));
+        eq.b.push_back((sign(rng) ? 1 : -1) * mantissa(rng) * std::pow(10.0, exponent(rng)));
+        eq.c.push_back((sign(rng) ? 1 : -1) * mantissa(rng));
+    }
+    return eq;
+}
+
+/*
+Kinds of equations, every kind goes through its own branch of the solver
+*/
+enum equation_kind
+{
+    TWO_ROOTS,
+    ONE_ROOT,
+    ZERO_ROOTS,
+    LINEAR,
+    DEGENERATE,
+};
+
+/*
+Appends a random equation of the given kind
+*/
+void push_equation(equations &eq, equation_kind kind, std::mt19937_64 &rng)
+{
+    std::uniform_real_distribution<double> coefficient(1, 10);
+    std::bernoulli_distribution sign(0.5);
+    double a = (sign(rng) ? 1 : -1) * coefficient(rng), b = (sign(rng) ? 1 : -1) * coefficient(rng), c = 0;
+    switch (kind) {
+    case TWO_ROOTS:
+        c = b * b / (8 * a); // discriminant is b * b / 2
+        break;
+    case ONE_ROOT:
+        c = b * b / (4 * a);
+        break;
+    case ZERO_ROOTS:
+        c = b * b / (2 * a); // discriminant is -b * b
+        break;
+    case LINEAR:
+        c = (sign(rng) ? 1 : -1) * coefficient(rng);
+        a = 0;
+        break;
+    case DEGENERATE: // 0 = 0 or c = 0 with c != 0
+        c = sign(rng) ? 0 : coefficient(rng);
+        a = b = 0;
+        break;
+    }
+    eq.a.push_back(a);
+    eq.b.push_back(b);
+    eq.c.push_back(c);
+}
+
+/*
+Equations of one kind
+*/
+equations generate_kind(equation_kind kind, size_t n, std::mt19937_64 &rng)
+{
+    equations eq;
+    for (size_t i = 0; i < n; i++) {
+        push_equation(eq, kind, rng);
+    }
+    return eq;
+}
+
+/*
+Equations of all kinds in random order, so the branch predictor can not guess the branch.
+If sorted is true, the same kinds go one after another, so the branches are predictable.
+*/
+equations generate_mixed(size_t n, bool sorted, std::mt19937_64 &rng)
+{
+    std::uniform_int_distribution<int> kind(TWO_ROOTS, DEGENERATE);
+    std::vector<int> kinds(n);
+    for (size_t i = 0; i < n; i++) {
+        kinds[i] = kind(rng);
+    }
+    if (sorted) {
+        std::sort(kinds.begin(), kinds.end());
+    }
+    equations eq;
+    for (size_t i = 0; i < n; i++) {
+        push_equation(eq, (equation_kind)kinds[i], rng);
+    }
+    return eq;
+}
+
+/*
+Returns the best of several runs of run(), nsolves is the number of equations solved by one run
+*/
+measurement measure(const std::function<void()> &run, size_t nsolves)
+{
+    const int repeats = 7;
+    perf_counters counters;
+    measurement best = {INFINITY, counters.available(), 0, 0};
+    for (int r = 0; r < repeats; r++) {
+        counters.start();
+        auto start = std::chrono::steady_clock::now();
+        run();
+        auto finish = std::chrono::steady_clock::now();
+        perf_counters::values values = counters.stop();
+        double ns = std::chrono::duration<double, std::nano>(finish - start).count() / nsolves;
+        if (ns < best.ns_per_solve) {
+            best.ns_per_solve = ns;
+            best.branch_misses_per_solve = (double)values.branch_misses / nsolves;
+            best.ipc = (values.cycles != 0 ? (double)values.instructions / values.cycles : 0);
+        }
+    }
+    return best;
+}
+
+/*
+Solves all the equations with one scalar call per equation
+*/
+void solve_scalar(scalar_solver solve, const equations &eq, solutions &x)
+{
+    for (size_t i = 0; i < eq.a.size(); i++) {
+        x.nroots[i] = solve(eq.a[i], eq.b[i], eq.c[i], x.x1[i], x.x2[i]);
+    }
+}
+
+/*
+Solves all the equations with solve_quadratic_equations, from..to at a time
+*/
+void solve_batch(const equations &eq, size_t from, size_t to, solutions &x)
+{
+    solve_quadratic_equations(eq.a.data() + from, eq.b.data() + from, eq.c.data() + from, to - from,
+                              x.nroots.data() + from, x.x1.data() + from, x.x2.data() + from);
+}
+
+/*
+Solves all the equations with solve_quadratic_equations in chunks on all hardware threads
+*/
+void solve_threaded(const equations &eq, solutions &x)
+{
+    const size_t chunk = 1 << 14;
+    size_t n = eq.a.size();
+    run_work_stealing((n + chunk - 1) / chunk, 0, [&](size_t i) {
+        solve_batch(eq, i * chunk, std::min(n, (i + 1) * chunk), x);
+    });
+}
+
+/*
+Bounds of the roots written by the certified solvers
+*/
+struct enclosures
+{
+    std::vector<int> nroots;
+    std::vector<double> first_lo, first_hi, second_lo, second_hi;
+};
+
+/*
+Bounds the roots of all the equations with one solve_quadratic_equation_certified call per equation
+*/
+void solve_certified(const equations &eq, enclosures &x)
+{
+    for (size_t i = 0; i < eq.a.size(); i++) {
+        root_enclosure<double> first = {0, 0}, second = {0, 0};
+        x.nroots[i] = solve_quadratic_equation_certified(eq.a[i], eq.b[i], eq.c[i], first, second);
+        x.first_lo[i] = first.lo;
+        x.first_hi[i] = first.hi;
+        x.second_lo[i] = second.lo;
+        x.second_hi[i] = second.hi;
+    }
+}
+
+/*
+Bounds the roots of all the equations with solve_quadratic_equations_certified
+*/
+void solve_certified_batch(const equations &eq, enclosures &x)
+{
+    solve_quadratic_equations_certified(eq.a.data(), eq.b.data(), eq.c.data(), eq.a.size(), x.nroots.data(),
+                                        x.first_lo.data(), x.first_hi.data(), x.second_lo.data(), x.second_hi.data());
+}
+
+/*
+Returns the maximum relative error of the roots compared to the roots calculated in long double
+(both roots are calculated without cancellation there), all equations must have two roots
+*/
+double max_relative_error(const equations &eq, const solutions &x)
+{
+    double max_error = 0;
+    for (size_t i = 0; i < eq.a.size(); i++) {
+        long double a = eq.a[i], b = eq.b[i], c = eq.c[i];
+        long double sqrt_d = std::sqrt(b * b - 4 * a * c);
+        long double q = -(b + (b < 0 ? -sqrt_d : sqrt_d)) / 2;
+        long double first = (b < 0 ? q / a : c / q), second = (b < 0 ? c / q : q / a);
+        max_error = std::fmax(max_error, (double)std::fabs((x.x1[i] - first) / first));
+        max_error = std::fmax(max_error, (double)std::fabs((x.x2[i] - second) / second));
+    }
+    return max_error;
+}
+
+/*
+Prints a line of results, unknown values are left empty
+*/
+void print_result(const char *solver, const char *path, const char *distribution, size_t n,
+                  const measurement &m, bool has_error, double error)
+{
+    printf("%s,%s,%s,%zu,%.3f,%.0f,", solver, path, distribution, n, m.ns_per_solve, 1e9 / m.ns_per_solve);
+    if (m.has_counters) {
+        printf("%.4f,%.3f", m.branch_misses_per_solve, m.ipc);
+    } else {
+        printf(",");
+    }
+    if (has_error) {
+        printf(",%.3g\n", error);
+    } else {
+        printf(",\n");
+    }
+}
+
+/*
+Coefficients of n polynomials of the given degree, all roots of every polynomial are random numbers in [-10, 10]
+*/
+std::vector<double> generate_polynomials(int degree, size_t n, std::mt19937_64 &rng)
+{
+    std::uniform_real_distribution<double> root(-10, 10);
+    std::vector<double> coefficients;
+    for (size_t i = 0; i < n; i++) {
+        std::vector<double> polynomial = {1};
+        for (int j = 0; j < degree; j++) { // multiply by (x - root)
+            double x = root(rng);
+            polynomial.push_back(0);
+            for (size_t k = polynomial.size() - 1; k > 0; k--) {
+                polynomial[k] -= x * polynomial[k - 1];
+            }
+        }
+        coefficients.insert(coefficients.end(), polynomial.begin(), polynomial.end());
+    }
+    return coefficients;
+}
+
+/*
+Measures try_solve_linear_systems<N> on n random diagonally dominant systems
+*/
+template<int N>
+void bench_linear_systems(size_t n, std::mt19937_64 &rng)
+{
+    std::uniform_real_distribution<double> coefficient(-1, 1);
+    std::vector<double> matrices(n * N * N), rhs(n * N), solutions(n * N);
+    for (size_t i = 0; i < matrices.size(); i++) {
+        matrices[i] = coefficient(rng) + ((i % (N * N)) % (N + 1) == 0 ? N : 0);
+    }
+    for (double &value : rhs) {
+        value = coefficient(rng);
+    }
+    std::vector<int> nsolutions(n);
+    std::vector<solver_status> statuses(n);
+    measurement m = measure([&] {
+        try_solve_linear_systems<N>(matrices.data(), rhs.data(), n, nsolutions.data(), solutions.data(), statuses.data());
+    }, n);
+    char solver[32];
+    snprintf(solver, sizeof(solver), "linear_system_%d", N);
+    print_result(solver, "batch", "diagonally_dominant", n, m, false, 0);
+}
+
+/*
+Measures try_solve_tridiagonal_systems on n random diagonally dominant systems of the given size
+*/
+void bench_tridiagonal_systems(size_t size, size_t n, std::mt19937_64 &rng)
+{
+    std::uniform_real_distribution<double> coefficient(-1, 1);
+    std::vector<double> lower(n * size), diagonal(n * size), upper(n * size), rhs(n * size), solutions(n * size);
+    for (size_t i = 0; i < n * size; i++) {
+        lower[i] = coefficient(rng);
+        diagonal[i] = 3 + coefficient(rng);
+        upper[i] = coefficient(rng);
+        rhs[i] = coefficient(rng);
+    }
+    std::vector<int> nsolutions(n);
+    std::vector<solver_status> statuses(n);
+    measurement m = measure([&] {
+        try_solve_tridiagonal_systems(lower.data(), diagonal.data(), upper.data(), rhs.data(), size, n,
+                                      nsolutions.data(), solutions.data(), statuses.data());
+    }, n);
+    char solver[32];
+    snprintf(solver, sizeof(solver), "tridiagonal_%zu", size);
+    print_result(solver, "batch", "diagonally_dominant", n, m, false, 0);
+}
+
+/*
+Usage: run_bench [number of equations]
+Prints CSV lines "solver,path,distribution,n,ns_per_solve,solves_per_sec,branch_misses_per_solve,ipc,max_relative_error",
+the counters are empty if perf_event_open is not available, the error is empty if the roots are not compared
+*/
+int main(int argc, char *argv[])
+{
+    size_t n = 1 << 20;
+    if (argc > 1) {
+        n = strtoull(argv[1], nullptr, 10);
+        if (n == 0) {
+            fprintf(stderr, "Usage: %s [number of equations]\n", argv[0]);
+            return 1;
+        }
+    }
+    std::mt19937_64 rng(2021);
+    const struct {
+        const char *name;
+        equations eq;
+        bool two_roots;
+    } distributions[] = {
+        {"two_roots",    generate_kind(TWO_ROOTS, n, rng),  true},
+        {"one_root",     generate_kind(ONE_ROOT, n, rng),   false},
+        {"zero_roots",   generate_kind(ZERO_ROOTS, n, rng), false},
+        {"linear",       generate_kind(LINEAR, n, rng),     false},
+        {"degenerate",   generate_kind(DEGENERATE, n, rng), false},
+        {"mixed",        generate_mixed(n, false, rng),     false},
+        {"mixed_sorted", generate_mixed(n, true, rng),      false},
+        {"cancelling",   generate_cancelling(n, rng),       true},
+    };
+    const struct {
+        const char *name;
+        scalar_solver solve;
+    } solvers[] = {
+        {"classic",     solve_quadratic_equation},
+        {"stable",      solve_quadratic_equation_stable},
+        {"long_double", solve_quadratic_equation_long_double},
+    };
+
+    solutions x = {std::vector<int>(n), std::vector<double>(n), std::vector<double>(n)};
+    enclosures bounds = {std::vector<int>(n), std::vector<double>(n), std::vector<double>(n),
+                         std::vector<double>(n), std::vector<double>(n)};
+    printf("solver,path,distribution,n,ns_per_solve,solves_per_sec,branch_misses_per_solve,ipc,max_relative_error\n");
+    for (const auto &distribution : distributions) {
+        const equations &eq = distribution.eq;
+        for (const auto &solver : solvers) {
+            measurement m = measure([&] { solve_scalar(solver.solve, eq, x); }, n);
+            print_result(solver.name, "scalar", distribution.name, n, m,
+                         distribution.two_roots, distribution.two_roots ? max_relative_error(eq, x) : 0);
+        }
+        measurement m = measure([&] { solve_batch(eq, 0, n, x); }, n);
+        print_result("classic", "batch", distribution.name, n, m,
+                     distribution.two_roots, distribution.two_roots ? max_relative_error(eq, x) : 0);
+        m = measure([&] { solve_threaded(eq, x); }, n);
+        m.has_counters = false; // the counters see only the main thread
+        print_result("classic", "threaded", distribution.name, n, m,
+                     distribution.two_roots, distribution.two_roots ? max_relative_error(eq, x) : 0);
+
+        m = measure([&] { solve_certified(eq, bounds); }, n);
+        print_result("certified", "scalar", distribution.name, n, m, false, 0);
+        m = measure([&] { solve_certified_batch(eq, bounds); }, n);
+        print_result("certified", "batch", distribution.name, n, m, false, 0);
+    }
+
+    const size_t npolynomials = 1 << 14;
+    for (int degree : {2, 3, 4, 5, 8, 16}) {
+        std::vector<double> coefficients = generate_polynomials(degree, npolynomials, rng);
+        std::vector<int> nroots(npolynomials);
+        std::vector<double> roots(npolynomials * degree);
+        measurement m = measure([&] {
+            solve_each_polynomial_equation(coefficients.data(), degree, npolynomials, nroots.data(), roots.data());
+        }, npolynomials);
+        char solver[32];
+        snprintf(solver, sizeof(solver), "polynomial_degree_%d", degree);
+        print_result(solver, "scalar", "real_roots", npolynomials, m, false, 0);
+    }
+
+    const size_t nsystems = 1 << 14;
+    bench_linear_systems<2>(nsystems, rng);
+    bench_linear_systems<4>(nsystems, rng);
+    bench_linear_systems<8>(nsystems, rng);
+    for (size_t size : {16, 1024}) {
+        bench_tridiagonal_systems(size, nsystems * 16 / size, rng);
+    }
+    return 0;
+}
@@ -1,8 +1,27 @@
 #include "quadratic_equation_solver.h"
+#include "polynomial_equation_solver.h"
+#include "linear_system_solver.h"
+#include "coefficient_file_solver.h"
+#include "work_stealing.h"
+#include "solver_service.h"
+#include "root_columns.h"
 #include "windows_unit_tests.h"
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <cassert>
+#include <charconv>
+#include <stdexcept>
 #include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
 
 #define $test_qes(code, expected_nroots, expected_x1, expected_x2) \
 {                                                                  \
@@ -25,6 +44,584 @@
     std::cout << std::endl;                                        \
 }
 
+/*
+Returns the number of equations for which solve_quadratic_equations wrote
+something different from what solve_quadratic_equation writes
+*/
+template<typename T>
+int count_batch_mismatches(const T *a, const T *b, const T *c, size_t n)
+{
+    int nroots[64] = {}, expected_nroots[64] = {};
+    T x1[64] = {}, x2[64] = {}, expected_x1[64] = {}, expected_x2[64] = {};
+    assert(n <= 64);
+
+    solve_quadratic_equations(a, b, c, n, nroots, x1, x2);
+    int mismatches = 0;
+    for (size_t i = 0; i < n; i++) {
+        expected_nroots[i] = solve_quadratic_equation(a[i], b[i], c[i], expected_x1[i], expected_x2[i]);
+        if (nroots[i] != expected_nroots[i] ||
+            memcmp(&x1[i], &expected_x1[i], sizeof(T)) != 0 ||
+            memcmp(&x2[i], &expected_x2[i], sizeof(T)) != 0) {
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+/*
+Returns the number of equations for which solve_quadratic_equations_complex wrote
+something different from what the std::complex version of solve_quadratic_equation writes
+*/
+int count_complex_batch_mismatches(const double *a, const double *b, const double *c, size_t n)
+{
+    int nroots[64] = {};
+    double x1[64] = {}, x2[64] = {}, imaginary_parts[64] = {};
+    assert(n <= 64);
+
+    solve_quadratic_equations_complex(a, b, c, n, nroots, x1, x2, imaginary_parts);
+    int mismatches = 0;
+    for (size_t i = 0; i < n; i++) {
+        std::complex<double> first_root, second_root;
+        int expected_nroots = solve_quadratic_equation(a[i], b[i], c[i], first_root, second_root);
+        double expected_x1 = first_root.real(), expected_x2 = second_root.real(), expected_imaginary = first_root.imag();
+        if (nroots[i] != expected_nroots ||
+            memcmp(&x1[i], &expected_x1, sizeof(double)) != 0 ||
+            memcmp(&x2[i], &expected_x2, sizeof(double)) != 0 ||
+            memcmp(&imaginary_parts[i], &expected_imaginary, sizeof(double)) != 0) {
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+/*
+Returns true if x and y are both NAN or equal numbers of the same sign (long double has padding bytes, so memcmp does not fit)
+*/
+template<typename T>
+bool same_value(T x, T y)
+{
+    if (std::isnan(x) || std::isnan(y)) {
+        return std::isnan(x) && std::isnan(y);
+    }
+    return !(x < y) && !(x > y) && std::signbit(x) == std::signbit(y);
+}
+
+/*
+Returns the number of random equations with two roots, for which an enclosure written by
+solve_quadratic_equation_certified does not contain the root calculated in a wider type
+or is wider than max_ulps ulps of the root, scaled by the condition number. If cancelling is true, |b| is much greater than |a * c|.
+*/
+template<typename T>
+int count_enclosure_failures(int n, bool cancelling, T max_ulps)
+{
+#ifdef __SIZEOF_FLOAT128__
+    typedef __float128 wide;
+#else
+    typedef long double wide;
+#endif
+    std::mt19937_64 rng(11);
+    std::uniform_real_distribution<double> mantissa(1, 10), root(-10, 10);
+    std::uniform_int_distribution<int> exponent(3, 7);
+    std::bernoulli_distribution sign(0.5);
+    int failures = 0;
+    for (int i = 0; i < n; i++) {
+        T a = (T)((sign(rng) ? 1 : -1) * mantissa(rng)), b = 0, c = 0;
+        if (cancelling) {
+            b = (T)((sign(rng) ? 1 : -1) * mantissa(rng) * std::pow(10.0, exponent(rng)));
+            c = (T)((sign(rng) ? 1 : -1) * mantissa(rng));
+        } else { // the roots are at least 1 apart
+            double x1 = root(rng), x2 = x1 + (sign(rng) ? 1 : -1) * mantissa(rng);
+            b = (T)(-a * (x1 + x2));
+            c = (T)(a * x1 * x2);
+        }
+        root_enclosure<T> first = {0, 0}, second = {0, 0};
+        wide expected_x1 = 0, expected_x2 = 0;
+        if (solve_quadratic_equation_certified(a, b, c, first, second) != 2 ||
+            solve_quadratic_equation_stable<wide>(a, b, c, expected_x1, expected_x2) != 2) {
+            failures++;
+            continue;
+        }
+        // rounding b * b - 4 * a * c moves the roots by about epsilon * (b * b + |4 * a * c|) / (2 * |a| * sqrt(D))
+        wide wa = a, wb = b, wc = c, discriminant = wb * wb - 4 * wa * wc;
+        T spread = (T)((wb * wb + 4 * std::fabs((double)(wa * wc))) / (2 * std::fabs((double)wa) * std::sqrt((double)discriminant)));
+        for (auto check : {std::make_pair(first, expected_x1), std::make_pair(second, expected_x2)}) {
+            const root_enclosure<T> &enclosure = check.first;
+            T x = (T)check.second;
+            failures += (!(enclosure.lo <= check.second && check.second <= enclosure.hi) ||
+                         enclosure.hi - enclosure.lo > max_ulps * std::numeric_limits<T>::epsilon() * (std::fabs(x) + spread));
+        }
+    }
+    return failures;
+}
+
+
+/*
+Returns the number of random equations for which try_solve_quadratic_equations (the branch-free lanes)
+returns or writes something different from try_solve_quadratic_equation
+*/
+template<typename T>
+int count_random_batch_mismatches(size_t n)
+{
+    std::mt19937_64 rng(7);
+    const T values[] = {0, (T)1e-6, (T)-1e-6, 1, -1, 2, (T)-0.5, 3, (T)1e-4, (T)-1e30,
+                        std::numeric_limits<T>::max() / 4, std::numeric_limits<T>::min()};
+    std::uniform_int_distribution<size_t> index(0, sizeof(values) / sizeof(values[0]) - 1);
+    std::bernoulli_distribution one_root(0.25);
+    std::vector<T> a(n), b(n), c(n), x1(n), x2(n);
+    std::vector<int> nroots(n);
+    std::vector<solver_status> statuses(n);
+    for (size_t i = 0; i < n; i++) {
+        a[i] = values[index(rng)];
+        b[i] = values[index(rng)];
+        c[i] = values[index(rng)];
+        if (one_root(rng) && std::isfinite((double)(b[i] * b[i] / (4 * a[i])))) {
+            c[i] = b[i] * b[i] / (4 * a[i]);
+        }
+    }
+    try_solve_quadratic_equations(a.data(), b.data(), c.data(), n, nroots.data(), x1.data(), x2.data(), statuses.data());
+
+    int mismatches = 0;
+    for (size_t i = 0; i < n; i++) {
+        T expected_x1 = 0, expected_x2 = 0;
+        int expected_nroots = 0;
+        solver_status expected_status = try_solve_quadratic_equation(a[i], b[i], c[i], expected_nroots, expected_x1, expected_x2);
+        mismatches += (statuses[i] != expected_status || nroots[i] != expected_nroots ||
+                       !same_value(x1[i], expected_x1) || !same_value(x2[i], expected_x2));
+    }
+    return mismatches;
+}
+
+/*
+Returns the number of random equations for which solve_quadratic_equations_certified (the SIMD lanes)
+writes something different from solve_quadratic_equation_certified (the scalar path)
+*/
+template<typename T>
+int count_certified_batch_mismatches(size_t n)
+{
+    std::mt19937_64 rng(13);
+    const T values[] = {0, (T)1e-6, (T)-1e-6, 1, -1, 2, (T)-0.5, 3, (T)1e-4, (T)-7.5, (T)1e3};
+    std::uniform_int_distribution<size_t> index(0, sizeof(values) / sizeof(values[0]) - 1);
+    std::bernoulli_distribution one_root(0.25);
+    std::vector<T> a(n), b(n), c(n), first_lo(n), first_hi(n), second_lo(n), second_hi(n);
+    std::vector<int> nroots(n);
+    for (size_t i = 0; i < n; i++) {
+        a[i] = values[index(rng)];
+        b[i] = values[index(rng)];
+        c[i] = values[index(rng)];
+        if (one_root(rng) && std::isfinite((double)(b[i] * b[i] / (4 * a[i])))) {
+            c[i] = b[i] * b[i] / (4 * a[i]);
+        }
+    }
+    solve_quadratic_equations_certified(a.data(), b.data(), c.data(), n, nroots.data(),
+                                        first_lo.data(), first_hi.data(), second_lo.data(), second_hi.data());
+
+    int mismatches = 0;
+    for (size_t i = 0; i < n; i++) {
+        root_enclosure<T> first = {0, 0}, second = {0, 0};
+        int expected_nroots = solve_quadratic_equation_certified(a[i], b[i], c[i], first, second);
+        mismatches += (nroots[i] != expected_nroots || !same_value(first_lo[i], first.lo) || !same_value(first_hi[i], first.hi) ||
+                       !same_value(second_lo[i], second.lo) || !same_value(second_hi[i], second.hi));
+    }
+    return mismatches;
+}
+
+/*
+Returns the number of equations from the table of solve_quadratic_equation tests, for which
+the solver for type T gives another number of roots or roots further than 1e-4 from the double ones
+*/
+template<typename T>
+int count_type_mismatches()
+{
+    const double a[] = {1,  1, 1,  0,  0, 0, -2,    2,   -2, 0.1, -0.1,      0.1,       0.2,  -20, 0};
+    const double b[] = {-5, 2, 1,  2,  0, 0,  3,    3,   -3, 3,    sqrt(1.2), sqrt(5.2), 0.3,  3,   0.5};
+    const double c[] = {6,  1, 1, -2, -2, 0, -0.2, -0.2, -0.2, 2, -3,        13,        20,   -0.2, 7};
+    int mismatches = 0;
+    for (size_t i = 0; i < sizeof(a) / sizeof(a[0]); i++) {
+        double x1 = NAN, x2 = NAN;
+        T type_x1 = 0, type_x2 = 0;
+        int nroots = solve_quadratic_equation(a[i], b[i], c[i], x1, x2);
+        int type_nroots = solve_quadratic_equation((T)a[i], (T)b[i], (T)c[i], type_x1, type_x2);
+        mismatches += (nroots != type_nroots ||
+                       (nroots > 0 && std::fabs((double)type_x1 - x1) > 1e-4) ||
+                       (nroots > 1 && std::fabs((double)type_x2 - x2) > 1e-4));
+    }
+    return mismatches;
+}
+
+/*
+Returns true if there are nroots roots and they are within 1e-5 from expected
+*/
+bool roots_match(const double *roots, int nroots, const std::vector<double> &expected)
+{
+    if (nroots != (int)expected.size()) {
+        return false;
+    }
+    for (int i = 0; i < nroots; i++) {
+        if (!(std::fabs(roots[i] - expected[i]) < 1e-5)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+Returns the number of random polynomials with the given real roots (and a pair of complex roots if with_complex),
+for which solve_polynomial_equation finds other roots
+*/
+int count_polynomial_mismatches(int degree, bool with_complex, int n)
+{
+    std::mt19937_64 rng(degree);
+    std::uniform_real_distribution<double> root(-5, 5);
+    int mismatches = 0;
+    for (int i = 0; i < n; i++) {
+        int nreal = degree - (with_complex ? 2 : 0);
+        std::vector<double> roots(nreal), coefficients = {1};
+        for (double &x : roots) {
+            x = root(rng);
+        }
+        std::sort(roots.begin(), roots.end());
+        for (double x : roots) { // multiply by (x - root)
+            coefficients.push_back(0);
+            for (size_t j = coefficients.size() - 1; j > 0; j--) {
+                coefficients[j] -= x * coefficients[j - 1];
+            }
+        }
+        if (with_complex) { // multiply by x^2 + 1
+            coefficients.insert(coefficients.end(), {0, 0});
+            for (size_t j = coefficients.size() - 1; j > 1; j--) {
+                coefficients[j] += coefficients[j - 2];
+            }
+        }
+
+        bool close = false;
+        for (size_t j = 1; j < roots.size(); j++) {
+            close = close || roots[j] - roots[j - 1] < 0.1;
+        }
+        if (close) {
+            continue;
+        }
+        std::vector<double> found(degree);
+        int nroots = solve_polynomial_equation(coefficients.data(), degree, found.data());
+        mismatches += !roots_match(found.data(), nroots, roots);
+    }
+    return mismatches;
+}
+
+/*
+Returns the number of tasks which were not run exactly once by run_work_stealing
+*/
+int count_work_stealing_errors(size_t ntasks, unsigned nthreads)
+{
+    std::vector< std::atomic<int> > runs(ntasks);
+    run_work_stealing(ntasks, nthreads, [&](size_t task) {
+        runs[task]++;
+    });
+    int errors = 0;
+    for (size_t i = 0; i < ntasks; i++) {
+        errors += (runs[i] != 1);
+    }
+    return errors;
+}
+
+/*
+Writes text to the file file_in_path, solves it with solve_coefficient_file and returns the content of file_out_path
+*/
+std::string solve_text_file(const std::string &text, unsigned nthreads, coefficient_file_format format)
+{
+    const char *file_in_path = "run_tests_coefficients.tmp", *file_out_path = "run_tests_roots.tmp";
+    FILE *file_in = fopen(file_in_path, "wb");
+    assert(file_in != nullptr);
+    fwrite(text.data(), 1, text.size(), file_in);
+    fclose(file_in);
+
+    std::string result;
+    try {
+        solve_coefficient_file(file_in_path, file_out_path, format, nthreads);
+    } catch (const std::invalid_argument &) {
+        remove(file_in_path);
+        remove(file_out_path);
+        return "std::invalid_argument";
+    }
+
+    FILE *file_out = fopen(file_out_path, "rb");
+    assert(file_out != nullptr);
+    char buffer[4096] = {};
+    size_t nread = 0;
+    while ((nread = fread(buffer, 1, sizeof(buffer), file_out)) > 0) {
+        result.append(buffer, nread);
+    }
+    fclose(file_out);
+    remove(file_in_path);
+    remove(file_out_path);
+    return result;
+}
+
+bool same_bits(double x, double y)
+{
+    return memcmp(&x, &y, sizeof(double)) == 0;
+}
+
+/*
+Returns the number of random numbers for which quadratic_details::newton_sqrt differs from std::sqrt
+*/
+int count_newton_sqrt_mismatches(int n)
+{
+    std::mt19937_64 rng(5);
+    std::uniform_real_distribution<double> mantissa(0, 1);
+    std::uniform_int_distribution<int> exponent(-1070, 1023);
+    int mismatches = 0;
+    for (int i = 0; i < n; i++) {
+        double num = std::ldexp(mantissa(rng), exponent(rng));
+        double expected = std::sqrt(num), got = quadratic_details::newton_sqrt(num);
+        mismatches += (memcmp(&expected, &got, sizeof(double)) != 0);
+    }
+    return mismatches;
+}
+
+/*
+Returns true if the constexpr solve_quadratic_equation gives exactly the same as the out-of-line one
+*/
+bool constexpr_solver_matches(double a, double b, double c)
+{
+    double first_root = 0, second_root = 0;
+    int nroots = solve_quadratic_equation(a, b, c, first_root, second_root);
+    quadratic_roots roots = solve_quadratic_equation(a, b, c);
+    return nroots == roots.nroots && memcmp(&first_root, &roots.first_root, sizeof(double)) == 0 &&
+           memcmp(&second_root, &roots.second_root, sizeof(double)) == 0;
+}
+
+/*
+Returns the number of random systems of N equations with diagonally dominant matrices, for which
+try_solve_linear_systems does not find the solution x, that was used to calculate the right-hand sides
+*/
+template<int N>
+int count_linear_system_errors(size_t n)
+{
+    std::mt19937_64 rng(N);
+    std::uniform_real_distribution<double> coefficient(-1, 1);
+    std::vector<double> matrices(n * N * N), rhs(n * N), expected(n * N), solutions(n * N);
+    for (size_t k = 0; k < n; k++) {
+        double *matrix = matrices.data() + k * N * N;
+        for (int i = 0; i < N; i++) {
+            expected[k * N + i] = 10 * coefficient(rng);
+            for (int j = 0; j < N; j++) {
+                matrix[i * N + j] = coefficient(rng) + (i == j ? (coefficient(rng) < 0 ? -N : N) : 0);
+            }
+        }
+        for (int i = 0; i < N; i++) {
+            rhs[k * N + i] = 0;
+            for (int j = 0; j < N; j++) {
+                rhs[k * N + i] += matrix[i * N + j] * expected[k * N + j];
+            }
+        }
+    }
+    std::vector<int> nsolutions(n);
+    std::vector<solver_status> statuses(n);
+    try_solve_linear_systems<N>(matrices.data(), rhs.data(), n, nsolutions.data(), solutions.data(), statuses.data());
+    int errors = 0;
+    for (size_t k = 0; k < n; k++) {
+        bool wrong = (statuses[k] != SOLVER_OK || nsolutions[k] != 1);
+        for (int i = 0; i < N; i++) {
+            wrong = wrong || !(std::fabs(solutions[k * N + i] - expected[k * N + i]) < 1e-9);
+        }
+        errors += wrong;
+    }
+    return errors;
+}
+
+/*
+Returns the number of random tridiagonal systems of N equations with small integer coefficients
+(many of them are singular or have zero diagonal elements), for which solve_tridiagonal_system
+finds a different number of solutions than solve_linear_system<N> or a different solution
+*/
+template<int N>
+int count_tridiagonal_mismatches(int n)
+{
+    std::mt19937_64 rng(N + 100);
+    std::uniform_int_distribution<int> coefficient(-2, 2);
+    int mismatches = 0;
+    for (int k = 0; k < n; k++) {
+        double lower[N] = {}, diagonal[N] = {}, upper[N] = {}, rhs[N] = {}, matrix[N * N] = {};
+        for (int i = 0; i < N; i++) {
+            lower[i] = (i > 0 ? coefficient(rng) : 0);
+            diagonal[i] = coefficient(rng);
+            upper[i] = (i + 1 < N ? coefficient(rng) : 0);
+            rhs[i] = coefficient(rng);
+            matrix[i * N + i] = diagonal[i];
+            if (i > 0) {
+                matrix[i * N + i - 1] = lower[i];
+            }
+            if (i + 1 < N) {
+                matrix[i * N + i + 1] = upper[i];
+            }
+        }
+        double solution[N] = {}, expected[N] = {};
+        int nsolutions = solve_tridiagonal_system(lower, diagonal, upper, rhs, N, solution);
+        int expected_nsolutions = solve_linear_system<N>(matrix, rhs, expected);
+        bool wrong = (nsolutions != expected_nsolutions);
+        for (int i = 0; i < N; i++) {
+            wrong = wrong || (nsolutions == 1 ? !(std::fabs(solution[i] - expected[i]) < 1e-9) : !std::isnan(solution[i]));
+        }
+        mismatches += wrong;
+    }
+    return mismatches;
+}
+
+/*
+Returns the maximum error of the solutions of n random diagonally dominant tridiagonal systems
+of the given size, solved with try_solve_tridiagonal_systems
+*/
+double tridiagonal_error(size_t size, size_t n)
+{
+    std::mt19937_64 rng(size);
+    std::uniform_real_distribution<double> coefficient(-1, 1);
+    std::vector<double> lower(n * size), diagonal(n * size), upper(n * size), rhs(n * size), expected(n * size), solutions(n * size);
+    for (size_t i = 0; i < n * size; i++) {
+        lower[i] = coefficient(rng);
+        upper[i] = coefficient(rng);
+        diagonal[i] = 3 + coefficient(rng);
+        expected[i] = coefficient(rng);
+    }
+    for (size_t i = 0; i < n * size; i++) {
+        size_t position = i % size;
+        rhs[i] = diagonal[i] * expected[i] + (position > 0 ? lower[i] * expected[i - 1] : 0) +
+                 (position + 1 < size ? upper[i] * expected[i + 1] : 0);
+    }
+    std::vector<int> nsolutions(n);
+    std::vector<solver_status> statuses(n);
+    try_solve_tridiagonal_systems(lower.data(), diagonal.data(), upper.data(), rhs.data(), size, n,
+                                  nsolutions.data(), solutions.data(), statuses.data());
+    double error = 0;
+    for (size_t k = 0; k < n; k++) {
+        if (statuses[k] != SOLVER_OK || nsolutions[k] != 1) {
+            return INFINITY;
+        }
+    }
+    for (size_t i = 0; i < n * size; i++) {
+        error = std::fmax(error, std::fabs(solutions[i] - expected[i]));
+    }
+    return error;
+}
+
+
+/*
+Starts the solver service, solves n random equations (some of them are not finite or overflow) in each of
+nclients clients at the same time, stops the service and returns the number of results that differ from
+try_solve_quadratic_equations (or -1 if a client has thrown an exception)
+*/
+int count_service_mismatches(size_t batch_size, unsigned flush_timeout_us, int nclients, size_t n, solver_service_stats &stats)
+{
+    solver_service_config config;
+    config.socket_path = "run_tests_solver_service.sock";
+    config.batch_size = batch_size;
+    config.flush_timeout_us = flush_timeout_us;
+    solver_service service(config);
+    std::thread server([&] { service.run(); });
+
+    std::atomic<int> mismatches(0);
+    std::vector<std::thread> clients;
+    for (int k = 0; k < nclients; k++) {
+        clients.emplace_back([&, k] {
+            std::mt19937_64 rng(k);
+            const double values[] = {0, 1, -1, 2, -5, 6, 0.5, 1e-7, 1e200, NAN, INFINITY};
+            std::uniform_int_distribution<size_t> index(0, sizeof(values) / sizeof(values[0]) - 1);
+            std::vector<double> a(n), b(n), c(n), x1(n), x2(n), expected_x1(n), expected_x2(n);
+            std::vector<int> nroots(n), expected_nroots(n);
+            std::vector<solver_status> statuses(n), expected_statuses(n);
+            for (size_t i = 0; i < n; i++) {
+                a[i] = values[index(rng)];
+                b[i] = values[index(rng)];
+                c[i] = values[index(rng)];
+            }
+            try_solve_quadratic_equations(a.data(), b.data(), c.data(), n, expected_nroots.data(),
+                                          expected_x1.data(), expected_x2.data(), expected_statuses.data());
+            try {
+                solver_client client(config.socket_path.c_str());
+                client.try_solve_many(a.data(), b.data(), c.data(), n, nroots.data(), x1.data(), x2.data(), statuses.data());
+            } catch (const std::runtime_error &) {
+                mismatches = -1;
+                return;
+            }
+            for (size_t i = 0; i < n; i++) {
+                mismatches += (nroots[i] != expected_nroots[i] || statuses[i] != expected_statuses[i] ||
+                               !same_value(x1[i], expected_x1[i]) || !same_value(x2[i], expected_x2[i]));
+            }
+        });
+    }
+    for (std::thread &client : clients) {
+        client.join();
+    }
+    service.stop();
+    server.join();
+    stats = service.stats();
+    return mismatches;
+}
+
+
+/*
+Solves n equations (some of them fail) from a binary or CSV file to a root columns file, reads it
+with root_columns and returns the number of equations which results differ from try_solve_quadratic_equations
+(-1 if the file is not read back)
+*/
+int count_root_columns_mismatches(size_t n, coefficient_file_format format, result_file_format results, unsigned nthreads)
+{
+    const char *file_in_path = "run_tests_coefficients.tmp", *file_out_path = "run_tests_roots.tmp";
+    std::mt19937_64 rng(n);
+    const double values[] = {0, 1, -1, 2, -5, 6, 0.5, 1e-7, 1e200, NAN, INFINITY};
+    std::uniform_int_distribution<size_t> index(0, sizeof(values) / sizeof(values[0]) - 1);
+    std::vector<double> a(n), b(n), c(n), x1(n), x2(n);
+    std::vector<int> nroots(n);
+    std::vector<solver_status> statuses(n);
+    std::string text;
+    std::vector<double> coefficients;
+    for (size_t i = 0; i < n; i++) {
+        a[i] = values[index(rng)];
+        b[i] = values[index(rng)];
+        c[i] = values[index(rng)];
+        coefficients.insert(coefficients.end(), {a[i], b[i], c[i]});
+        for (double coefficient : {a[i], b[i], c[i]}) {
+            char buffer[32] = {};
+            text.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), coefficient).ptr);
+            text += ',';
+        }
+        text.back() = '\n';
+    }
+    try_solve_quadratic_equations(a.data(), b.data(), c.data(), n, nroots.data(), x1.data(), x2.data(), statuses.data());
+
+    FILE *file_in = fopen(file_in_path, "wb");
+    assert(file_in != nullptr);
+    if (format == BINARY_COEFFICIENTS) {
+        fwrite(coefficients.data(), sizeof(double), coefficients.size(), file_in);
+    } else {
+        fwrite(text.data(), 1, text.size(), file_in);
+    }
+    fclose(file_in);
+
+    int mismatches = -1;
+    try {
+        solve_coefficient_file(file_in_path, file_out_path, format, nthreads, results);
+        root_columns columns(file_out_path);
+        if (columns.size() == n && columns.has_validity() == (results == COLUMNAR_RESULTS_WITH_VALIDITY)) {
+            mismatches = 0;
+            for (size_t i = 0; i < n; i++) {
+                int expected_nroots = (statuses[i] == SOLVER_OK ? nroots[i] : 0);
+                bool wrong = (columns.nroots()[i] != expected_nroots || columns.statuses()[i] != statuses[i] ||
+                              !same_value(columns.first_roots()[i], x1[i]) || !same_value(columns.second_roots()[i], x2[i]));
+                if (columns.has_validity()) {
+                    wrong = wrong || ((columns.first_valid()[i / 64] >> (i % 64)) & 1) != !std::isnan(x1[i]) ||
+                                     ((columns.second_valid()[i / 64] >> (i % 64)) & 1) != !std::isnan(x2[i]);
+                }
+                mismatches += wrong;
+            }
+        }
+    } catch (const std::exception &) {
+    }
+    remove(file_in_path);
+    remove(file_out_path);
+    return mismatches;
+}
+
+
 int main() {
     double x1 = NAN, x2 = NAN;
 
@@ -65,6 +662,499 @@ int main() {
     $unit_test_sigabrt(solve_quadratic_equation(0.1, 3, NAN, x1, x2));
 
 
+    //--------solve_quadratic_equations--------
+
+    {
+        const double almost_zero = sqrt(1.2) * sqrt(1.2) - 0.1 * 3 * 4;
+        const double a[] = {1,  1, 1,  0,  0, 0, -2,    2,   -2, 0.1, -0.1,       0.1,       0.2,  -20, 0,   almost_zero, almost_zero, 0,           0,           1e-300};
+        const double b[] = {-5, 2, 1,  2,  0, 0,  3,    3,   -3, 3,    sqrt(1.2), sqrt(5.2), 0.3,  3,   0.5, -7,          0,           almost_zero, 0,           1};
+        const double c[] = {6,  1, 1, -2, -2, 0, -0.2, -0.2, -0.2, 2, -3,        13,        20,   -0.2, 7,   0.5,         -25,         0.2,         almost_zero, 1};
+        const size_t n = sizeof(a) / sizeof(a[0]);
+
+        for (volatile size_t size = 0; size <= n; size++) {
+            $unit_test(count_batch_mismatches(a, b, c, size), 0);
+        }
+        for (volatile size_t shift = 1; shift < 8; shift++) {
+            $unit_test(count_batch_mismatches(a + shift, b + shift, c + shift, n - shift), 0);
+        }
+    }
+
+    {
+        const double a[] = {1, 1, 1, 1, 1, 1, 1, 1, 1};
+        const double b[] = {1, 1, 1, 1, 1, 1, 1, 1, 1};
+        const double c[] = {1, 1, 1, 1, 1, 1, 1, 1, NAN};
+        int nroots[9] = {};
+        double x1[9] = {}, x2[9] = {};
+        $unit_test_sigabrt((solve_quadratic_equations(a, b, c, 9, nroots, x1, x2), 0));
+        $unit_test_sigabrt((solve_quadratic_equations(c, a, b, 9, nroots, x1, x2), 0));
+        $unit_test_sigabrt((solve_quadratic_equations(a, b, c, 9, nroots, x1, x1), 0));
+    }
+
+    {
+        const float a[] = {1,  1, 1,  0,  0, 0, -2,    2,     -2,    0.1f, -0.1f, 1e-30f, 3,  0.2f, -20,   0,    1,  1, 1e-3f, 1};
+        const float b[] = {-5, 2, 1,  2,  0, 0,  3,    3,     -3,    3,     1,    1,      7,  0.3f,  3,    0.5f, -3, 1, 1e3f, -1};
+        const float c[] = {6,  1, 1, -2, -2, 0, -0.2f, -0.2f, -0.2f, 2,    -3,    1,      -1, 20,   -0.2f, 7,     2, 1, 1,    -1};
+        const size_t n = sizeof(a) / sizeof(a[0]);
+
+        for (volatile size_t size = 0; size <= n; size++) {
+            $unit_test(count_batch_mismatches(a, b, c, size), 0);
+        }
+    }
+
+    $unit_test(count_random_batch_mismatches<double>(100000), 0);
+    $unit_test(count_random_batch_mismatches<float>(100000), 0);
+    $unit_test(count_random_batch_mismatches<long double>(10000), 0);
+    std::cout << std::endl;
+
+
+    //--------complex roots--------
+
+    {
+        std::complex<double> z1, z2;
+        $unit_test(solve_quadratic_equation(1, 2, 5, z1, z2), 2);
+        $f_unit_test(z1.real(), -1, 1e-5);
+        $f_unit_test(z1.imag(), 2, 1e-5);
+        $f_unit_test(z2.real(), -1, 1e-5);
+        $f_unit_test(z2.imag(), -2, 1e-5);
+        $unit_test(solve_quadratic_equation(-2, 0, -8, z1, z2), 2);
+        $f_unit_test(std::abs(z1 * z1 + 4.0), 0, 1e-5);
+        $unit_test(z1 == std::conj(z2), true);
+        $unit_test(solve_quadratic_equation(1, -5, 6, z1, z2), 2);
+        $f_unit_test(z1.real(), 3, 1e-5);
+        $f_unit_test(z1.imag(), 0, 1e-5);
+        $f_unit_test(z2.imag(), 0, 1e-5);
+        $unit_test(solve_quadratic_equation(0, 2, -2, z1, z2), 1);
+        $f_unit_test(z1.real(), 1, 1e-5);
+        $unit_test(solve_quadratic_equation(1, 2, 1, z1, z2), 1);
+
+        int nroots = 0;
+        double imaginary_part = 0;
+        $unit_test(try_solve_quadratic_equation_complex(0.2, 0.3, 20, nroots, x1, x2, imaginary_part), SOLVER_OK);
+        $unit_test(nroots, 2);
+        $f_unit_test(imaginary_part, std::sqrt(16 - 0.09) / 0.4, 1e-5);
+        $unit_test(try_solve_quadratic_equation_complex(NAN, 0.3, 20, nroots, x1, x2, imaginary_part), SOLVER_NOT_FINITE_INPUT);
+        $f_unit_test(imaginary_part, 0, 1e-5);
+        std::complex<float> float_z1, float_z2;
+        $unit_test(solve_quadratic_equation(1, 0, 4, float_z1, float_z2), 2);
+        $f_unit_test(float_z1.imag(), 2, 1e-5);
+
+        const double a[] = {1, 1, 1,  0,  0, 0, 0.2, -20,  1,  1, -2,    2,   -2, 0.1, 3, 1, 0.5, 1, 1, 1};
+        const double b[] = {2, 2, -5, 2,  0, 0, 0.3,  3,   0,  1,  3,    3,   -3, 3,   1, 4, 1,   0, 1, -1};
+        const double c[] = {5, 1, 6, -2, -2, 0, 20,  -0.2, 4,  1, -0.2, -0.2, -0.2, 2, 1, 8, 3,   1, 0, 1};
+        const size_t n = sizeof(a) / sizeof(a[0]);
+        for (volatile size_t size = 0; size <= n; size += 3) {
+            $unit_test(count_complex_batch_mismatches(a, b, c, size), 0);
+        }
+        $unit_test(count_complex_batch_mismatches(a + 1, b + 1, c + 1, n - 1), 0);
+
+        int batch_nroots[3] = {};
+        double first_roots[3] = {}, second_roots[3] = {}, imaginary_parts[3] = {};
+        solver_status statuses[3] = {};
+        const double bad_a[] = {1, 1, NAN}, bad_b[] = {1, 1e200, 1}, bad_c[] = {1, 1, 1};
+        try_solve_quadratic_equations_complex(bad_a, bad_b, bad_c, 3, batch_nroots, first_roots, second_roots, imaginary_parts, statuses);
+        $unit_test(statuses[0] == SOLVER_OK && statuses[1] == SOLVER_OVERFLOW && statuses[2] == SOLVER_NOT_FINITE_INPUT, true);
+        $unit_test(batch_nroots[0], 2);
+        $unit_test_sigabrt(solve_quadratic_equation(NAN, 1, 1, z1, z2));
+        $unit_test_sigabrt(solve_quadratic_equation(1, 2, 5, z1, z1));
+    }
+    std::cout << std::endl;
+
+
+    //--------solve_quadratic_equation for float, long double and __float128--------
+
+    {
+        float float_x1 = 0, float_x2 = 0;
+        $unit_test(solve_quadratic_equation(1, -5, 6, float_x1, float_x2), 2);
+        $f_unit_test(float_x1, 3, 1e-5);
+        $unit_test(count_type_mismatches<float>(), 0);
+        $unit_test(count_type_mismatches<long double>(), 0);
+#ifdef __SIZEOF_FLOAT128__
+        $unit_test(count_type_mismatches<__float128>(), 0);
+#endif
+
+        int nroots = 0;
+        $unit_test(try_solve_quadratic_equation(1, 1e20f, 1, nroots, float_x1, float_x2), SOLVER_OVERFLOW);
+        long double long_x1 = 0, long_x2 = 0;
+        $unit_test(try_solve_quadratic_equation(1, 1e200L, 1, nroots, long_x1, long_x2), SOLVER_OK);
+        $unit_test(nroots, 2);
+        $unit_test(solve_quadratic_equation_stable(1, 1e8L, 1, long_x1, long_x2), 2);
+        $unit_test(std::fabs(long_x1 * long_x2 - 1) < 1e-18L, true);
+
+        $unit_test(is_zero<float>(1e-6f), true);
+        $unit_test(calculate_discriminant<long double>(0.1L, 3, 2) > 9 - 0.8L - 1e-15L, true);
+        $unit_test_sigabrt(solve_quadratic_equation(NAN, 3, 2, float_x1, float_x2));
+    }
+    std::cout << std::endl;
+
+
+    //--------solve_quadratic_equation_stable--------
+
+    $test_qes(solve_quadratic_equation_stable(1, -5,  6, x1, x2), 2,  3, 2);
+    $test_qes(solve_quadratic_equation_stable(1,  2,  1, x1, x2), 1, -1, 0);
+    $test_qes(solve_quadratic_equation_stable(1,  1,  1, x1, x2), 0,  0, 0);
+    $test_qes(solve_quadratic_equation_stable(0,  2, -2, x1, x2), 1,  1, 0);
+    $test_qes(solve_quadratic_equation_stable(0,  0,  0, x1, x2), INF_ROOTS,  0, 0);
+    $test_qes(solve_quadratic_equation_stable(-2,  3, -0.2, x1, x2), 2,  (-3 + sqrt(9 - 1.6)) / (-4), (-3 - sqrt(9 - 1.6)) / (-4));
+    $test_qes(solve_quadratic_equation_stable( 2,  3, -0.2, x1, x2), 2,  (-3 + sqrt(9 + 1.6)) /   4 , (-3 - sqrt(9 + 1.6)) /   4 );
+    $test_qes(solve_quadratic_equation_stable(-2, -3, -0.2, x1, x2), 2,  ( 3 + sqrt(9 - 1.6)) / (-4), ( 3 - sqrt(9 - 1.6)) / (-4));
+    $test_qes(solve_quadratic_equation_stable( 1,  0, -4, x1, x2), 2,  2, -2);
+    $test_qes(solve_quadratic_equation_stable(-0.1, sqrt(1.2), -3, x1, x2), 1,  sqrt(1.2) / 0.2, 0);
+
+    $unit_test(solve_quadratic_equation_stable(1, 1e8, 1, x1, x2), 2);
+    $unit_test(std::fabs(x1 / -1e-8 - 1) < 1e-15, true);
+    $unit_test(std::fabs(x2 / -1e8 - 1) < 1e-15, true);
+    $unit_test(solve_quadratic_equation_stable(1, -1e8, 1, x1, x2), 2);
+    $unit_test(std::fabs(x1 / 1e8 - 1) < 1e-15, true);
+    $unit_test(std::fabs(x2 / 1e-8 - 1) < 1e-15, true);
+    {
+        // close roots: b * b is rounded, 4 * a * c cancels almost all of it, the plain formula moves the roots by about 1e-14
+        const double r1 = 1 + ldexp(1, -8) + ldexp(1, -25), r2 = 1 + ldexp(1, -26);
+        $unit_test(solve_quadratic_equation_stable(1, -(r1 + r2), r1 * r2, x1, x2), 2);
+        $unit_test(std::fabs(x1 - r1) < 1e-15 && std::fabs(x2 - r2) < 1e-15, true);
+        float float_x1 = 0, float_x2 = 0;
+        const float f1 = 1 + ldexpf(1, -6) + ldexpf(1, -11), f2 = 1 + ldexpf(1, -12);
+        $unit_test(solve_quadratic_equation_stable(1, -(f1 + f2), f1 * f2, float_x1, float_x2), 2);
+        $unit_test(std::fabs(float_x1 - f1) < 1e-6f && std::fabs(float_x2 - f2) < 1e-6f, true);
+    }
+
+    $unit_test_sigabrt(solve_quadratic_equation_stable(0.1, 3, 2, x1, x1));
+    $unit_test_sigabrt(solve_quadratic_equation_stable(NAN, 3, 2, x1, x2));
+    std::cout << std::endl;
+
+
+    //--------solve_quadratic_equation_certified--------
+
+    {
+        root_enclosure<double> first = {0, 0}, second = {0, 0};
+        $unit_test(solve_quadratic_equation_certified(1, -5, 6, first, second), 2);
+        $unit_test(first.lo <= 3 && 3 <= first.hi && second.lo <= 2 && 2 <= second.hi, true);
+        $unit_test(first.hi - first.lo < 1e-14 && second.hi - second.lo < 1e-14, true);
+        $unit_test(solve_quadratic_equation_certified(1, 2, 1, first, second), 1);
+        $unit_test(first.lo <= -1 && -1 <= first.hi && std::isnan(second.lo) && std::isnan(second.hi), true);
+        $unit_test(solve_quadratic_equation_certified(0, 2, -2, first, second), 1);
+        $unit_test(first.lo <= 1 && 1 <= first.hi && first.lo > 1 - 1e-15, true);
+        $unit_test(solve_quadratic_equation_certified(1, 1, 1, first, second), 0);
+        $unit_test(std::isnan(first.lo) && std::isnan(first.hi) && std::isnan(second.lo), true);
+        $unit_test(solve_quadratic_equation_certified(0, 0, 0, first, second), INF_ROOTS);
+        $unit_test(solve_quadratic_equation_certified(1, 1e8, 1, first, second), 2);
+        $unit_test(first.lo <= -1e-8 && -1e-8 <= first.hi && second.lo <= -1e8 && -1e8 <= second.hi, true);
+
+        $unit_test(count_enclosure_failures<double>(10000, false, 16), 0);
+        $unit_test(count_enclosure_failures<double>(10000, true, 16), 0);
+        $unit_test(count_enclosure_failures<float>(10000, false, 16), 0);
+        $unit_test(count_enclosure_failures<long double>(10000, true, 16), 0);
+
+        const double a[] = {1, 1, 1, 0, 0, -2, 1, 2, 1e-3, 3, 1, -1, 1, 1, 1, 1, 5},
+                     b[] = {-5, 2, 1, 2, 0, 3, 1e8, -3, 7, 1, -1e8, 0, 4, -2, 0.5, 9, 1},
+                     c[] = {6, 1, 1, -2, 0, -0.2, 1, -1, 2, -4, 1, 4, 3, 1, -2, 1, 0};
+        const size_t n = sizeof(a) / sizeof(a[0]);
+        int nroots[n] = {};
+        double batch[4][n] = {};
+        solve_quadratic_equations_certified(a, b, c, n, nroots, batch[0], batch[1], batch[2], batch[3]);
+        volatile int mismatches = 0;
+        for (size_t i = 0; i < n; i++) {
+            int expected_nroots = solve_quadratic_equation_certified(a[i], b[i], c[i], first, second);
+            mismatches += (nroots[i] != expected_nroots || !same_value(batch[0][i], first.lo) || !same_value(batch[1][i], first.hi) ||
+                           !same_value(batch[2][i], second.lo) || !same_value(batch[3][i], second.hi));
+        }
+        $unit_test(mismatches, 0);
+        $unit_test(count_certified_batch_mismatches<double>(100000), 0);
+        $unit_test(count_certified_batch_mismatches<float>(100000), 0);
+        $unit_test(count_certified_batch_mismatches<long double>(10000), 0);
+
+        int count = 0;
+        $unit_test(try_solve_quadratic_equation_certified(1, 1e200, 1, count, first, second), SOLVER_OVERFLOW);
+        $unit_test(try_solve_quadratic_equation_certified(1, NAN, 1, count, first, second), SOLVER_NOT_FINITE_INPUT);
+        $unit_test(count == 0 && std::isnan(first.lo), true);
+        volatile bool thrown = false;
+        try {
+            solve_quadratic_equation_certified(1, 1e200, 1, first, second);
+        } catch (const std::runtime_error &) {
+            thrown = true;
+        }
+        $unit_test(thrown, true);
+        $unit_test_sigabrt(solve_quadratic_equation_certified(1, NAN, 1, first, second));
+        $unit_test_sigabrt(solve_quadratic_equation_certified(1, -5, 6, first, first));
+    }
+    std::cout << std::endl;
+
+
+    //--------constexpr solve_quadratic_equation--------
+
+    {
+        constexpr quadratic_roots roots = solve_quadratic_equation(-2, 3, -0.2);
+        static_assert(roots.nroots == 2, "constexpr solve_quadratic_equation");
+        static_assert(solve_quadratic_equation(1, 2, 1).nroots == 1, "constexpr solve_quadratic_equation");
+        static_assert(solve_quadratic_equation(1, 2, 1).first_root < -1 + EPS, "constexpr solve_quadratic_equation");
+        static_assert(solve_quadratic_equation(0, 0, 0).nroots == INF_ROOTS, "constexpr solve_quadratic_equation");
+        static_assert(quadratic_details::newton_sqrt(4) > 2 - EPS && quadratic_details::newton_sqrt(4) < 2 + EPS, "newton_sqrt");
+        $f_unit_test(roots.first_root, (-3 + sqrt(9 - 1.6)) / (-4), 1e-5);
+        $f_unit_test(roots.second_root, (-3 - sqrt(9 - 1.6)) / (-4), 1e-5);
+
+        $unit_test(constexpr_solver_matches(1, -5, 6), true);
+        $unit_test(constexpr_solver_matches(2, 3, -0.2), true);
+        $unit_test(constexpr_solver_matches(0.1, 3, 2), true);
+        $unit_test(constexpr_solver_matches(1, 1, 1), true);
+        $unit_test(constexpr_solver_matches(0, 0.5, 7), true);
+        $unit_test(constexpr_solver_matches(0, 0, 7), true);
+        $unit_test(constexpr_solver_matches(-0.1, sqrt(1.2), -3), true);
+
+        $unit_test(count_newton_sqrt_mismatches(1000000), 0);
+        $unit_test(same_bits(quadratic_details::newton_sqrt(DBL_MAX), sqrt(DBL_MAX)), true);
+        $unit_test(same_bits(quadratic_details::newton_sqrt(DBL_TRUE_MIN), sqrt(DBL_TRUE_MIN)), true);
+        $unit_test(same_bits(quadratic_details::newton_sqrt(2), sqrt(2)), true);
+
+        $unit_test_sigabrt(solve_quadratic_equation(NAN, 1, 1).nroots);
+    }
+    std::cout << std::endl;
+
+
+    //--------try_solve_quadratic_equation--------
+
+    {
+        int nroots = 0;
+        $unit_test(try_solve_quadratic_equation(1, -5, 6, nroots, x1, x2), SOLVER_OK);
+        $test_qes(nroots, 2, 3, 2);
+        $unit_test(try_solve_quadratic_equation(0, 0, 0, nroots, x1, x2), SOLVER_OK);
+        $test_qes(nroots, INF_ROOTS, 0, 0);
+        $unit_test(try_solve_quadratic_equation(NAN, 3, 2, nroots, x1, x2), SOLVER_NOT_FINITE_INPUT);
+        $unit_test(try_solve_quadratic_equation(0.1, 3, -INFINITY, nroots, x1, x2), SOLVER_NOT_FINITE_INPUT);
+        $unit_test(try_solve_quadratic_equation(1, 1e200, 1, nroots, x1, x2), SOLVER_OVERFLOW);
+        $unit_test(try_solve_quadratic_equation(1e-4, 1e305, 1e-300, nroots, x1, x2), SOLVER_OVERFLOW);
+        $unit_test(try_solve_quadratic_equation(0, 1e-4, 1e305, nroots, x1, x2), SOLVER_OVERFLOW);
+        $unit_test(nroots, 0);
+        $unit_test(std::isnan(x1) && std::isnan(x2), true);
+
+        $unit_test(try_solve_linear_equation(0.5, 1, nroots, x1), SOLVER_OK);
+        $test_les(nroots, 1, -2);
+        $unit_test(try_solve_linear_equation(INFINITY, 5, nroots, x1), SOLVER_NOT_FINITE_INPUT);
+        $unit_test(try_solve_linear_equation(1e-4, 1e305, nroots, x1), SOLVER_OVERFLOW);
+
+        double discriminant = 0;
+        $unit_test(try_calculate_discriminant(0.1, 3, 2, discriminant), SOLVER_OK);
+        $f_unit_test(discriminant, 9 - 0.8, 1e-5);
+        $unit_test(try_calculate_discriminant(1, 1e200, 1, discriminant), SOLVER_OVERFLOW);
+        $unit_test(try_calculate_discriminant(NAN, 0, 1, discriminant), SOLVER_NOT_FINITE_INPUT);
+    }
+
+    {
+        const double a[] = {1, 1,    1, 1,   1e-4,  0, 1, 1, 1};
+        const double b[] = {1, 1e200, 1, -5, 1e305,  1, 1, 1, NAN};
+        const double c[] = {1, 1,    1, 6,   1e-300, 0, 1, 1, 1};
+        const solver_status expected[] = {SOLVER_OK, SOLVER_OVERFLOW, SOLVER_OK, SOLVER_OK, SOLVER_OVERFLOW,
+                                          SOLVER_OK, SOLVER_OK, SOLVER_OK, SOLVER_NOT_FINITE_INPUT};
+        int nroots[9] = {};
+        double first_roots[9] = {}, second_roots[9] = {};
+        solver_status statuses[9] = {};
+        try_solve_quadratic_equations(a, b, c, 9, nroots, first_roots, second_roots, statuses);
+        for (volatile int i = 0; i < 9; i++) {
+            $unit_test(statuses[i], expected[i]);
+        }
+        $unit_test(nroots[3], 2);
+        $unit_test(nroots[1], 0);
+    }
+
+    std::cout << std::endl;
+
+
+    //--------solve_cubic_equation, solve_quartic_equation, solve_polynomial_equation--------
+
+    {
+        double roots[8] = {};
+        $unit_test(roots_match(roots, solve_cubic_equation(1, -6, 11, -6, roots), {1, 2, 3}), true);
+        $unit_test(roots_match(roots, solve_cubic_equation(2, 0, 0, -16, roots), {2}), true);
+        $unit_test(roots_match(roots, solve_cubic_equation(1, -3, 0, 4, roots), {-1, 2}), true);
+        $unit_test(roots_match(roots, solve_cubic_equation(1, -3, 3, -1, roots), {1}), true);
+        $unit_test(roots_match(roots, solve_cubic_equation(-1, 0, 7, 6, roots), {-2, -1, 3}), true);
+        $unit_test(roots_match(roots, solve_cubic_equation(0, 1, -5, 6, roots), {2, 3}), true);
+        $unit_test(solve_cubic_equation(0, 0, 0, 0, roots), INF_ROOTS);
+        $unit_test(std::isnan(roots[0]), true);
+
+        $unit_test(roots_match(roots, solve_quartic_equation(1, -10, 35, -50, 24, roots), {1, 2, 3, 4}), true);
+        $unit_test(roots_match(roots, solve_quartic_equation(1, 0, -5, 0, 4, roots), {-2, -1, 1, 2}), true);
+        $unit_test(roots_match(roots, solve_quartic_equation(1, 0, 0, 0, 1, roots), {}), true);
+        $unit_test(roots_match(roots, solve_quartic_equation(1, 0, 0, 0, -16, roots), {-2, 2}), true);
+        $unit_test(roots_match(roots, solve_quartic_equation(1, -2, 2, -2, 1, roots), {1}), true);
+        $unit_test(roots_match(roots, solve_quartic_equation(3, 6, -123, -126, 1080, roots), {-6, -4, 3, 5}), true);
+        $unit_test(roots_match(roots, solve_quartic_equation(0, 1, -6, 11, -6, roots), {1, 2, 3}), true);
+        $unit_test(std::isnan(roots[3]), true);
+
+        const double sextic[] = {1, -21, 175, -735, 1624, -1764, 720};
+        $unit_test(roots_match(roots, solve_polynomial_equation(sextic, 6, roots), {1, 2, 3, 4, 5, 6}), true);
+        const double quintic[] = {1, 0, 0, 0, 0, -32};
+        $unit_test(roots_match(roots, solve_polynomial_equation(quintic, 5, roots), {2}), true);
+        const double with_zeros[] = {0, 0, 1, -3, 2};
+        $unit_test(roots_match(roots, solve_polynomial_equation(with_zeros, 4, roots), {1, 2}), true);
+        $unit_test(std::isnan(roots[2]) && std::isnan(roots[3]), true);
+        const double zero[] = {0, 0, 0};
+        $unit_test(solve_polynomial_equation(zero, 2, roots), INF_ROOTS);
+
+        $unit_test(count_polynomial_mismatches(3, false, 1000), 0);
+        $unit_test(count_polynomial_mismatches(4, false, 1000), 0);
+        $unit_test(count_polynomial_mismatches(4, true, 1000), 0);
+        $unit_test(count_polynomial_mismatches(7, false, 200), 0);
+        $unit_test(count_polynomial_mismatches(8, true, 200), 0);
+
+        const double a[] = {1, 1, 0}, b[] = {-6, 0, 1}, c[] = {11, 0, -5}, d[] = {-6, -8, 6};
+        int nroots[3] = {};
+        double batch_roots[9] = {};
+        solve_cubic_equations(a, b, c, d, 3, nroots, batch_roots);
+        $unit_test(roots_match(batch_roots, nroots[0], {1, 2, 3}), true);
+        $unit_test(roots_match(batch_roots + 3, nroots[1], {2}), true);
+        $unit_test(roots_match(batch_roots + 6, nroots[2], {2, 3}), true);
+
+        $unit_test_sigabrt(solve_cubic_equation(NAN, 1, 1, 1, roots));
+        $unit_test_sigabrt(solve_quartic_equation(1, 1, 1, 1, INFINITY, roots));
+    }
+    std::cout << std::endl;
+
+
+    //--------run_work_stealing--------
+
+    $unit_test(count_work_stealing_errors(0, 4), 0);
+    $unit_test(count_work_stealing_errors(1, 4), 0);
+    $unit_test(count_work_stealing_errors(1000, 1), 0);
+    $unit_test(count_work_stealing_errors(1000, 7), 0);
+    std::cout << std::endl;
+
+
+    //--------solve_coefficient_file--------
+
+    $unit_test(solve_text_file("1,-5,6\n\n 1 , 2 , 1\r\n1,1,1\n0,0,0\n1,1e200,1\nnan,1,1", 4, CSV_COEFFICIENTS),
+               std::string("2,3,2\n1,-1,\n0,,\n-1,,\noverflow,,\nnot_finite_input,,\n"));
+    $unit_test(solve_text_file("", 4, CSV_COEFFICIENTS), std::string(""));
+    $unit_test(solve_text_file("1,2\n", 1, CSV_COEFFICIENTS), std::string("std::invalid_argument"));
+
+    {
+        std::string text, expected;
+        for (int i = 0; i < 200000; i++) {
+            text += "1," + std::to_string(-(i % 100) - 3) + "," + std::to_string(i % 100 + 2) + "\n";
+            expected += "2," + std::to_string(i % 100 + 2) + ",1\n";
+        }
+        $unit_test(solve_text_file(text, 4, CSV_COEFFICIENTS) == expected, true);
+
+        std::vector<double> coefficients;
+        for (int i = 0; i < 100000; i++) {
+            coefficients.insert(coefficients.end(), {1, -(double)(i % 100) - 3, (double)(i % 100) + 2});
+        }
+        std::string result = solve_text_file(std::string((const char *)coefficients.data(), coefficients.size() * sizeof(double)),
+                                             3, BINARY_COEFFICIENTS);
+        $unit_test(result.size(), 100000 * sizeof(solved_equation));
+        const solved_equation *records = (const solved_equation *)result.data();
+        volatile int wrong_records = 0;
+        for (int i = 0; i < 100000; i++) {
+            wrong_records += (records[i].nroots != 2 || records[i].status != SOLVER_OK ||
+                              std::fabs(records[i].first_root - (i % 100 + 2)) > 1e-9 || std::fabs(records[i].second_root - 1) > 1e-9);
+        }
+        $unit_test(wrong_records, 0);
+    }
+
+    $unit_test(count_root_columns_mismatches(200000, BINARY_COEFFICIENTS, COLUMNAR_RESULTS, 3), 0);
+    $unit_test(count_root_columns_mismatches(200000, BINARY_COEFFICIENTS, COLUMNAR_RESULTS_WITH_VALIDITY, 3), 0);
+    $unit_test(count_root_columns_mismatches(100001, CSV_COEFFICIENTS, COLUMNAR_RESULTS_WITH_VALIDITY, 4), 0);
+    $unit_test(count_root_columns_mismatches(77, CSV_COEFFICIENTS, COLUMNAR_RESULTS, 1), 0);
+    $unit_test(count_root_columns_mismatches(0, BINARY_COEFFICIENTS, COLUMNAR_RESULTS_WITH_VALIDITY, 1), 0);
+    $unit_test(solve_text_file("1,2\n", 1, CSV_COEFFICIENTS), std::string("std::invalid_argument"));
+    {
+        const char *path = "run_tests_roots.tmp";
+        {
+            root_columns columns(path, 3, true);
+            const int nroots[] = {2, 7, 0};
+            const double first_roots[] = {3, 1, NAN}, second_roots[] = {2, NAN, NAN};
+            const solver_status statuses[] = {SOLVER_OK, SOLVER_OVERFLOW, SOLVER_OK};
+            columns.write(1, 2, nroots + 1, first_roots + 1, second_roots + 1, statuses + 1);
+            columns.write(0, 1, nroots, first_roots, second_roots, statuses);
+        }
+        root_columns columns(path);
+        $unit_test(columns.size(), 3u);
+        $unit_test(columns.nroots()[0] == 2 && columns.nroots()[1] == 0 && columns.statuses()[1] == SOLVER_OVERFLOW, true);
+        $unit_test(columns.first_valid()[0] == 3 && columns.second_valid()[0] == 1, true);
+        $unit_test((uintptr_t)columns.first_roots() % ROOT_COLUMNS_ALIGNMENT, 0u);
+
+        FILE *file = fopen(path, "r+b");
+        assert(file != nullptr);
+        fseek(file, offsetof(root_columns_header, count), SEEK_SET);
+        const uint64_t wrong_count = 1000;
+        fwrite(&wrong_count, sizeof(wrong_count), 1, file);
+        fclose(file);
+        volatile bool thrown = false;
+        try {
+            root_columns damaged(path);
+        } catch (const std::invalid_argument &) {
+            thrown = true;
+        }
+        $unit_test(thrown, true);
+
+        file = fopen(path, "r+b");
+        assert(file != nullptr);
+        fseek(file, offsetof(root_columns_header, byte_order), SEEK_SET);
+        const uint32_t swapped_byte_order = 0x04030201;
+        fwrite(&swapped_byte_order, sizeof(swapped_byte_order), 1, file);
+        fclose(file);
+        thrown = false;
+        try {
+            root_columns swapped(path);
+        } catch (const std::invalid_argument &error) {
+            thrown = (std::string(error.what()).find("byte order") != std::string::npos);
+        }
+        $unit_test(thrown, true);
+        remove(path);
+    }
+    std::cout << std::endl;
+
+
+    //--------solver_service--------
+
+    {
+        latency_histogram histogram;
+        $unit_test(histogram.quantile(0.5), 0u);
+        for (uint64_t ns : {0, 1, 3, 100, 1000, 1000, 1000, 5000}) {
+            histogram.add(ns);
+        }
+        $unit_test(histogram.count(), 8u);
+        $unit_test(histogram.bucket(0) == 2 && histogram.bucket(1) == 1 && histogram.bucket(9) == 3, true);
+        $unit_test(histogram.quantile(0.5), 128u);
+        $unit_test(histogram.quantile(0.75), 1024u);
+        $unit_test(histogram.quantile(1), 5000u);
+
+        solver_service_stats stats;
+#ifndef _WIN32
+        $unit_test(count_service_mismatches(64, 100, 4, 20000, stats), 0);
+        $unit_test(stats.requests == 80000 && stats.connections == 4, true);
+        $unit_test(stats.latency.count() == 80000 && stats.wait.count() == 80000, true);
+        $unit_test(stats.batches >= 80000 / 64 && stats.full_batches > 0, true);
+
+        $unit_test(count_service_mismatches(1, 0, 2, 3000, stats), 0);
+        $unit_test(stats.batches == stats.requests && stats.requests == 6000, true);
+
+        $unit_test(count_service_mismatches(4096, 200, 1, 1, stats), 0); // the batch is solved after the timeout
+        $unit_test(stats.batches == 1 && stats.full_batches == 0 && stats.wait.quantile(1) >= 200000, true);
+
+        {
+            solver_service_config config;
+            config.socket_path = "run_tests_solver_service.sock";
+            solver_service service(config);
+            std::thread server([&] { service.run(); });
+            solver_client client(config.socket_path.c_str());
+            int nroots = 0;
+            $unit_test(client.try_solve(1, -5, 6, nroots, x1, x2), SOLVER_OK);
+            $unit_test(nroots == 2 && same_value(x1, 3.0) && same_value(x2, 2.0), true);
+            $unit_test(client.try_solve(1, NAN, 6, nroots, x1, x2), SOLVER_NOT_FINITE_INPUT);
+            service.stop();
+            server.join();
+        }
+#endif
+        volatile bool thrown = false;
+        try {
+            solver_client client("run_tests_no_such_socket.sock");
+        } catch (const std::runtime_error &) {
+            thrown = true;
+        }
+        $unit_test(thrown, true);
+    }
+    std::cout << std::endl;
+
+
     //--------solve_linear_equation--------
 
     $test_les(solve_linear_equation(0.5, 1, x1), 1, -2);
@@ -75,6 +1165,72 @@ int main() {
     $unit_test_sigabrt(solve_linear_equation(5, INFINITY, x1));
 
 
+    std::cout << std::endl;
+
+
+    //--------solve_linear_system, solve_tridiagonal_system--------
+
+    {
+        double solution[3] = {};
+        const double matrix2[] = {2, 1, 1, 3}, rhs2[] = {3, 5};
+        $unit_test(solve_linear_system<2>(matrix2, rhs2, solution), 1);
+        $f_unit_test(solution[0], 0.8, 1e-12);
+        $f_unit_test(solution[1], 1.4, 1e-12);
+        const double swapped[] = {0, 1, 1, 0}, rhs_swapped[] = {2, 3};
+        $unit_test(solve_linear_system<2>(swapped, rhs_swapped, solution), 1);
+        $unit_test(same_value(solution[0], 3.0) && same_value(solution[1], 2.0), true);
+        const double singular[] = {1, 2, 2, 4}, consistent[] = {1, 2}, inconsistent[] = {1, 3};
+        $unit_test(solve_linear_system<2>(singular, consistent, solution), INF_ROOTS);
+        $unit_test(std::isnan(solution[0]) && std::isnan(solution[1]), true);
+        $unit_test(solve_linear_system<2>(singular, inconsistent, solution), 0);
+        const double zero[9] = {}, zero_rhs[3] = {};
+        $unit_test(solve_linear_system<3>(zero, zero_rhs, solution), INF_ROOTS);
+        const double one[] = {0.5}, minus_one[] = {-1};
+        $unit_test(solve_linear_system<1>(one, minus_one, solution), 1);
+        $unit_test(same_value(solution[0], -2.0), true);
+
+        $unit_test(count_linear_system_errors<2>(10000), 0);
+        $unit_test(count_linear_system_errors<3>(10000), 0);
+        $unit_test(count_linear_system_errors<5>(10000), 0);
+        $unit_test(count_linear_system_errors<8>(10000), 0);
+
+        int nsolutions = 0;
+        const double huge[] = {1e-3, 0, 0, 1}, huge_rhs[] = {1e307, 1};
+        $unit_test(try_solve_linear_system<2>(huge, huge_rhs, nsolutions, solution), SOLVER_OVERFLOW);
+        const double not_finite[] = {1, NAN, 0, 1};
+        $unit_test(try_solve_linear_system<2>(not_finite, rhs2, nsolutions, solution), SOLVER_NOT_FINITE_INPUT);
+        $unit_test(nsolutions == 0 && std::isnan(solution[0]), true);
+        volatile bool thrown = false;
+        try {
+            solve_linear_system<2>(huge, huge_rhs, solution);
+        } catch (const std::runtime_error &) {
+            thrown = true;
+        }
+        $unit_test(thrown, true);
+        $unit_test_sigabrt(solve_linear_system<2>(not_finite, rhs2, solution));
+
+        const double lower[] = {0, 1, 1}, diagonal[] = {2, 2, 2}, upper[] = {1, 1, 0}, rhs3[] = {4, 8, 8};
+        $unit_test(solve_tridiagonal_system(lower, diagonal, upper, rhs3, 3, solution), 1);
+        $f_unit_test(solution[0], 1, 1e-12);
+        $f_unit_test(solution[1], 2, 1e-12);
+        $f_unit_test(solution[2], 3, 1e-12);
+        const double zero_diagonal[] = {0, 0, 1}; // the Thomas algorithm fails, the pivoting does not
+        const double rhs_zero_diagonal[] = {2, 1, 2};
+        $unit_test(solve_tridiagonal_system(lower, zero_diagonal, upper, rhs_zero_diagonal, 3, solution), 1);
+        $f_unit_test(solution[0], 1, 1e-12);
+        $f_unit_test(solution[1], 2, 1e-12);
+        $f_unit_test(solution[2], 0, 1e-12);
+        $unit_test(count_tridiagonal_mismatches<2>(2000), 0);
+        $unit_test(count_tridiagonal_mismatches<4>(5000), 0);
+        $unit_test(count_tridiagonal_mismatches<8>(5000), 0);
+        $unit_test(tridiagonal_error(100000, 1) < 1e-12, true);
+        $unit_test(tridiagonal_error(7, 10000) < 1e-12, true);
+        $unit_test(try_solve_tridiagonal_system(lower, diagonal, upper, not_finite, 3, nsolutions, solution), SOLVER_NOT_FINITE_INPUT);
+        $unit_test_sigabrt(solve_tridiagonal_system(lower, not_finite, upper, rhs3, 3, solution));
+    }
+    std::cout << std::endl;
+
+
     //-----------calculate_discriminant-----------
 
     $f_unit_test(calculate_discriminant(0.1, 3, 2), 9 - 0.8, 1e-5);
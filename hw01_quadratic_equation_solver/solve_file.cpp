@@ -0,0 +1,55 @@
+#include "coefficient_file_solver.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+
+static void print_usage(const char *program)
+{
+    fprintf(stderr, "Usage: %s [-b] [-c | -v] [-t threads] file_in file_out\n"
+                    "Solves quadratic equations a * x^2 + b * x + c = 0, which coefficients are in file_in,\n"
+                    "and writes their roots to file_out in the same order.\n"
+                    "  -b          file_in is an array of doubles a, b, c (otherwise file_in has \"a,b,c\" lines)\n"
+                    "  -c          file_out is a root columns file (see root_columns.h)\n"
+                    "  -v          file_out is a root columns file with validity bitmaps\n"
+                    "  -t threads  number of threads (by default, the number of hardware threads)\n", program);
+}
+
+int main(int argc, char *argv[])
+{
+    coefficient_file_format format = CSV_COEFFICIENTS;
+    result_file_format results = NATIVE_RESULTS;
+    unsigned nthreads = 0;
+    const char *paths[2] = {};
+    int npaths = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-b") == 0) {
+            format = BINARY_COEFFICIENTS;
+        } else if (strcmp(argv[i], "-c") == 0) {
+            results = COLUMNAR_RESULTS;
+        } else if (strcmp(argv[i], "-v") == 0) {
+            results = COLUMNAR_RESULTS_WITH_VALIDITY;
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            nthreads = (unsigned)strtoul(argv[++i], nullptr, 10);
+        } else if (argv[i][0] != '-' && npaths < 2) {
+            paths[npaths++] = argv[i];
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (npaths != 2) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    try {
+        solve_coefficient_file(paths[0], paths[1], format, nthreads, results);
+    } catch (const std::exception &e) {
+        fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
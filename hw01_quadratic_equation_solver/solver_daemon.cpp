@@ -0,0 +1,66 @@
+#include "solver_service.h"
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+
+static solver_service *running_service = nullptr;
+
+static void stop_service(int)
+{
+    if (running_service != nullptr) {
+        running_service->stop();
+    }
+}
+
+static void print_usage(const char *program)
+{
+    fprintf(stderr, "Usage: %s [-b batch_size] [-f flush_timeout_us] socket_path\n"
+                    "Solves quadratic equations sent by solver_client to the Unix domain socket, until SIGINT or SIGTERM,\n"
+                    "then prints the counters and latency histograms.\n"
+                    "  -b batch_size        the greatest number of equations solved at once (64 by default)\n"
+                    "  -f flush_timeout_us  the longest time a request waits for the batch to fill (100 by default)\n", program);
+}
+
+int main(int argc, char *argv[])
+{
+    solver_service_config config;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+            config.batch_size = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            config.flush_timeout_us = (unsigned)strtoul(argv[++i], nullptr, 10);
+        } else if (argv[i][0] != '-' && config.socket_path.empty()) {
+            config.socket_path = argv[i];
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (config.socket_path.empty() || config.batch_size == 0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    try {
+        solver_service service(config);
+        running_service = &service;
+        signal(SIGINT, stop_service);
+        signal(SIGTERM, stop_service);
+        service.run();
+        running_service = nullptr;
+
+        const solver_service_stats &stats = service.stats();
+        printf("requests %llu, batches %llu, full batches %llu, connections %llu\n",
+               (unsigned long long)stats.requests, (unsigned long long)stats.batches,
+               (unsigned long long)stats.full_batches, (unsigned long long)stats.connections);
+        stats.wait.print(stdout, "wait for the batch");
+        stats.latency.print(stdout, "latency");
+    } catch (const std::exception &e) {
+        fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
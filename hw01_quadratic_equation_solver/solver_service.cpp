@@ -0,0 +1,459 @@
+#include "solver_service.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(service_request) == 32 && sizeof(service_response) == 32, "records must have no padding");
+
+/* See description in solver_service.h */
+
+void latency_histogram::add(uint64_t ns)
+{
+    int i = 0;
+    while (i + 1 < NBUCKETS && (ns >> (i + 1)) != 0) {
+        i++;
+    }
+    buckets_[i]++;
+    count_++;
+    max_ = std::max(max_, ns);
+}
+
+/* See description in solver_service.h */
+
+uint64_t latency_histogram::quantile(double p) const
+{
+    assert(0 <= p && p <= 1);
+
+    if (count_ == 0) {
+        return 0;
+    }
+    uint64_t rank = std::max<uint64_t>(1, (uint64_t)std::ceil(p * count_)), seen = 0;
+    for (int i = 0; i < NBUCKETS; i++) {
+        seen += buckets_[i];
+        if (seen >= rank) {
+            return std::min(max_, (uint64_t)2 << i);
+        }
+    }
+    return max_;
+}
+
+/* See description in solver_service.h */
+
+void latency_histogram::print(FILE *stream, const char *name) const
+{
+    fprintf(stream, "%s: count %llu, p50 < %llu ns, p99 < %llu ns, p99.9 < %llu ns, max %llu ns\n", name,
+            (unsigned long long)count_, (unsigned long long)quantile(0.5), (unsigned long long)quantile(0.99),
+            (unsigned long long)quantile(0.999), (unsigned long long)max_);
+    for (int i = 0; i < NBUCKETS; i++) {
+        if (buckets_[i] != 0) {
+            fprintf(stream, "  [%llu, %llu) ns: %llu\n", (unsigned long long)(i == 0 ? 0 : (uint64_t)1 << i),
+                    (unsigned long long)((uint64_t)2 << i), (unsigned long long)buckets_[i]);
+        }
+    }
+}
+
+#ifndef _WIN32
+
+static std::string error_message(const char *what, const std::string &path)
+{
+    return std::string("solver_service: cannot ") + what + " " + path + ": " + strerror(errno);
+}
+
+/*
+Fills the address of the socket, throws std::runtime_error if the path is too long
+*/
+static sockaddr_un socket_address(const std::string &path)
+{
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("solver_service: bad socket path \"" + path + "\"");
+    }
+    memcpy(address.sun_path, path.c_str(), path.size());
+    return address;
+}
+
+static uint64_t nanoseconds_between(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to)
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count();
+}
+
+/* See description in solver_service.h */
+
+solver_service::solver_service(const solver_service_config &config) : config_(config)
+{
+    assert(config.batch_size > 0);
+
+    sockaddr_un address = socket_address(config.socket_path);
+    if (pipe(stop_pipe_) != 0) {
+        throw std::runtime_error(error_message("create the pipe for", config.socket_path));
+    }
+    fcntl(stop_pipe_[0], F_SETFL, O_NONBLOCK);
+    fcntl(stop_pipe_[1], F_SETFL, O_NONBLOCK);
+    listen_fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd_ == -1) {
+        std::string message = error_message("create", config.socket_path);
+        close(stop_pipe_[0]);
+        close(stop_pipe_[1]);
+        throw std::runtime_error(message);
+    }
+    unlink(config.socket_path.c_str());
+    if (bind(listen_fd_, (sockaddr *)&address, sizeof(address)) != 0 || listen(listen_fd_, SOMAXCONN) != 0) {
+        std::string message = error_message("listen to", config.socket_path);
+        close(listen_fd_);
+        close(stop_pipe_[0]);
+        close(stop_pipe_[1]);
+        throw std::runtime_error(message);
+    }
+    fcntl(listen_fd_, F_SETFL, O_NONBLOCK);
+
+    a_.reserve(config.batch_size);
+    b_.reserve(config.batch_size);
+    c_.reserve(config.batch_size);
+}
+
+solver_service::~solver_service()
+{
+    for (auto &item : connections_) {
+        close(item.second.fd);
+    }
+    close(listen_fd_);
+    unlink(config_.socket_path.c_str());
+    close(stop_pipe_[0]);
+    close(stop_pipe_[1]);
+}
+
+/* See description in solver_service.h */
+
+void solver_service::stop()
+{
+    char byte = 0;
+    ssize_t written = write(stop_pipe_[1], &byte, 1); // the pipe may be full only if stop is already called
+    (void)written;
+}
+
+/* See description in solver_service.h */
+
+void solver_service::run()
+{
+    const size_t max_output = 1 << 20;
+    std::vector<pollfd> fds;
+    std::vector<uint64_t> fd_connections;
+    bool stopped = false;
+
+    while (!stopped) {
+        fds.clear();
+        fd_connections.clear();
+        fds.push_back({stop_pipe_[0], POLLIN, 0});
+        fds.push_back({listen_fd_, POLLIN, 0});
+        for (auto &item : connections_) {
+            const connection &client = item.second;
+            short events = (client.output.size() - client.sent < max_output ? POLLIN : 0);
+            if (client.sent < client.output.size()) {
+                events |= POLLOUT;
+            }
+            fds.push_back({client.fd, events, 0});
+            fd_connections.push_back(item.first);
+        }
+
+        // wait until the oldest request has waited flush_timeout_us (ppoll, because poll does not wait less than a millisecond)
+        timespec timeout = {0, 0};
+        if (!received_.empty()) {
+            auto left = received_.front() + std::chrono::microseconds(config_.flush_timeout_us) - std::chrono::steady_clock::now();
+            if (left <= left.zero()) {
+                solve_pending();
+                continue;
+            }
+            uint64_t ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(left).count();
+            timeout.tv_sec = (time_t)(ns / 1000000000);
+            timeout.tv_nsec = (long)(ns % 1000000000);
+        }
+        int ready = ppoll(fds.data(), fds.size(), received_.empty() ? nullptr : &timeout, nullptr);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error(error_message("poll", config_.socket_path));
+        }
+
+        if (fds[0].revents != 0) {
+            stopped = true;
+        }
+        if (fds[1].revents & POLLIN) {
+            accept_connections();
+        }
+        for (size_t i = 2; i < fds.size(); i++) {
+            if (fds[i].revents == 0) {
+                continue;
+            }
+            uint64_t connection_id = fd_connections[i - 2];
+            connection &client = connections_[connection_id];
+            bool open = true;
+            if (fds[i].revents & POLLOUT) {
+                open = send_output(client);
+            }
+            if (open && (fds[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+                open = receive(connection_id, client);
+            }
+            if (!open) {
+                close(client.fd);
+                connections_.erase(connection_id);
+            }
+        }
+    }
+
+    while (!received_.empty()) {
+        solve_pending();
+    }
+    for (auto &item : connections_) { // best effort, the clients are not waited for
+        send_output(item.second);
+        close(item.second.fd);
+    }
+    connections_.clear();
+    char buffer[64];
+    while (read(stop_pipe_[0], buffer, sizeof(buffer)) > 0) { // so that run can be called again
+    }
+}
+
+/*
+Accepts all waiting clients
+*/
+void solver_service::accept_connections()
+{
+    for (;;) {
+        int fd = accept(listen_fd_, nullptr, nullptr);
+        if (fd == -1) {
+            return; // EAGAIN, or the client has gone before it was accepted
+        }
+        fcntl(fd, F_SETFL, O_NONBLOCK);
+        connections_[next_connection_id_++] = {fd, {}, {}, 0};
+        stats_.connections++;
+    }
+}
+
+/*
+Reads the requests of the client and puts them into the batch, returns false if the connection is closed
+*/
+bool solver_service::receive(uint64_t connection_id, connection &client)
+{
+    char buffer[1 << 14];
+    ssize_t size = recv(client.fd, buffer, sizeof(buffer), 0);
+    if (size == 0 || (size < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+        return false;
+    }
+    if (size < 0) {
+        return true;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    client.input.insert(client.input.end(), buffer, buffer + size);
+    size_t nrequests = client.input.size() / sizeof(service_request);
+    for (size_t i = 0; i < nrequests; i++) {
+        service_request request;
+        memcpy(&request, client.input.data() + i * sizeof(service_request), sizeof(request));
+        a_.push_back(request.a);
+        b_.push_back(request.b);
+        c_.push_back(request.c);
+        request_ids_.push_back(request.id);
+        connection_ids_.push_back(connection_id);
+        received_.push_back(now);
+        if (a_.size() == config_.batch_size) {
+            solve_pending();
+        }
+    }
+    client.input.erase(client.input.begin(), client.input.begin() + nrequests * sizeof(service_request));
+    return true;
+}
+
+/*
+Sends as many responses as the socket takes, returns false if the connection is closed
+*/
+bool solver_service::send_output(connection &client)
+{
+    while (client.sent < client.output.size()) {
+        ssize_t size = send(client.fd, client.output.data() + client.sent, client.output.size() - client.sent, MSG_NOSIGNAL);
+        if (size < 0) {
+            return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR);
+        }
+        client.sent += size;
+    }
+    client.output.clear();
+    client.sent = 0;
+    return true;
+}
+
+/*
+Solves the batch and sends the responses
+*/
+void solver_service::solve_pending()
+{
+    size_t n = a_.size();
+    std::vector<int> nroots(n);
+    std::vector<double> first_roots(n), second_roots(n);
+    std::vector<solver_status> statuses(n);
+    try_solve_quadratic_equations(a_.data(), b_.data(), c_.data(), n, nroots.data(), first_roots.data(),
+                                  second_roots.data(), statuses.data());
+    auto solved = std::chrono::steady_clock::now();
+    stats_.requests += n;
+    stats_.batches++;
+    stats_.full_batches += (n == config_.batch_size);
+
+    for (size_t i = 0; i < n; i++) {
+        stats_.wait.add(nanoseconds_between(received_[i], solved));
+        auto found = connections_.find(connection_ids_[i]);
+        if (found == connections_.end()) {
+            continue; // the client has gone
+        }
+        service_response response = {request_ids_[i], {nroots[i], statuses[i], first_roots[i], second_roots[i]}};
+        std::vector<char> &output = found->second.output;
+        output.insert(output.end(), (const char *)&response, (const char *)&response + sizeof(response));
+    }
+    for (size_t i = 0; i < n; i++) { // every client gets all its responses of the batch with one send
+        auto found = connections_.find(connection_ids_[i]);
+        if (found != connections_.end() && found->second.sent < found->second.output.size()) {
+            send_output(found->second); // a closed connection is found by poll
+        }
+    }
+    auto sent = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n; i++) {
+        stats_.latency.add(nanoseconds_between(received_[i], sent));
+    }
+
+    a_.clear();
+    b_.clear();
+    c_.clear();
+    request_ids_.clear();
+    connection_ids_.clear();
+    received_.clear();
+}
+
+/*
+Sends or receives exactly size bytes, throws std::runtime_error if the connection is closed
+*/
+static void transfer_all(int fd, char *data, size_t size, bool sending)
+{
+    while (size > 0) {
+        ssize_t done = (sending ? send(fd, data, size, MSG_NOSIGNAL) : recv(fd, data, size, 0));
+        if (done < 0 && errno == EINTR) {
+            continue;
+        }
+        if (done <= 0) {
+            throw std::runtime_error(std::string("solver_client: connection is closed: ") + (done == 0 ? "end of file" : strerror(errno)));
+        }
+        data += done;
+        size -= done;
+    }
+}
+
+/* See description in solver_service.h */
+
+solver_client::solver_client(const char *socket_path)
+{
+    assert(socket_path != nullptr);
+
+    sockaddr_un address = socket_address(socket_path);
+    fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd_ == -1) {
+        throw std::runtime_error(error_message("create", socket_path));
+    }
+    if (connect(fd_, (sockaddr *)&address, sizeof(address)) != 0) {
+        std::string message = error_message("connect to", socket_path);
+        close(fd_);
+        throw std::runtime_error(message);
+    }
+}
+
+solver_client::~solver_client()
+{
+    close(fd_);
+}
+
+#else
+
+solver_service::solver_service(const solver_service_config &config) : config_(config)
+{
+    throw std::runtime_error("solver_service: Unix domain sockets are not supported on this system");
+}
+
+solver_service::~solver_service()
+{
+}
+
+void solver_service::stop()
+{
+}
+
+void solver_service::run()
+{
+}
+
+solver_client::solver_client(const char *socket_path)
+{
+    throw std::runtime_error(std::string("solver_client: cannot connect to ") + socket_path +
+                             ": Unix domain sockets are not supported on this system");
+}
+
+solver_client::~solver_client()
+{
+}
+
+static void transfer_all(int, char *, size_t, bool)
+{
+}
+
+#endif
+
+/* See description in solver_service.h */
+
+solver_status solver_client::try_solve(double a, double b, double c, int &nroots, double &first_root, double &second_root)
+{
+    solver_status status = SOLVER_OK;
+    try_solve_many(&a, &b, &c, 1, &nroots, &first_root, &second_root, &status);
+    return status;
+}
+
+/* See description in solver_service.h */
+
+void solver_client::try_solve_many(const double *a, const double *b, const double *c, size_t n,
+                                   int *nroots, double *first_roots, double *second_roots, solver_status *statuses)
+{
+    assert(n == 0 || (a != nullptr && b != nullptr && c != nullptr));
+    assert(n == 0 || (nroots != nullptr && first_roots != nullptr && second_roots != nullptr && statuses != nullptr));
+
+    std::vector<service_request> requests;
+    std::vector<service_response> responses;
+    for (size_t from = 0; from < n; from += WINDOW) {
+        size_t count = std::min(WINDOW, n - from);
+        uint64_t first_id = next_id_;
+        requests.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            requests[i] = {next_id_++, a[from + i], b[from + i], c[from + i]};
+        }
+        responses.resize(count);
+        transfer_all(fd_, (char *)requests.data(), count * sizeof(service_request), true);
+        transfer_all(fd_, (char *)responses.data(), count * sizeof(service_response), false);
+        for (size_t i = 0; i < count; i++) {
+            if (responses[i].id != first_id + i) {
+                throw std::runtime_error("solver_client: got response " + std::to_string(responses[i].id) +
+                                         " instead of " + std::to_string(first_id + i));
+            }
+            nroots[from + i] = responses[i].result.nroots;
+            statuses[from + i] = (solver_status)responses[i].result.status;
+            first_roots[from + i] = responses[i].result.first_root;
+            second_roots[from + i] = responses[i].result.second_root;
+        }
+    }
+}
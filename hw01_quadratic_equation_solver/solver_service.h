@@ -0,0 +1,202 @@
+#ifndef __SOLVER_SERVICE_HEADER
+#define __SOLVER_SERVICE_HEADER
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "coefficient_file_solver.h"
+
+//! Request sent by a client of the solver service
+struct service_request
+{
+    uint64_t id;  //!< Any number chosen by the client, it is copied to the response
+    double a;     //!< The quadratic coefficient
+    double b;     //!< The linear coefficient
+    double c;     //!< The constant
+};
+
+//! Response of the solver service, responses to every client come in the order of its requests
+struct service_response
+{
+    uint64_t id;             //!< Id of the request
+    solved_equation result;  //!< Roots, as try_solve_quadratic_equation calculates them
+};
+
+
+///-------------------------------------------------------------------------------------
+//! Histogram of latencies with power of two buckets: bucket i counts latencies
+//! in \f$ [2^i, 2^{i + 1}) \f$ nanoseconds (bucket 0 also counts 0)
+//!
+///-------------------------------------------------------------------------------------
+class latency_histogram
+{
+public:
+    static const int NBUCKETS = 48;
+
+    //! Counts one latency
+    void add(uint64_t ns);
+
+    //! Number of counted latencies
+    uint64_t count() const { return count_; }
+
+    //! The greatest counted latency
+    uint64_t max() const { return max_; }
+
+    //! Number of latencies in the bucket
+    uint64_t bucket(int i) const { return buckets_[i]; }
+
+    //! Upper bound of the bucket, which contains the p-th quantile (0 <= p <= 1), 0 if nothing is counted
+    uint64_t quantile(double p) const;
+
+    //! Prints the quantiles and non-empty buckets, one per line
+    void print(FILE *stream, const char *name) const;
+
+private:
+    uint64_t buckets_[NBUCKETS] = {};
+    uint64_t count_ = 0;
+    uint64_t max_ = 0;
+};
+
+
+//! Settings of the solver service
+struct solver_service_config
+{
+    std::string socket_path;          //!< Path of the Unix domain socket (it is removed and created again)
+    size_t batch_size = 64;           //!< The greatest number of equations solved by one call of the solver
+    unsigned flush_timeout_us = 100;  //!< The longest time a request waits for the batch to fill
+};
+
+//! Counters of the solver service
+struct solver_service_stats
+{
+    uint64_t requests = 0;         //!< Number of solved requests
+    uint64_t batches = 0;          //!< Number of calls of the solver
+    uint64_t full_batches = 0;     //!< Number of calls with @c batch_size equations
+    uint64_t connections = 0;      //!< Number of accepted clients
+    latency_histogram wait;        //!< Time from receiving a request to solving its batch
+    latency_histogram latency;     //!< Time from receiving a request to sending its response
+};
+
+
+///-------------------------------------------------------------------------------------
+//! Local daemon, that solves quadratic equations for many client processes.
+//! Clients connect to a Unix domain socket and send @c service_request records,
+//! the service answers with @c service_response records.
+//!
+//! @note Requests of all clients are collected into one batch, which is solved with
+//!       @c try_solve_quadratic_equations (with SIMD instructions), as soon as it has
+//!       @c batch_size equations or its oldest request has waited @c flush_timeout_us.
+//!       So the latency is bounded by the timeout, and under load the solver gets full batches.
+//!
+//! @note All clients are served by the thread that calls @c run, with nonblocking sockets and poll.
+//!       A client that does not read its responses stops being read, when its unsent responses
+//!       take more than a megabyte.
+//!
+//! @note Unix domain sockets are supported on POSIX systems, on other systems the constructor
+//!       throws std::runtime_error. Errors are reported with std::runtime_error.
+//!
+///-------------------------------------------------------------------------------------
+class solver_service
+{
+public:
+///-------------------------------------------------------------------------------------
+//! Creates the socket and starts listening to it
+//!
+//! @param [in] config  Settings, @c batch_size must be positive
+//!
+///-------------------------------------------------------------------------------------
+    explicit solver_service(const solver_service_config &config);
+
+    ~solver_service();
+
+    solver_service(const solver_service &) = delete;
+    solver_service &operator=(const solver_service &) = delete;
+
+///-------------------------------------------------------------------------------------
+//! Serves the clients until @c stop is called, then solves and sends the collected requests
+//! and closes all connections
+//!
+///-------------------------------------------------------------------------------------
+    void run();
+
+    //! Makes @c run return, can be called from another thread or a signal handler
+    void stop();
+
+    //! Counters, they can be read after @c run has returned
+    const solver_service_stats &stats() const { return stats_; }
+
+private:
+    typedef std::chrono::steady_clock::time_point time_point;
+
+    struct connection
+    {
+        int fd;
+        std::vector<char> input;   // received bytes of an incomplete request
+        std::vector<char> output;  // responses that are not sent yet
+        size_t sent;               // number of sent bytes of output
+    };
+
+    void accept_connections();
+    bool receive(uint64_t connection_id, connection &client);
+    bool send_output(connection &client);
+    void solve_pending();
+
+    solver_service_config config_;
+    solver_service_stats stats_;
+    int listen_fd_ = -1;
+    int stop_pipe_[2] = {-1, -1};
+    uint64_t next_connection_id_ = 0;
+    std::unordered_map<uint64_t, connection> connections_;
+
+    // requests of the next batch
+    std::vector<double> a_, b_, c_;
+    std::vector<uint64_t> request_ids_, connection_ids_;
+    std::vector<time_point> received_;
+};
+
+
+///-------------------------------------------------------------------------------------
+//! Connection to the solver service
+//!
+//! @note Errors are reported with std::runtime_error
+//!
+///-------------------------------------------------------------------------------------
+class solver_client
+{
+public:
+    //! Connects to the service listening to the socket
+    explicit solver_client(const char *socket_path);
+
+    ~solver_client();
+
+    solver_client(const solver_client &) = delete;
+    solver_client &operator=(const solver_client &) = delete;
+
+///-------------------------------------------------------------------------------------
+//! Solves the equation like @c try_solve_quadratic_equation, but in the service
+//!
+///-------------------------------------------------------------------------------------
+    solver_status try_solve(double a, double b, double c, int &nroots, double &first_root, double &second_root);
+
+///-------------------------------------------------------------------------------------
+//! Solves @c n equations like @c try_solve_quadratic_equations, but in the service
+//!
+//! @note Requests are sent without waiting for the responses (at most @c WINDOW requests
+//!       are not answered at a time), so the service can put them into one batch.
+//!
+///-------------------------------------------------------------------------------------
+    void try_solve_many(const double *a, const double *b, const double *c, size_t n,
+                        int *nroots, double *first_roots, double *second_roots, solver_status *statuses);
+
+    static const size_t WINDOW = 1024;
+
+private:
+    int fd_ = -1;
+    uint64_t next_id_ = 0;
+};
+
+#endif
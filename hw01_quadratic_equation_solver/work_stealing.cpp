@@ -0,0 +1,153 @@
+#include "work_stealing.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace work_stealing_details
+{
+/*
+Range of task numbers [begin, end) of one thread packed into one 64-bit word, so that
+the owner (taking from the front) and thieves (taking from the back) can change it
+with a single compare-and-swap. Ranges are aligned to the cache line size, so that
+threads do not slow each other down by writing to the same cache line.
+*/
+    struct alignas(64) task_range
+    {
+        std::atomic<uint64_t> bounds;
+    };
+
+    inline uint64_t pack(uint64_t begin, uint64_t end)
+    {
+        return (begin << 32) | end;
+    }
+
+    inline uint64_t range_begin(uint64_t bounds)
+    {
+        return bounds >> 32;
+    }
+
+    inline uint64_t range_end(uint64_t bounds)
+    {
+        return bounds & 0xffffffffu;
+    }
+
+/*
+Takes the first task from the range of the thread. Returns false if the range is empty.
+*/
+    bool pop_front(task_range &range, size_t &task)
+    {
+        uint64_t bounds = range.bounds.load();
+        while (range_begin(bounds) < range_end(bounds)) {
+            if (range.bounds.compare_exchange_weak(bounds, pack(range_begin(bounds) + 1, range_end(bounds)))) {
+                task = range_begin(bounds);
+                return true;
+            }
+        }
+        return false;
+    }
+
+/*
+Moves the back half of the largest range of other threads to the (empty) range of the thread.
+Returns false if all ranges are empty.
+*/
+    bool steal(task_range *ranges, unsigned nthreads, unsigned thief)
+    {
+        while (true) {
+            unsigned victim = nthreads;
+            uint64_t victim_size = 0;
+            for (unsigned i = 0; i < nthreads; i++) {
+                uint64_t bounds = ranges[i].bounds.load();
+                uint64_t size = (range_begin(bounds) < range_end(bounds) ? range_end(bounds) - range_begin(bounds) : 0);
+                if (i != thief && size > victim_size) {
+                    victim = i;
+                    victim_size = size;
+                }
+            }
+            if (victim == nthreads) {
+                return false;
+            }
+
+            uint64_t bounds = ranges[victim].bounds.load();
+            uint64_t begin = range_begin(bounds), end = range_end(bounds);
+            if (begin >= end) {
+                continue;
+            }
+            uint64_t middle = end - (end - begin + 1) / 2;
+            if (ranges[victim].bounds.compare_exchange_strong(bounds, pack(begin, middle))) {
+                ranges[thief].bounds.store(pack(middle, end));
+                return true;
+            }
+        }
+    }
+}
+
+
+/* See description in work_stealing.h */
+
+void run_work_stealing(size_t ntasks, unsigned nthreads, const std::function<void(size_t)> &task)
+{
+    using namespace work_stealing_details;
+
+    if (ntasks > 0xffffffffu) {
+        throw std::invalid_argument("run_work_stealing: too many tasks");
+    }
+    if (nthreads == 0) {
+        nthreads = std::thread::hardware_concurrency();
+    }
+    if (nthreads == 0) {
+        nthreads = 1;
+    }
+    if (nthreads > ntasks) {
+        nthreads = (ntasks > 0 ? (unsigned)ntasks : 1);
+    }
+
+    std::unique_ptr<task_range[]> ranges(new task_range[nthreads]);
+    for (unsigned i = 0; i < nthreads; i++) {
+        ranges[i].bounds.store(pack(ntasks * i / nthreads, ntasks * (i + 1) / nthreads));
+    }
+
+    std::atomic<bool> stop(false);
+    std::exception_ptr exception = nullptr;
+    std::mutex exception_mutex;
+
+    auto worker = [&](unsigned id) {
+        size_t cur_task = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (!pop_front(ranges[id], cur_task)) {
+                if (steal(ranges.get(), nthreads, id)) {
+                    continue;
+                }
+                break;
+            }
+            try {
+                task(cur_task);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(exception_mutex);
+                if (exception == nullptr) {
+                    exception = std::current_exception();
+                }
+                stop.store(true);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < nthreads; i++) {
+        threads.emplace_back(worker, i);
+    }
+    worker(0);
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    if (exception != nullptr) {
+        std::rethrow_exception(exception);
+    }
+}
@@ -0,0 +1,23 @@
+#ifndef __WORK_STEALING_HEADER
+#define __WORK_STEALING_HEADER
+
+#include <cstddef>
+#include <functional>
+
+///-------------------------------------------------------------------------------------
+//! Runs @c task(0), ..., @c task(ntasks - 1) on @c nthreads threads
+//!
+//! @param [in] ntasks    Number of tasks
+//! @param [in] nthreads  Number of threads (0 means std::thread::hardware_concurrency())
+//! @param [in] task      Function that performs the task with the given number
+//!
+//! @note Every thread gets a contiguous range of task numbers and takes tasks from its front.
+//!       A thread that has finished its range steals the back half of the largest range of
+//!       another thread, so threads stay busy even if tasks take different time.
+//!       If a task throws an exception, the tasks that have not started are skipped and
+//!       the exception is rethrown after all threads have finished.
+//!
+///-------------------------------------------------------------------------------------
+void run_work_stealing(size_t ntasks, unsigned nthreads, const std::function<void(size_t)> &task);
+
+#endif
@@ -0,0 +1,183 @@
+#include <cassert>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "collation_keys.h"
+#include "utf8_symbols.h"
+
+namespace collation_keys_details
+{
+    constexpr char16_t unicode_ru_big_a = 0x410;
+    constexpr char16_t unicode_ru_big_ya = 0x42f;
+    constexpr char16_t unicode_ru_little_a = 0x430;
+    constexpr char16_t unicode_ru_little_ye = 0x435;
+    constexpr char16_t unicode_ru_little_ya = 0x44f;
+    constexpr char16_t unicode_ru_big_yo = 0x401;
+    constexpr char16_t unicode_ru_little_yo = 0x451;
+
+    // Russian letters are coded from ru_code_a to ru_code_a + 32, yo is ru_code_yo (right after ye)
+    constexpr unsigned char ru_code_a = 0x40;
+    constexpr unsigned char ru_code_yo = ru_code_a + (unicode_ru_little_ye - unicode_ru_little_a) + 1;
+
+/*
+Returns the byte of the English letter or the digit c in the key, 0 if c is skipped
+*/
+    inline unsigned char en_code(char16_t c)
+    {
+        if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z')) {
+            return (unsigned char)c;
+        }
+        if (c >= 'A' && c <= 'Z') {
+            return (unsigned char)(c - 'A' + 'a');
+        }
+        return 0;
+    }
+
+/*
+Returns the byte of the Russian letter or the digit c in the key, 0 if c is skipped
+*/
+    inline unsigned char ru_code(char16_t c)
+    {
+        if (c >= '0' && c <= '9') {
+            return (unsigned char)c;
+        }
+        if (c == unicode_ru_big_yo || c == unicode_ru_little_yo) {
+            return ru_code_yo;
+        }
+        if (c >= unicode_ru_big_a && c <= unicode_ru_big_ya) {
+            c += unicode_ru_little_a - unicode_ru_big_a;
+        }
+        if (c >= unicode_ru_little_a && c <= unicode_ru_little_ya) {
+            return (unsigned char)(ru_code_a + (c - unicode_ru_little_a) + (c > unicode_ru_little_ye ? 1 : 0));
+        }
+        return 0;
+    }
+
+/*
+Writes the key of the line to out, returns its size
+*/
+    template<unsigned char (*code)(char16_t)>
+    size_t make_key(const std::basic_string_view<char16_t> &line, bool reverse, unsigned char *out)
+    {
+        size_t size = 0;
+        if (reverse) {
+            for (size_t i = line.size(); i > 0; i--) {
+                unsigned char byte = code(line[i - 1]);
+                out[size] = byte;
+                size += (byte != 0);
+            }
+        } else {
+            for (size_t i = 0; i < line.size(); i++) {
+                unsigned char byte = code(line[i]);
+                out[size] = byte;
+                size += (byte != 0);
+            }
+        }
+        return size;
+    }
+
+/*
+Writes the key of the UTF-8 line to out, returns its size
+*/
+    template<unsigned char (*code)(char16_t)>
+    size_t make_key(const std::string_view &line, bool reverse, unsigned char *out)
+    {
+        size_t size = 0;
+        if (reverse) {
+            for (size_t end = line.size(); end > 0; ) {
+                unsigned char byte = code(prev_utf8_symbol(line, end));
+                out[size] = byte;
+                size += (byte != 0);
+            }
+        } else {
+            for (size_t i = 0; i < line.size(); ) {
+                unsigned char byte = code(next_utf8_symbol(line, i));
+                out[size] = byte;
+                size += (byte != 0);
+            }
+        }
+        return size;
+    }
+
+    inline uint64_t big_endian_prefix(const unsigned char *data, size_t size)
+    {
+        uint64_t prefix = 0;
+        for (size_t i = 0; i < 8; i++) {
+            prefix = (prefix << 8) | (i < size ? data[i] : 0);
+        }
+        return prefix;
+    }
+}
+
+
+/* See description in collation_keys.h */
+
+collation_keys::collation_keys(const std::vector< std::basic_string_view<char16_t> > &lines, language lang, bool reverse)
+{
+    make_keys(lines, lang, reverse);
+}
+
+
+/* See description in collation_keys.h */
+
+collation_keys::collation_keys(const std::vector<std::string_view> &lines, language lang, bool reverse)
+{
+    make_keys(lines, lang, reverse);
+}
+
+template<typename Char>
+void collation_keys::make_keys(const std::vector< std::basic_string_view<Char> > &lines, language lang, bool reverse)
+{
+    using namespace collation_keys_details;
+
+    keys_.resize(lines.size());
+    size_t total_size = 0;
+    for (const std::basic_string_view<Char> &line : lines) {
+        total_size += line.size();
+    }
+    arena_.resize(total_size + 1); // make_key writes one byte after the key
+
+    size_t offset = 0;
+    for (size_t i = 0; i < lines.size(); i++) {
+        unsigned char *key = arena_.data() + offset;
+        size_t size = (lang == ENGLISH ? make_key<en_code>(lines[i], reverse, key) : make_key<ru_code>(lines[i], reverse, key));
+        keys_[i] = {big_endian_prefix(key, size), key, (uint32_t)size, (uint32_t)i};
+        offset += size;
+    }
+}
+
+
+/* See description in collation_keys.h */
+
+int compare_collation_keys(const collation_key &key1, const collation_key &key2)
+{
+    if (key1.prefix != key2.prefix) {
+        return (key1.prefix < key2.prefix ? -1 : 1);
+    }
+    // the key bytes are not 0, so equal prefixes mean that both keys are shorter than 8 bytes or both begin with the same 8 bytes
+    size_t size = (key1.size < key2.size ? key1.size : key2.size);
+    size_t i = (size < 8 ? size : 8);
+#ifdef __SSE2__
+    for (; i + 16 <= size; i += 16) {
+        __m128i bytes1 = _mm_loadu_si128((const __m128i *)(key1.data + i));
+        __m128i bytes2 = _mm_loadu_si128((const __m128i *)(key2.data + i));
+        unsigned different = ~(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes1, bytes2)) & 0xffff;
+        if (different != 0) {
+            size_t j = i + __builtin_ctz(different);
+            return (key1.data[j] < key2.data[j] ? -1 : 1);
+        }
+    }
+#endif
+    for (; i < size; i++) {
+        if (key1.data[i] != key2.data[i]) {
+            return (key1.data[i] < key2.data[i] ? -1 : 1);
+        }
+    }
+    if (key1.size == key2.size) {
+        return 0;
+    }
+    return (key1.size < key2.size ? -1 : 1);
+}
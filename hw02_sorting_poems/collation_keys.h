@@ -0,0 +1,79 @@
+#ifndef __COLLATION_KEYS_FOR_ONEGIN
+#define __COLLATION_KEYS_FOR_ONEGIN
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "text_sorting.h"
+
+///-------------------------------------------------------------------------------------
+//! Collation key of a line: the letters of the language and digits of the line, in bytes which
+//! compare in the same order as @c compare_en_strings (@c compare_ru_strings) compares the symbols.
+//!
+///-------------------------------------------------------------------------------------
+struct collation_key
+{
+    uint64_t prefix;            //!< The first 8 bytes of the key in big-endian order (zeros after the end of the key)
+    const unsigned char *data;  //!< The key
+    uint32_t size;              //!< Number of bytes in the key
+    uint32_t index;             //!< Index of the line
+};
+
+///-------------------------------------------------------------------------------------
+//! Collation keys of the lines, stored one after another in one buffer
+//!
+///-------------------------------------------------------------------------------------
+class collation_keys
+{
+public:
+///-------------------------------------------------------------------------------------
+//! Makes the keys of all the lines
+//!
+//! @param [in] lines    The lines
+//! @param [in] lang     The language of the text
+//! @param [in] reverse  Whether to make keys of the reversed lines (for @c compare_en_strings_r and @c compare_ru_strings_r)
+//!
+//! @note Not English (Russian) letters and not digits are skipped, letters are lowercased, Russian yo goes
+//!       between ye and zhe. Digits are less than letters, like in the comparators.
+//!
+///-------------------------------------------------------------------------------------
+    collation_keys(const std::vector< std::basic_string_view<char16_t> > &lines, language lang, bool reverse);
+
+///-------------------------------------------------------------------------------------
+//! Makes the keys of all the UTF-8 lines, the keys are the same as of the same lines in UTF-16
+//!
+//! @param [in] lines    The lines
+//! @param [in] lang     The language of the text
+//! @param [in] reverse  Whether to make keys of the reversed lines
+//!
+//! @note Symbols are decoded with @c next_utf8_symbol and @c prev_utf8_symbol (see utf8_symbols.h):
+//!       ASCII bytes are taken as they are, only two-byte symbols are decoded.
+//!
+///-------------------------------------------------------------------------------------
+    collation_keys(const std::vector<std::string_view> &lines, language lang, bool reverse);
+
+    //! Keys in the order of the lines
+    std::vector<collation_key> &keys() { return keys_; }
+
+private:
+    template<typename Char>
+    void make_keys(const std::vector< std::basic_string_view<Char> > &lines, language lang, bool reverse);
+
+    std::vector<unsigned char> arena_;
+    std::vector<collation_key> keys_;
+};
+
+///-------------------------------------------------------------------------------------
+//! Compares two collation keys byte by byte (16 bytes at a time with SSE2)
+//!
+//! @param [in] key1  First key
+//! @param [in] key2  Second key
+//!
+//! @return -1 if key1 is less than key2. 1 if key1 is greater than key2. 0 if they are equal.
+//!         The result is the same as of the comparator of the lines, which keys are compared.
+//!
+///-------------------------------------------------------------------------------------
+int compare_collation_keys(const collation_key &key1, const collation_key &key2);
+
+#endif
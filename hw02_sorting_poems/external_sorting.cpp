@@ -0,0 +1,451 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "external_sorting.h"
+#include "collation_keys.h"
+#include "mapped_file.h"
+#include "line_splitting.h"
+#include "parallel_sort.h"
+
+namespace external_sorting_details
+{
+    constexpr size_t min_memory_budget = 1 << 12;
+    //! Every run being merged gets a buffer of at least this size, that limits the number of runs merged at once
+    constexpr size_t min_merge_buffer = 1 << 16;
+    //! Memory for a line besides its view and key bytes: the collation key and its copy in the merge buffer of parallel_sort
+    constexpr size_t line_overhead = 2 * sizeof(collation_key);
+    //! The views of the lines of a run are reserved at once and take at most 1 / views_share of the budget
+    constexpr size_t views_share = 4;
+
+///-------------------------------------------------------------------------------------
+//! Splits the mapped text into lines one by one, checking it like @c data_to_strings
+//!
+///-------------------------------------------------------------------------------------
+    class line_scanner
+    {
+    public:
+        line_scanner(const char16_t *data, size_t size) : data_(data), size_(size)
+        {
+            if (size_ == 0 || data_[0] == 0xfffe) {
+                throw std::invalid_argument(size_ == 0 ? "sort_text_external: file has no byte order mask"
+                                                       : "sort_text_external: file has incorrect endianness");
+            }
+            if (data_[0] != 0xfeff) {
+                throw std::invalid_argument("sort_text_external: file has no byte order mask");
+            }
+            pos_ = 1;
+        }
+
+        //! Writes the next line to @c line, returns false if there are no more lines
+        bool next(std::basic_string_view<char16_t> &line)
+        {
+            if (done_) {
+                return false;
+            }
+            size_t end = find_line_end(data_, pos_, size_);
+            line = {data_ + pos_, end - pos_};
+            pos_ = end + 2;
+            done_ = (end == size_);
+            return true;
+        }
+
+    private:
+        const char16_t *data_;
+        size_t size_;
+        size_t pos_ = 0;
+        bool done_ = false;
+    };
+
+///-------------------------------------------------------------------------------------
+//! Paths of the temporary files, the files are removed in the destructor
+//!
+///-------------------------------------------------------------------------------------
+    class temp_files
+    {
+    public:
+        explicit temp_files(const char *prefix) : prefix_(prefix) {}
+
+        ~temp_files()
+        {
+            for (const std::string &path : paths_) {
+                remove(path.c_str()); // the merged runs are already removed, errors are not important
+            }
+        }
+
+        temp_files(const temp_files &) = delete;
+        temp_files &operator=(const temp_files &) = delete;
+
+        //! Returns a new path
+        std::string create()
+        {
+            paths_.push_back(prefix_ + ".run" + std::to_string(paths_.size()) + ".tmp");
+            return paths_.back();
+        }
+
+    private:
+        std::string prefix_;
+        std::vector<std::string> paths_;
+    };
+
+///-------------------------------------------------------------------------------------
+//! Buffered output file
+//!
+///-------------------------------------------------------------------------------------
+    class output_file
+    {
+    public:
+        output_file(const std::string &path, size_t buffer_size) : path_(path), buffer_(buffer_size)
+        {
+            file_ = fopen(path.c_str(), "wb");
+            if (file_ == nullptr) {
+                throw std::runtime_error("sort_text_external: cannot open " + path);
+            }
+            setvbuf(file_, buffer_.data(), _IOFBF, buffer_.size());
+        }
+
+        ~output_file()
+        {
+            if (file_ != nullptr) {
+                fclose(file_);
+            }
+        }
+
+        output_file(const output_file &) = delete;
+        output_file &operator=(const output_file &) = delete;
+
+        void write(const void *data, size_t size)
+        {
+            if (fwrite(data, 1, size, file_) != size) {
+                throw std::runtime_error("sort_text_external: error occurred while writing in " + path_);
+            }
+        }
+
+        void close()
+        {
+            int res = fclose(file_);
+            file_ = nullptr;
+            if (res != 0) {
+                throw std::runtime_error("sort_text_external: cannot close " + path_);
+            }
+        }
+
+    private:
+        std::string path_;
+        std::vector<char> buffer_;
+        FILE *file_ = nullptr;
+    };
+
+///-------------------------------------------------------------------------------------
+//! Writes records of a run: the size of the key, the size of the line (uint32_t), the key, the line
+//!
+///-------------------------------------------------------------------------------------
+    class run_writer
+    {
+    public:
+        run_writer(const std::string &path, size_t buffer_size) : file_(path, buffer_size) {}
+
+        void write(const unsigned char *key, size_t key_size, const char16_t *line, size_t line_size)
+        {
+            if (line_size > UINT32_MAX) {
+                throw std::invalid_argument("sort_text_external: too long line in file_in_path");
+            }
+            uint32_t sizes[2] = {(uint32_t)key_size, (uint32_t)line_size};
+            file_.write(sizes, sizeof(sizes));
+            file_.write(key, key_size);
+            file_.write(line, line_size * sizeof(line[0]));
+        }
+
+        void close() { file_.close(); }
+
+    private:
+        output_file file_;
+    };
+
+///-------------------------------------------------------------------------------------
+//! Writes lines of the text: the byte order mask, then the lines separated by "\r\n"
+//!
+///-------------------------------------------------------------------------------------
+    class text_writer
+    {
+    public:
+        text_writer(const std::string &path, size_t buffer_size) : file_(path, buffer_size)
+        {
+            char16_t bom = 0xfeff;
+            file_.write(&bom, sizeof(bom));
+        }
+
+        void write(const unsigned char *, size_t, const char16_t *line, size_t line_size)
+        {
+            const char16_t endline[2] = {'\r', '\n'};
+            if (!first_) {
+                file_.write(endline, sizeof(endline));
+            }
+            first_ = false;
+            file_.write(line, line_size * sizeof(line[0]));
+        }
+
+        void close() { file_.close(); }
+
+    private:
+        output_file file_;
+        bool first_ = true;
+    };
+
+///-------------------------------------------------------------------------------------
+//! Reads records of a run one by one
+//!
+///-------------------------------------------------------------------------------------
+    class run_reader
+    {
+    public:
+        run_reader(const std::string &path, size_t buffer_size) : path_(path), buffer_(buffer_size)
+        {
+            file_ = fopen(path.c_str(), "rb");
+            if (file_ == nullptr) {
+                throw std::runtime_error("sort_text_external: cannot open " + path);
+            }
+            setvbuf(file_, buffer_.data(), _IOFBF, buffer_.size());
+            next();
+        }
+
+        ~run_reader()
+        {
+            fclose(file_);
+        }
+
+        run_reader(const run_reader &) = delete;
+        run_reader &operator=(const run_reader &) = delete;
+
+        //! Reads the next record, @c done() becomes true after the last one
+        void next()
+        {
+            uint32_t sizes[2] = {};
+            size_t nread = fread(sizes, 1, sizeof(sizes), file_);
+            if (nread == 0 && feof(file_)) {
+                done_ = true;
+                return;
+            }
+            key_.resize(sizes[0]);
+            line_.resize(sizes[1]);
+            if (nread != sizeof(sizes) || fread(key_.data(), 1, key_.size(), file_) != key_.size() ||
+                fread(line_.data(), sizeof(line_[0]), line_.size(), file_) != line_.size()) {
+                throw std::runtime_error("sort_text_external: error occurred while reading " + path_);
+            }
+        }
+
+        bool done() const { return done_; }
+        const std::vector<unsigned char> &key() const { return key_; }
+        const std::vector<char16_t> &line() const { return line_; }
+
+    private:
+        std::string path_;
+        std::vector<char> buffer_;
+        FILE *file_ = nullptr;
+        bool done_ = false;
+        std::vector<unsigned char> key_;
+        std::vector<char16_t> line_;
+    };
+
+///-------------------------------------------------------------------------------------
+//! Tree of losers over the current records of the runs: the winner (the least record) is in the root,
+//! every other node keeps the loser of the match between the winners of its subtrees. When the winner
+//! run goes to its next record, only the matches on the path from its leaf to the root are replayed.
+//!
+//! @note Exhausted runs lose to any record, equal keys are won by the run with the less index
+//!       (the run with the earlier lines of the file).
+//!
+///-------------------------------------------------------------------------------------
+    class loser_tree
+    {
+    public:
+        explicit loser_tree(const std::vector< std::unique_ptr<run_reader> > &runs) : runs_(runs), tree_(runs.size())
+        {
+            const size_t k = runs_.size();
+            assert(k > 0);
+            // winners[node] is the winner of the subtree of node, the leaf of run i is k + i
+            std::vector<size_t> winners(2 * k);
+            for (size_t i = 0; i < k; i++) {
+                winners[k + i] = i;
+            }
+            for (size_t node = k - 1; node >= 1; node--) {
+                size_t left = winners[2 * node], right = winners[2 * node + 1];
+                bool left_wins = less(left, right);
+                winners[node] = (left_wins ? left : right);
+                tree_[node] = (left_wins ? right : left);
+            }
+            tree_[0] = (k > 1 ? winners[1] : 0);
+        }
+
+        //! The run with the least record (it is done, if all the runs are done)
+        size_t winner() const { return tree_[0]; }
+
+        //! Restores the tree after the winner run went to its next record
+        void replay()
+        {
+            size_t winner = tree_[0];
+            for (size_t node = (runs_.size() + winner) / 2; node >= 1; node /= 2) {
+                if (less(tree_[node], winner)) {
+                    std::swap(tree_[node], winner);
+                }
+            }
+            tree_[0] = winner;
+        }
+
+    private:
+        bool less(size_t run1, size_t run2) const
+        {
+            if (runs_[run1]->done() || runs_[run2]->done()) {
+                return !runs_[run1]->done() || (runs_[run2]->done() && run1 < run2);
+            }
+            const std::vector<unsigned char> &key1 = runs_[run1]->key(), &key2 = runs_[run2]->key();
+            int res = memcmp(key1.data(), key2.data(), std::min(key1.size(), key2.size()));
+            if (res != 0) {
+                return res < 0;
+            }
+            if (key1.size() != key2.size()) {
+                return key1.size() < key2.size();
+            }
+            return run1 < run2;
+        }
+
+        const std::vector< std::unique_ptr<run_reader> > &runs_;
+        std::vector<size_t> tree_;
+    };
+
+///-------------------------------------------------------------------------------------
+//! Merges the runs (in the order of the lines of the file) to @c out, removes them
+//!
+///-------------------------------------------------------------------------------------
+    template<typename Writer>
+    void merge_runs(const std::vector<std::string> &paths, size_t memory_budget, Writer &out)
+    {
+        const size_t buffer_size = std::max(memory_budget / (paths.size() + 1), min_merge_buffer);
+        std::vector< std::unique_ptr<run_reader> > runs;
+        for (const std::string &path : paths) {
+            runs.emplace_back(new run_reader(path, buffer_size));
+        }
+        loser_tree tree(runs);
+        for (run_reader *run = runs[tree.winner()].get(); !run->done(); run = runs[tree.winner()].get()) {
+            out.write(run->key().data(), run->key().size(), run->line().data(), run->line().size());
+            run->next();
+            tree.replay();
+        }
+        runs.clear();
+        for (const std::string &path : paths) {
+            remove(path.c_str());
+        }
+    }
+
+///-------------------------------------------------------------------------------------
+//! Sorts the part of the lines by their keys and writes it to a new run
+//!
+///-------------------------------------------------------------------------------------
+    void write_run(const std::vector< std::basic_string_view<char16_t> > &lines, language lang, bool reverse, const std::string &path)
+    {
+        collation_keys keys(lines, lang, reverse);
+        std::vector<collation_key> &key_vec = keys.keys();
+        parallel_sort<collation_key>(&(key_vec[0]), &(key_vec[0]) + key_vec.size(),
+              [](const collation_key &key1, const collation_key &key2) -> bool
+              {
+                  int res = compare_collation_keys(key1, key2);
+                  return res < 0 || (res == 0 && key1.index <= key2.index);
+              });
+        run_writer run(path, min_merge_buffer);
+        for (const collation_key &key : key_vec) {
+            run.write(key.data, key.size, lines[key.index].data(), lines[key.index].size());
+        }
+        run.close();
+    }
+
+///-------------------------------------------------------------------------------------
+//! Sorts the lines of the mapped text to the file @c out_path, writes them in the original order to @c origin (if it is not nullptr)
+//!
+///-------------------------------------------------------------------------------------
+    void sort_lines(const char16_t *data, size_t size, language lang, bool reverse, size_t memory_budget,
+                    const char *out_path, text_writer *origin)
+    {
+        temp_files temp(out_path);
+        std::vector<std::string> runs;
+
+        line_scanner scanner(data, size);
+        // reserved once, so that growing by doubling does not leave unused capacity beyond the budget
+        const size_t max_lines = memory_budget / views_share / sizeof(std::basic_string_view<char16_t>);
+        const size_t keys_budget = memory_budget - max_lines * sizeof(std::basic_string_view<char16_t>);
+        std::vector< std::basic_string_view<char16_t> > lines;
+        lines.reserve(max_lines);
+        size_t lines_memory = 1; // make_key writes one byte after the last key
+        std::basic_string_view<char16_t> line;
+        while (scanner.next(line)) {
+            if (origin != nullptr) {
+                origin->write(nullptr, 0, line.data(), line.size());
+            }
+            if (!lines.empty() && (lines.size() == max_lines || lines_memory + line_overhead + line.size() > keys_budget)) {
+                runs.push_back(temp.create());
+                write_run(lines, lang, reverse, runs.back());
+                lines.clear();
+                lines_memory = 1;
+            }
+            lines.push_back(line);
+            lines_memory += line_overhead + line.size();
+        }
+        runs.push_back(temp.create());
+        write_run(lines, lang, reverse, runs.back());
+        std::vector< std::basic_string_view<char16_t> >().swap(lines);
+
+        // merging groups of consecutive runs, so that the runs stay in the order of the lines
+        const size_t max_runs = std::max(memory_budget / min_merge_buffer, (size_t)2);
+        while (runs.size() > max_runs) {
+            std::vector<std::string> merged_runs;
+            for (size_t i = 0; i < runs.size(); i += max_runs) {
+                std::vector<std::string> group(runs.begin() + i, runs.begin() + std::min(i + max_runs, runs.size()));
+                if (group.size() == 1) {
+                    merged_runs.push_back(group[0]);
+                    continue;
+                }
+                merged_runs.push_back(temp.create());
+                run_writer merged(merged_runs.back(), std::max(memory_budget / (group.size() + 1), min_merge_buffer));
+                merge_runs(group, memory_budget, merged);
+                merged.close();
+            }
+            runs.swap(merged_runs);
+        }
+
+        text_writer out(out_path, std::max(memory_budget / (runs.size() + 1), min_merge_buffer));
+        merge_runs(runs, memory_budget, out);
+        out.close();
+    }
+}
+
+
+/* See description in external_sorting.h */
+
+void sort_text_external(const char *file_in_path, const char *file_out_sorted_path, const char *file_out_sorted_back_path,
+                        const char *file_out_origin_path, language lang, size_t memory_budget)
+{
+    using namespace external_sorting_details;
+
+    if (lang != ENGLISH && lang != RUSSIAN) {
+        throw std::invalid_argument("sort_text_external: unknown language");
+    }
+    if (memory_budget < min_memory_budget) {
+        throw std::invalid_argument("sort_text_external: memory_budget < 4096");
+    }
+
+    mapped_file file_in(file_in_path);
+    const char16_t *data = (const char16_t *)file_in.data();
+    const size_t size = file_in.size() / sizeof(data[0]);
+
+    text_writer origin(file_out_origin_path, min_merge_buffer);
+    sort_lines(data, size, lang, false, memory_budget, file_out_sorted_path, &origin);
+    origin.close();
+
+    sort_lines(data, size, lang, true, memory_budget, file_out_sorted_back_path, nullptr);
+}
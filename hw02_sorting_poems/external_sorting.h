@@ -0,0 +1,36 @@
+#ifndef __EXTERNAL_SORTING_FOR_ONEGIN
+#define __EXTERNAL_SORTING_FOR_ONEGIN
+
+#include <cstddef>
+
+#include "text_sorting.h"
+
+///-------------------------------------------------------------------------------------
+//! Does the same as @c sort_text (and writes the same files), but for texts that do not fit in memory.
+//! The lines are read from the mapped file by parts of about @c memory_budget bytes of lines and keys, every part
+//! is sorted and written to a temporary file (a run), then the runs are merged with a loser tree.
+//!
+//! @param [in] file_in_path               Path to the file with text
+//! @param [in] file_out_sorted_path       Path to the file where to write the sorted version
+//! @param [in] file_out_sorted_back_path  Path to the file where to write the sorted from back version
+//! @param [in] file_out_origin_path       Path to the file where to write the origin version
+//! @param [in] lang                       The language of the text
+//! @param [in] memory_budget              Memory for the lines and their collation keys in bytes, at least 4096
+//!
+//! @attention If the output files exist, they will be overwritten
+//!
+//! @note The runs are written next to the output files, as "<file_out_sorted_path>.run<N>.tmp", and removed
+//!       after merging. They take about 1.5 times as much disk space as the text. If there are more than
+//!       @c memory_budget / 65536 runs, groups of them are merged into bigger runs first.
+//!
+//! @note A quarter of the budget is reserved for the views of the lines of a run (16 bytes per line), the rest is
+//!       for their keys: 48 bytes per line (the collation key and its copy, that parallel_sort merges into)
+//!       plus one byte for every symbol of the line. So a run never takes more than @c memory_budget, unless
+//!       a single line does not fit in it. The mapped file and the 64 KB write buffer of the run are not counted:
+//!       the system can evict the pages of the file when they are needed.
+//!
+///-------------------------------------------------------------------------------------
+void sort_text_external(const char *file_in_path, const char *file_out_sorted_path, const char *file_out_sorted_back_path,
+                        const char *file_out_origin_path, language lang, size_t memory_budget);
+
+#endif // __EXTERNAL_SORTING_FOR_ONEGIN
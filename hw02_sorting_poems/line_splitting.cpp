@@ -0,0 +1,293 @@
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "line_splitting.h"
+
+namespace line_splitting_details
+{
+    //! Number of symbols checked at a time
+    constexpr size_t block_size = 16;
+
+#if defined(__AVX2__)
+    //! Every symbol gives two bits of the mask
+    constexpr unsigned mask_bits_per_symbol = 2;
+
+/*
+Returns the mask of '\r', '\n' and '\0' among the 16 symbols at data
+*/
+    inline unsigned special_symbols_mask(const char16_t *data)
+    {
+        __m256i symbols = _mm256_loadu_si256((const __m256i *)data);
+        __m256i special = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi16(symbols, _mm256_set1_epi16('\r')),
+                                                          _mm256_cmpeq_epi16(symbols, _mm256_set1_epi16('\n'))),
+                                          _mm256_cmpeq_epi16(symbols, _mm256_setzero_si256()));
+        return (unsigned)_mm256_movemask_epi8(special);
+    }
+#elif defined(__SSE2__)
+    constexpr unsigned mask_bits_per_symbol = 1;
+
+    inline __m128i special_symbols(const char16_t *data)
+    {
+        __m128i symbols = _mm_loadu_si128((const __m128i *)data);
+        return _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi16(symbols, _mm_set1_epi16('\r')),
+                                         _mm_cmpeq_epi16(symbols, _mm_set1_epi16('\n'))),
+                            _mm_cmpeq_epi16(symbols, _mm_setzero_si128()));
+    }
+
+/*
+Returns the mask of '\r', '\n' and '\0' among the 16 symbols at data
+*/
+    inline unsigned special_symbols_mask(const char16_t *data)
+    {
+        // words of the comparisons are 0 or -1, so packing them to bytes keeps one byte for every symbol
+        return (unsigned)_mm_movemask_epi8(_mm_packs_epi16(special_symbols(data), special_symbols(data + 8)));
+    }
+#endif
+
+    inline bool is_special(char16_t c)
+    {
+        return c == '\r' || c == '\n' || c == '\0';
+    }
+
+/*
+Returns pos if the special symbol at pos is '\r' of "\r\n", throws otherwise
+*/
+    size_t check_line_end(const char16_t *data, size_t pos, size_t size)
+    {
+        assert(is_special(data[pos]));
+        if (data[pos] == '\r') {
+            if (pos + 1 < size && data[pos + 1] == '\n') {
+                return pos;
+            }
+            throw std::invalid_argument("find_line_end: in file file_in_path there is '\\r' which is not belong to \"\\r\\n\"");
+        } else if (data[pos] == '\n') {
+            throw std::invalid_argument("find_line_end: in file file_in_path there is '\\n' which is not belong to \"\\r\\n\"");
+        }
+        throw std::invalid_argument("find_line_end: in file file_in_path there is '\\0'");
+    }
+
+/*
+Returns the number of bytes of the UTF-8 symbol at pos, 0 if it is '\0' or malformed (overlong, surrogate, out of range or cut)
+*/
+    inline size_t utf8_symbol_size(const unsigned char *data, size_t pos, size_t size)
+    {
+        unsigned char lead = data[pos];
+        if (lead < 0x80) {
+            return (lead != 0);
+        }
+        size_t symbol_size = 0;
+        // range of the second byte, it excludes overlong forms, surrogates and symbols after U+10FFFF
+        unsigned char low = 0x80, high = 0xbf;
+        if (lead >= 0xc2 && lead <= 0xdf) {
+            symbol_size = 2;
+        } else if (lead >= 0xe0 && lead <= 0xef) {
+            symbol_size = 3;
+            low = (lead == 0xe0 ? 0xa0 : low);
+            high = (lead == 0xed ? 0x9f : high);
+        } else if (lead >= 0xf0 && lead <= 0xf4) {
+            symbol_size = 4;
+            low = (lead == 0xf0 ? 0x90 : low);
+            high = (lead == 0xf4 ? 0x8f : high);
+        } else {
+            return 0;
+        }
+        if (size - pos < symbol_size || data[pos + 1] < low || data[pos + 1] > high) {
+            return 0;
+        }
+        for (size_t i = 2; i < symbol_size; i++) {
+            if ((data[pos + i] & 0xc0) != 0x80) {
+                return 0;
+            }
+        }
+        return symbol_size;
+    }
+
+/*
+Throws std::invalid_argument if there is '\0' or malformed UTF-8 in the text
+*/
+    void check_utf8(const char *data, size_t begin, size_t size)
+    {
+        const unsigned char *bytes = (const unsigned char *)data;
+        size_t pos = begin;
+        while (pos < size) {
+#if defined(__AVX2__) || defined(__SSE2__)
+            // 16 ASCII bytes without '\0' are skipped at once
+            if (pos + 16 <= size) {
+                __m128i block = _mm_loadu_si128((const __m128i *)(bytes + pos));
+                if ((_mm_movemask_epi8(block) | _mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_setzero_si128()))) == 0) {
+                    pos += 16;
+                    continue;
+                }
+            }
+#endif
+            size_t symbol_size = utf8_symbol_size(bytes, pos, size);
+            if (symbol_size == 0) {
+                if (bytes[pos] == 0) {
+                    throw std::invalid_argument("split_utf8_lines: in file file_in_path there is '\\0'");
+                }
+                throw std::invalid_argument("split_utf8_lines: file file_in_path is not valid UTF-8");
+            }
+            pos += symbol_size;
+        }
+    }
+
+    //! split_lines reserves one line for every expected_line_size symbols of a chunk
+    constexpr size_t expected_line_size = 32;
+
+/*
+Calls job(i) for i from 0 to njobs - 1 in nthreads threads (one of them is the calling thread), every thread takes the next i
+*/
+    template<typename Job>
+    void run_jobs(size_t njobs, unsigned nthreads, Job job)
+    {
+        std::atomic<size_t> next_job(0);
+        auto worker = [&]() {
+            for (size_t i = next_job++; i < njobs; i = next_job++) {
+                job(i);
+            }
+        };
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < std::min((size_t)nthreads, njobs); i++) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+    }
+
+/*
+Appends to lines the views of the lines of the text, that begin in [chunk_begin, chunk_end)
+*/
+    void split_chunk(const char16_t *data, size_t begin, size_t size, size_t chunk_begin, size_t chunk_end,
+                     std::vector< std::basic_string_view<char16_t> > &lines)
+    {
+        size_t pos = chunk_begin;
+        if (chunk_begin != begin) {
+            // skipping the end of the line from the previous chunk, it is checked by the thread of that chunk
+            while (pos < chunk_end && !(pos >= 2 && data[pos - 2] == '\r' && data[pos - 1] == '\n')) {
+                pos++;
+            }
+        }
+        lines.reserve((chunk_end - chunk_begin) / expected_line_size + 1);
+        while (pos < chunk_end) {
+            size_t end = find_line_end(data, pos, size);
+            lines.push_back({data + pos, end - pos});
+            if (end == size) {
+                break;
+            }
+            pos = end + 2; // skipping "\r\n"
+        }
+    }
+}
+
+
+/* See description in line_splitting.h */
+
+size_t find_line_end(const char16_t *data, size_t begin, size_t size)
+{
+    using namespace line_splitting_details;
+
+    assert(begin <= size);
+    size_t pos = begin;
+#if defined(__AVX2__) || defined(__SSE2__)
+    for (; pos + block_size <= size; pos += block_size) {
+        unsigned mask = special_symbols_mask(data + pos);
+        if (mask != 0) {
+            return check_line_end(data, pos + __builtin_ctz(mask) / mask_bits_per_symbol, size);
+        }
+    }
+#endif
+    for (; pos < size; pos++) {
+        if (is_special(data[pos])) {
+            return check_line_end(data, pos, size);
+        }
+    }
+    return size;
+}
+
+
+/* See description in line_splitting.h */
+
+std::vector< std::basic_string_view<char16_t> > split_lines(const char16_t *data, size_t begin, size_t size,
+                                                            unsigned nthreads, size_t chunk_size)
+{
+    using namespace line_splitting_details;
+
+    assert(begin <= size);
+    if (chunk_size == 0) {
+        throw std::invalid_argument("split_lines: chunk_size == 0");
+    }
+    if (nthreads == 0) {
+        nthreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // lines begin at the indices from begin to size, the last line can be empty
+    const size_t nchunks = (size + 1 - begin + chunk_size - 1) / chunk_size;
+    if (nthreads == 1 || nchunks == 1) {
+        // one pass over the whole text, nothing to stitch or copy
+        std::vector< std::basic_string_view<char16_t> > lines;
+        split_chunk(data, begin, size, begin, size + 1, lines);
+        return lines;
+    }
+    std::vector< std::vector< std::basic_string_view<char16_t> > > chunk_lines(nchunks);
+    std::vector<std::exception_ptr> errors(nchunks);
+    run_jobs(nchunks, nthreads, [&](size_t chunk) {
+        size_t chunk_begin = begin + chunk * chunk_size;
+        try {
+            split_chunk(data, begin, size, chunk_begin, std::min(chunk_begin + chunk_size, size + 1), chunk_lines[chunk]);
+        } catch (...) {
+            errors[chunk] = std::current_exception();
+        }
+    });
+    for (const std::exception_ptr &error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    std::vector<size_t> chunk_offsets(nchunks + 1, 0);
+    for (size_t i = 0; i < nchunks; i++) {
+        chunk_offsets[i + 1] = chunk_offsets[i] + chunk_lines[i].size();
+    }
+    std::vector< std::basic_string_view<char16_t> > lines(chunk_offsets[nchunks]);
+    run_jobs(nchunks, nthreads, [&](size_t chunk) {
+        std::copy(chunk_lines[chunk].begin(), chunk_lines[chunk].end(), lines.begin() + chunk_offsets[chunk]);
+        std::vector< std::basic_string_view<char16_t> >().swap(chunk_lines[chunk]);
+    });
+    return lines;
+}
+
+
+/* See description in line_splitting.h */
+
+std::vector<std::string_view> split_utf8_lines(const char *data, size_t begin, size_t size)
+{
+    using namespace line_splitting_details;
+
+    assert(begin <= size);
+    check_utf8(data, begin, size);
+    std::vector<std::string_view> lines;
+    lines.reserve((size - begin) / expected_line_size + 1);
+    for (size_t pos = begin; ; ) {
+        const char *end = (pos < size ? (const char *)memchr(data + pos, '\n', size - pos) : nullptr);
+        if (end == nullptr) {
+            lines.push_back({data + pos, size - pos});
+            break;
+        }
+        lines.push_back({data + pos, (size_t)(end - data) - pos});
+        pos = end - data + 1;
+    }
+    return lines;
+}
@@ -0,0 +1,73 @@
+#ifndef __LINE_SPLITTING_FOR_ONEGIN
+#define __LINE_SPLITTING_FOR_ONEGIN
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+///-------------------------------------------------------------------------------------
+//! Finds the end of the line of UTF-16 text, that begins at @c begin. Lines are separated by "\r\n".
+//!
+//! @param [in] data   The text
+//! @param [in] begin  Index of the first symbol of the line
+//! @param [in] size   Number of symbols in the text
+//!
+//! @return Index of '\r' of the "\r\n" after the line, or @c size if the line is the last one
+//!
+//! @note Throws std::invalid_argument if there is '\r' which is not followed by '\n', '\n' which
+//!       is not after '\r', or '\0' in the line.
+//!
+//! @note Looks for the special symbols in 16 symbols at a time: with one AVX2 comparison if the program
+//!       is compiled for AVX2 (for example, with -mavx2), with two SSE2 comparisons otherwise (on x86),
+//!       or symbol by symbol.
+//!
+///-------------------------------------------------------------------------------------
+size_t find_line_end(const char16_t *data, size_t begin, size_t size);
+
+//! Default number of symbols in a chunk of @c split_lines
+constexpr size_t SPLIT_CHUNK_SIZE = 1 << 20;
+
+///-------------------------------------------------------------------------------------
+//! Splits UTF-16 text into lines separated by "\r\n" in several threads
+//!
+//! @param [in] data        The text
+//! @param [in] begin       Index of the first symbol of the first line
+//! @param [in] size        Number of symbols in the text
+//! @param [in] nthreads    Number of threads (0 means the number of hardware threads)
+//! @param [in] chunk_size  Number of symbols in a chunk
+//!
+//! @return Views of the lines in the order of the text
+//!
+//! @note The text is cut into chunks of @c chunk_size symbols, which threads take one by one. A thread makes
+//!       the views of the lines that begin in its chunk: it skips the end of the line that began in the previous
+//!       chunk and reads the last line to its end in the next chunks. Then the views of the chunks are copied
+//!       to one vector in parallel, the place of every chunk is the sum of numbers of lines in the previous ones.
+//!       With one thread, or if the text fits in one chunk, the lines are made in one pass without chunks.
+//!
+//! @note Throws std::invalid_argument like @c find_line_end. If there are several errors, the one from the
+//!       first chunk is thrown.
+//!
+///-------------------------------------------------------------------------------------
+std::vector< std::basic_string_view<char16_t> > split_lines(const char16_t *data, size_t begin, size_t size,
+                                                            unsigned nthreads = 0, size_t chunk_size = SPLIT_CHUNK_SIZE);
+
+///-------------------------------------------------------------------------------------
+//! Splits UTF-8 text into lines separated by '\n'
+//!
+//! @param [in] data   The text
+//! @param [in] begin  Index of the first byte of the first line
+//! @param [in] size   Number of bytes in the text
+//!
+//! @return Views of the lines in the order of the text
+//!
+//! @note '\r' before '\n' stays in the line (it is not a letter, so the comparators skip it). The separators
+//!       are found with @c memchr, which is vectorized by the C library.
+//!
+//! @note Throws std::invalid_argument if there is '\0' or malformed UTF-8 (a cut, overlong or surrogate
+//!       symbol, or a byte that cannot be in UTF-8) in the text. UTF-16 text without byte order mask has
+//!       '\0' bytes, so it is rejected too. Blocks of 16 ASCII bytes are checked at once with SSE2.
+//!
+///-------------------------------------------------------------------------------------
+std::vector<std::string_view> split_utf8_lines(const char *data, size_t begin, size_t size);
+
+#endif // __LINE_SPLITTING_FOR_ONEGIN
@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+#include <string>
+
+#include "line_writing.h"
+
+namespace line_writing_details
+{
+/*
+Writes size symbols from data to file_out
+*/
+    template<typename Char>
+    void write_symbols(FILE *file_out, const Char *data, size_t size, const char *file_name)
+    {
+        if (fwrite((const void *)data, sizeof(data[0]), size, file_out) != size) {
+            throw std::runtime_error((std::string)"write_lines: error occurred while writing in " + file_name);
+        }
+    }
+
+/*
+Writes every line and every endline with its own fwrite
+*/
+    template<typename Char>
+    void write_lines_unbuffered(FILE *file_out, const std::vector< std::basic_string_view<Char> > &lines, const char *file_name,
+                                const std::basic_string_view<Char> &endline)
+    {
+        for (size_t i = 0; i < lines.size(); i++) {
+            if (i > 0) {
+                write_symbols(file_out, endline.data(), endline.size(), file_name);
+            }
+            write_symbols(file_out, lines[i].data(), lines[i].size(), file_name);
+        }
+    }
+
+/*
+Writes lines separated by endline through the buffer of buffer_size bytes (see description of write_lines in line_writing.h)
+*/
+    template<typename Char>
+    void write_lines_buffered(FILE *file_out, const std::vector< std::basic_string_view<Char> > &lines, const char *file_name,
+                              size_t buffer_size, const std::basic_string_view<Char> &endline)
+    {
+        if (buffer_size == 0) {
+            write_lines_unbuffered(file_out, lines, file_name, endline);
+            return;
+        }
+
+        // there is always place for endline
+        std::vector<Char> buffer(std::max(buffer_size / sizeof(Char), endline.size()));
+        size_t used = 0;
+        for (size_t i = 0; i < lines.size(); i++) {
+            if (i > 0) {
+                if (buffer.size() - used < endline.size()) {
+                    write_symbols(file_out, buffer.data(), used, file_name);
+                    used = 0;
+                }
+                std::copy(endline.begin(), endline.end(), buffer.begin() + used);
+                used += endline.size();
+            }
+            const std::basic_string_view<Char> &line = lines[i];
+            if (line.size() > buffer.size() - used) {
+                write_symbols(file_out, buffer.data(), used, file_name);
+                used = 0;
+                if (line.size() > buffer.size()) {
+                    write_symbols(file_out, line.data(), line.size(), file_name);
+                    continue;
+                }
+            }
+            std::copy(line.begin(), line.end(), buffer.begin() + used);
+            used += line.size();
+        }
+        write_symbols(file_out, buffer.data(), used, file_name);
+    }
+}
+
+
+/* See description in line_writing.h */
+
+void write_lines(FILE *file_out, const std::vector< std::basic_string_view<char16_t> > &lines, const char *file_name,
+                 size_t buffer_size)
+{
+    assert(file_out);
+    assert(file_name);
+    line_writing_details::write_lines_buffered(file_out, lines, file_name, buffer_size, std::basic_string_view<char16_t>(u"\r\n"));
+}
+
+
+/* See description in line_writing.h */
+
+void write_lines(FILE *file_out, const std::vector<std::string_view> &lines, const char *file_name, size_t buffer_size)
+{
+    assert(file_out);
+    assert(file_name);
+    line_writing_details::write_lines_buffered(file_out, lines, file_name, buffer_size, std::string_view("\n"));
+}
@@ -0,0 +1,42 @@
+#ifndef __LINE_WRITING_FOR_ONEGIN
+#define __LINE_WRITING_FOR_ONEGIN
+
+#include <cstddef>
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+//! Default size of the buffer of @c write_lines in bytes
+constexpr size_t WRITE_BUFFER_SIZE = 1 << 20;
+
+///-------------------------------------------------------------------------------------
+//! Writes UTF-16 lines separated by "\r\n" to the file
+//!
+//! @param [in] file_out     The file
+//! @param [in] lines        The lines
+//! @param [in] file_name    Name of the file for error messages
+//! @param [in] buffer_size  Size of the buffer in bytes (0 means no buffer)
+//!
+//! @note The lines and "\r\n" are copied one after another to the buffer, which is written with one @c fwrite
+//!       when the next line does not fit in it. Lines longer than the buffer are written at once. Without the buffer
+//!       every line and every "\r\n" is written with its own @c fwrite (that is much slower, see run_bench -w).
+//!
+//! @note Throws std::runtime_error if @c fwrite fails
+//!
+///-------------------------------------------------------------------------------------
+void write_lines(FILE *file_out, const std::vector< std::basic_string_view<char16_t> > &lines, const char *file_name,
+                 size_t buffer_size = WRITE_BUFFER_SIZE);
+
+///-------------------------------------------------------------------------------------
+//! Writes UTF-8 lines separated by '\n' to the file, the same way as the UTF-16 version
+//!
+//! @param [in] file_out     The file
+//! @param [in] lines        The lines
+//! @param [in] file_name    Name of the file for error messages
+//! @param [in] buffer_size  Size of the buffer in bytes (0 means no buffer)
+//!
+///-------------------------------------------------------------------------------------
+void write_lines(FILE *file_out, const std::vector<std::string_view> &lines, const char *file_name,
+                 size_t buffer_size = WRITE_BUFFER_SIZE);
+
+#endif // __LINE_WRITING_FOR_ONEGIN
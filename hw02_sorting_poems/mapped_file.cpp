@@ -0,0 +1,149 @@
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "mapped_file.h"
+
+#ifdef _WIN32
+
+static std::string GetLastErrorAsString()
+{
+    LPSTR messageBuffer = nullptr;
+    size_t size = FormatMessageA(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
+                                 NULL, GetLastError(), MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT), (LPSTR)&messageBuffer, 0, NULL);
+    std::string message(messageBuffer, size);
+    LocalFree(messageBuffer);
+    return message;
+}
+
+static std::string last_error_message(const char *what, const char *path)
+{
+    return (std::string)"mapped_file: cannot " + what + " " + path + ": " + GetLastErrorAsString();
+}
+
+/* See description in mapped_file.h */
+
+mapped_file::mapped_file(const char *path)
+{
+    file_handle_ = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file_handle_ == INVALID_HANDLE_VALUE) {
+        file_handle_ = nullptr;
+        throw std::runtime_error(last_error_message("open", path));
+    }
+    LARGE_INTEGER file_size = {};
+    if (GetFileSizeEx(file_handle_, &file_size) == 0) {
+        CloseHandle(file_handle_);
+        throw std::runtime_error(last_error_message("get size of", path));
+    }
+    size_ = file_size.QuadPart;
+    if (size_ == 0) {
+        return;
+    }
+    if (size_ > SIZE_MAX) {
+        CloseHandle(file_handle_);
+        throw std::runtime_error((std::string)"mapped_file: " + path + " is too big to be mapped");
+    }
+    mapping_handle_ = CreateFileMappingA(file_handle_, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping_handle_ == NULL) {
+        CloseHandle(file_handle_);
+        throw std::runtime_error(last_error_message("map", path));
+    }
+    data_ = (char *)MapViewOfFile(mapping_handle_, FILE_MAP_READ, 0, 0, 0);
+    if (data_ == NULL) {
+        CloseHandle(mapping_handle_);
+        CloseHandle(file_handle_);
+        throw std::runtime_error(last_error_message("map", path));
+    }
+}
+
+mapped_file::~mapped_file()
+{
+    if (data_ != nullptr) {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_handle_ != nullptr) {
+        CloseHandle(mapping_handle_);
+    }
+    if (file_handle_ != nullptr) {
+        CloseHandle(file_handle_);
+    }
+}
+
+/* See description in mapped_file.h */
+
+void mapped_file::advise(access_pattern) const
+{
+}
+
+#else
+
+static std::string last_error_message(const char *what, const char *path)
+{
+    return (std::string)"mapped_file: cannot " + what + " " + path + ": " + strerror(errno);
+}
+
+/* See description in mapped_file.h */
+
+mapped_file::mapped_file(const char *path)
+{
+    fd_ = open(path, O_RDONLY);
+    if (fd_ < 0) {
+        throw std::runtime_error(last_error_message("open", path));
+    }
+    struct stat file_stat = {};
+    if (fstat(fd_, &file_stat) != 0) {
+        close(fd_);
+        throw std::runtime_error(last_error_message("get size of", path));
+    }
+    size_ = file_stat.st_size;
+    if (size_ == 0) {
+        return;
+    }
+    if (size_ > SIZE_MAX) {
+        close(fd_);
+        throw std::runtime_error((std::string)"mapped_file: " + path + " is too big to be mapped");
+    }
+    void *data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (data == MAP_FAILED) {
+        close(fd_);
+        throw std::runtime_error(last_error_message("map", path));
+    }
+    data_ = (char *)data;
+    // only hints, errors are not important
+#ifdef MADV_HUGEPAGE
+    madvise(data_, size_, MADV_HUGEPAGE);
+#endif
+    advise(SEQUENTIAL_ACCESS);
+}
+
+mapped_file::~mapped_file()
+{
+    if (data_ != nullptr) {
+        munmap(data_, size_);
+    }
+    if (fd_ >= 0) {
+        close(fd_);
+    }
+}
+
+/* See description in mapped_file.h */
+
+void mapped_file::advise(access_pattern pattern) const
+{
+    if (data_ != nullptr) {
+        madvise(data_, size_, pattern == SEQUENTIAL_ACCESS ? MADV_SEQUENTIAL : MADV_NORMAL);
+    }
+}
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef __MAPPED_FILE_FOR_ONEGIN
+#define __MAPPED_FILE_FOR_ONEGIN
+
+#include <cstdint>
+
+//! How the mapped file is going to be read
+enum access_pattern {
+    SEQUENTIAL_ACCESS, //!< From the beginning to the end (read ahead aggressively, pages behind can be dropped)
+    NORMAL_ACCESS      //!< In any order
+};
+
+///-------------------------------------------------------------------------------------
+//! Existing file mapped to memory for reading (with mmap on POSIX systems and MapViewOfFile on Windows).
+//! The mapping is released in the destructor.
+//!
+//! @note Sizes are 64-bit, so files bigger than 4 GiB can be mapped by 64-bit programs.
+//!
+//! @note Errors are reported with std::runtime_error
+//!
+///-------------------------------------------------------------------------------------
+class mapped_file
+{
+public:
+///-------------------------------------------------------------------------------------
+//! Maps the whole file for reading
+//!
+//! @param [in] path  Path to the file
+//!
+//! @note On POSIX systems the mapping is advised as @c SEQUENTIAL_ACCESS and, where the kernel
+//!       supports it, to be backed by huge pages (fewer TLB misses when the lines are sorted).
+//!
+///-------------------------------------------------------------------------------------
+    explicit mapped_file(const char *path);
+
+    ~mapped_file();
+
+    mapped_file(const mapped_file &) = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+
+///-------------------------------------------------------------------------------------
+//! Tells the system how the file is going to be read (only a hint, does nothing on Windows)
+//!
+//! @param [in] pattern  The access pattern
+//!
+///-------------------------------------------------------------------------------------
+    void advise(access_pattern pattern) const;
+
+    //! Pointer to the first byte of the file (nullptr if the file is empty)
+    const char *data() const { return data_; }
+
+    //! Size of the file in bytes
+    uint64_t size() const { return size_; }
+
+private:
+    char *data_ = nullptr;
+    uint64_t size_ = 0;
+#ifdef _WIN32
+    void *file_handle_ = nullptr;
+    void *mapping_handle_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
+
+#endif // __MAPPED_FILE_FOR_ONEGIN
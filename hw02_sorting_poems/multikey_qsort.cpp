@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+#include "multikey_qsort.h"
+
+namespace multikey_qsort_details
+{
+    //! Parts shorter than this are sorted with insertion sort
+    constexpr size_t insertion_sort_size = 16;
+
+/*
+Returns the byte of the key at depth, 0 after the end of the key
+*/
+    inline unsigned key_byte(const collation_key &key, size_t depth)
+    {
+        if (depth < 8) {
+            return (unsigned)(key.prefix >> (56 - 8 * depth)) & 0xff;
+        }
+        return (depth < key.size ? key.data[depth] : 0);
+    }
+
+/*
+Returns true if key1 goes before key2, the first depth bytes of the keys are equal
+*/
+    inline bool key_less(const collation_key &key1, const collation_key &key2, size_t depth)
+    {
+        if (depth < 8 && key1.prefix != key2.prefix) {
+            return key1.prefix < key2.prefix;
+        }
+        size_t size = std::min(key1.size, key2.size);
+        for (size_t i = std::max(depth, (size_t)8); i < size; i++) {
+            if (key1.data[i] != key2.data[i]) {
+                return key1.data[i] < key2.data[i];
+            }
+        }
+        if (key1.size != key2.size) {
+            return key1.size < key2.size;
+        }
+        return key1.index < key2.index;
+    }
+
+    void insertion_sort(collation_key *keys_begin, collation_key *keys_end, size_t depth)
+    {
+        for (collation_key *cur = keys_begin + 1; cur < keys_end; cur++) {
+            collation_key key = *cur;
+            collation_key *place = cur;
+            while (place > keys_begin && key_less(key, place[-1], depth)) {
+                *place = place[-1];
+                place--;
+            }
+            *place = key;
+        }
+    }
+
+    inline unsigned median_of_3(unsigned a, unsigned b, unsigned c)
+    {
+        return std::max(std::min(a, b), std::min(std::max(a, b), c));
+    }
+
+/*
+Sorts the keys, which first depth bytes are equal
+*/
+    void sort_from(collation_key *keys_begin, collation_key *keys_end, size_t depth)
+    {
+        while (keys_end - keys_begin > (ptrdiff_t)insertion_sort_size) {
+            size_t n = keys_end - keys_begin;
+            unsigned pivot = median_of_3(key_byte(keys_begin[0], depth), key_byte(keys_begin[n / 2], depth),
+                                         key_byte(keys_end[-1], depth));
+
+            // [keys_begin, less_end) < pivot, [less_end, cur) == pivot, [greater_begin, keys_end) > pivot
+            collation_key *less_end = keys_begin, *cur = keys_begin, *greater_begin = keys_end;
+            while (cur < greater_begin) {
+                unsigned byte = key_byte(*cur, depth);
+                if (byte < pivot) {
+                    std::swap(*less_end++, *cur++);
+                } else if (byte > pivot) {
+                    std::swap(*cur, *--greater_begin);
+                } else {
+                    cur++;
+                }
+            }
+            sort_from(keys_begin, less_end, depth);
+            sort_from(greater_begin, keys_end, depth);
+
+            if (pivot == 0) {
+                // all the keys ended, they are equal
+                std::sort(less_end, greater_begin, [](const collation_key &key1, const collation_key &key2) {
+                    return key1.index < key2.index;
+                });
+                return;
+            }
+            keys_begin = less_end;
+            keys_end = greater_begin;
+            depth++;
+        }
+        insertion_sort(keys_begin, keys_end, depth);
+    }
+}
+
+
+/* See description in multikey_qsort.h */
+
+void multikey_qsort(collation_key *keys_begin, collation_key *keys_end)
+{
+    if (keys_begin == nullptr) {
+        throw std::invalid_argument("multikey_qsort: keys_begin == nullptr");
+    }
+    if (keys_end == nullptr) {
+        throw std::invalid_argument("multikey_qsort: keys_end == nullptr");
+    }
+    if (keys_end < keys_begin) {
+        throw std::invalid_argument("multikey_qsort: keys_end < keys_begin");
+    }
+    multikey_qsort_details::sort_from(keys_begin, keys_end, 0);
+}
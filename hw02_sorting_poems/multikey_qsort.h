@@ -0,0 +1,24 @@
+#ifndef __MULTIKEY_QSORT_FOR_ONEGIN
+#define __MULTIKEY_QSORT_FOR_ONEGIN
+
+#include "collation_keys.h"
+
+///-------------------------------------------------------------------------------------
+//! Sorts collation keys in ascending order with multikey quicksort
+//!
+//! @param [in] keys_begin  The pointer to the first key
+//! @param [in] keys_end    The pointer to the key after the last key
+//!
+//! @note The keys are ordered as by @c compare_collation_keys, equal keys are ordered by their indices.
+//!
+//! @note Keys are partitioned by one byte at a time: to the keys with less, equal and greater byte at the
+//!       current depth, and only the equal part goes to the next byte. So the common prefixes of the keys
+//!       are not compared again, as QuickSort with @c compare_collation_keys does. The first 8 bytes are
+//!       taken from @c collation_key::prefix without reading the key itself.
+//!
+//! @note Checks if @c keys_begin and @c keys_end are valid arguments
+//!
+///-------------------------------------------------------------------------------------
+void multikey_qsort(collation_key *keys_begin, collation_key *keys_end);
+
+#endif // __MULTIKEY_QSORT_FOR_ONEGIN
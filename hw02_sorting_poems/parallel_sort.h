@@ -0,0 +1,202 @@
+#ifndef __PARALLEL_SORT_FOR_ONEGIN
+#define __PARALLEL_SORT_FOR_ONEGIN
+
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "qsort.h"
+
+
+namespace parallel_sort_details
+{
+    //! Arrays shorter than this are sorted by one thread
+    constexpr size_t min_parallel_size = 1 << 14;
+
+///-------------------------------------------------------------------------------------
+//! Calls job(i) for i from 0 to njobs - 1, each in its own thread (the last one in the calling thread)
+//!
+///-------------------------------------------------------------------------------------
+    template<typename Job>
+    void run_in_threads(size_t njobs, Job job)
+    {
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i + 1 < njobs; i++) {
+            threads.emplace_back(job, i);
+        }
+        job(njobs - 1);
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+    }
+
+///-------------------------------------------------------------------------------------
+//! Returns the pointer to the first element of the sorted array which is greater than @c value
+//!
+//! @param [in] arr_begin  The pointer to the first element of the array
+//! @param [in] arr_end    The pointer to the element after the last element of the array
+//! @param [in] value      The value
+//! @param [in] cmp        Function that compare two elements of the array and return
+//!                        true if the first is less than or equal to the second
+//!
+///-------------------------------------------------------------------------------------
+    template<typename T>
+    T *upper_bound(T *arr_begin, T *arr_end, const T &value, comparator<T> cmp)
+    {
+        while (arr_begin < arr_end) {
+            T *middle = arr_begin + (arr_end - arr_begin) / 2;
+            if (cmp(*middle, value)) {
+                arr_begin = middle + 1;
+            } else {
+                arr_end = middle;
+            }
+        }
+        return arr_begin;
+    }
+
+///-------------------------------------------------------------------------------------
+//! Merges sorted ranges [begins[i], ends[i]) into the array @c out
+//!
+//! @param [in]  begins  The pointers to the first elements of the ranges
+//! @param [in]  ends    The pointers to the elements after the last elements of the ranges
+//! @param [out] out     The pointer to the first element of the array where to write the result
+//! @param [in]  cmp     Function that compare two elements and return true if the first is less than or equal to the second
+//!
+//! @note Of the equal elements the one from the range with the less index goes first.
+//!
+///-------------------------------------------------------------------------------------
+    template<typename T>
+    void multiway_merge(std::vector<T *> begins, const std::vector<T *> &ends, T *out, comparator<T> cmp)
+    {
+        // min-heap of range indices, ordered by the current elements of the ranges
+        auto greater = [&](size_t range1, size_t range2) {
+            if (range1 == range2) {
+                return false;
+            }
+            bool less_or_equal = cmp(*begins[range2], *begins[range1]);
+            return (less_or_equal && cmp(*begins[range1], *begins[range2]) ? range1 > range2 : less_or_equal);
+        };
+        std::vector<size_t> heap;
+        for (size_t i = 0; i < begins.size(); i++) {
+            if (begins[i] < ends[i]) {
+                heap.push_back(i);
+            }
+        }
+        std::make_heap(heap.begin(), heap.end(), greater);
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), greater);
+            size_t range = heap.back();
+            *out++ = *begins[range]++;
+            if (begins[range] < ends[range]) {
+                std::push_heap(heap.begin(), heap.end(), greater);
+            } else {
+                heap.pop_back();
+            }
+        }
+    }
+}
+
+///-------------------------------------------------------------------------------------
+//! Sorts array in ascending order in several threads
+//!
+//! @param [in] arr_begin  The pointer to the first element of the array
+//! @param [in] arr_end    The pointer to the element after the last element of the array
+//! @param [in] cmp        Function that compare two elements of the array and return
+//!                        true if the first is less than or equal to the second
+//! @param [in] nthreads   Number of threads (0 means the number of hardware threads)
+//!
+//! @note Parallel sorting by regular sampling: every thread sorts its part of the array with @c qsort,
+//!       regular samples of the sorted parts give nthreads - 1 splitters, then every thread merges
+//!       the elements between two splitters from all the parts. If the elements are distinct, no thread
+//!       gets more than about 2 * n / nthreads elements to merge. Arrays shorter than 16384 are sorted with @c qsort.
+//!
+//! @note The order of equal elements depends on @c nthreads, make @c cmp a total order (for example,
+//!       compare the addresses of equal strings) to get the same result with any number of threads.
+//!
+//! @note Checks if @c arr_begin and @c arr_end are valid arguments
+//!
+///-------------------------------------------------------------------------------------
+template<typename T>
+void parallel_sort(T *arr_begin, T *arr_end, comparator<T> cmp, unsigned nthreads = 0)
+{
+    using namespace parallel_sort_details;
+
+    if (arr_begin == nullptr) {
+        throw std::invalid_argument("parallel_sort: arr_begin == nullptr");
+    }
+    if (arr_end == nullptr) {
+        throw std::invalid_argument("parallel_sort: arr_end == nullptr");
+    }
+    if (arr_end < arr_begin) {
+        throw std::invalid_argument("parallel_sort: arr_end < arr_begin");
+    }
+
+    const size_t n = arr_end - arr_begin;
+    size_t nparts = (nthreads != 0 ? nthreads : std::max(1u, std::thread::hardware_concurrency()));
+    nparts = std::min(nparts, n / (min_parallel_size / 2));
+    if (nparts <= 1) {
+        qsort_details::choose_sort<T>(arr_begin, arr_end, cmp);
+        return;
+    }
+
+    // sorting the parts
+    std::vector<T *> part_begins(nparts + 1);
+    for (size_t i = 0; i <= nparts; i++) {
+        part_begins[i] = arr_begin + n * i / nparts;
+    }
+    run_in_threads(nparts, [&](size_t part) {
+        qsort_details::choose_sort<T>(part_begins[part], part_begins[part + 1], cmp);
+    });
+
+    // choosing splitters from nparts regular samples of every part
+    std::vector<T> samples;
+    for (size_t i = 0; i < nparts; i++) {
+        size_t part_size = part_begins[i + 1] - part_begins[i];
+        for (size_t j = 0; j < nparts; j++) {
+            samples.push_back(part_begins[i][part_size * j / nparts]);
+        }
+    }
+    qsort_details::choose_sort<T>(&samples[0], &samples[0] + samples.size(), cmp);
+    std::vector<T> splitters(nparts - 1);
+    for (size_t i = 1; i < nparts; i++) {
+        splitters[i - 1] = samples[i * nparts + nparts / 2];
+    }
+
+    // bounds[i][j] is where the elements of the part i greater than splitters[j - 1] begin
+    std::vector<std::vector<T *>> bounds(nparts, std::vector<T *>(nparts + 1));
+    run_in_threads(nparts, [&](size_t part) {
+        bounds[part][0] = part_begins[part];
+        for (size_t j = 1; j < nparts; j++) {
+            bounds[part][j] = upper_bound<T>(bounds[part][j - 1], part_begins[part + 1], splitters[j - 1], cmp);
+        }
+        bounds[part][nparts] = part_begins[part + 1];
+    });
+
+    // merging the elements between two splitters from all the parts
+    std::vector<size_t> out_begins(nparts + 1, 0);
+    for (size_t j = 0; j < nparts; j++) {
+        out_begins[j + 1] = out_begins[j];
+        for (size_t i = 0; i < nparts; i++) {
+            out_begins[j + 1] += bounds[i][j + 1] - bounds[i][j];
+        }
+    }
+    assert(out_begins[nparts] == n);
+    std::vector<T> merged(n);
+    run_in_threads(nparts, [&](size_t j) {
+        std::vector<T *> begins(nparts), ends(nparts);
+        for (size_t i = 0; i < nparts; i++) {
+            begins[i] = bounds[i][j];
+            ends[i] = bounds[i][j + 1];
+        }
+        multiway_merge<T>(begins, ends, &merged[0] + out_begins[j], cmp);
+    });
+    // the parts are read by all the threads, so they are overwritten only when all the merges are finished
+    run_in_threads(nparts, [&](size_t j) {
+        std::copy(merged.begin() + out_begins[j], merged.begin() + out_begins[j + 1], arr_begin + out_begins[j]);
+    });
+}
+
+#endif // __PARALLEL_SORT_FOR_ONEGIN
@@ -0,0 +1,169 @@
+#include "text_sorting.h"
+#include "mapped_file.h"
+#include "line_splitting.h"
+#include "line_writing.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/*
+Reads the whole file
+*/
+std::vector<char> read_file(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == nullptr) {
+        throw std::runtime_error((std::string)"run_bench: cannot open " + path);
+    }
+    std::vector<char> data;
+    char buffer[1 << 16];
+    size_t nread = 0;
+    while ((nread = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data.insert(data.end(), buffer, buffer + nread);
+    }
+    fclose(file);
+    return data;
+}
+
+/*
+Writes the text from path_in (UTF-16 with byte order mark) to path_out again and again, until path_out
+has at least megabytes megabytes. Returns the number of lines in path_out
+*/
+size_t replicate_text(const char *path_in, const char *path_out, size_t megabytes)
+{
+    std::vector<char> text = read_file(path_in);
+    const size_t bom_size = sizeof(char16_t);
+    if (text.size() < bom_size) {
+        throw std::runtime_error((std::string)"run_bench: " + path_in + " has no byte order mask");
+    }
+    size_t nlines = 1;
+    for (size_t i = bom_size; i + 1 < text.size(); i += sizeof(char16_t)) {
+        nlines += (text[i] == '\n' && text[i + 1] == 0);
+    }
+
+    FILE *file = fopen(path_out, "wb");
+    if (file == nullptr) {
+        throw std::runtime_error((std::string)"run_bench: cannot open " + path_out);
+    }
+    const char endline[] = {'\r', 0, '\n', 0};
+    size_t size = text.size(), copies = 1;
+    bool ok = (fwrite(text.data(), 1, text.size(), file) == text.size());
+    while (ok && size < megabytes << 20) {
+        ok = (fwrite(endline, 1, sizeof(endline), file) == sizeof(endline) &&
+              fwrite(text.data() + bom_size, 1, text.size() - bom_size, file) == text.size() - bom_size);
+        size += sizeof(endline) + text.size() - bom_size;
+        copies++;
+    }
+    if (fclose(file) != 0 || !ok) {
+        throw std::runtime_error((std::string)"run_bench: error occurred while writing in " + path_out);
+    }
+    return nlines * copies;
+}
+
+/*
+Writes the lines of the file at path to path_out with write_lines with several buffer sizes
+and prints a CSV line for every size
+*/
+void bench_writing(const char *name, const char *path, const char *path_out, size_t megabytes)
+{
+    const struct {
+        const char *name;
+        size_t buffer_size;
+    } writers[] = {
+        {"write_per_line",   0},
+        {"write_buffer_4k",  1 << 12},
+        {"write_buffer_64k", 1 << 16},
+        {"write_buffer_1m",  WRITE_BUFFER_SIZE},
+        {"write_buffer_16m", 1 << 24},
+    };
+
+    mapped_file file_in(path);
+    std::vector< std::basic_string_view<char16_t> > lines =
+        split_lines((const char16_t *)file_in.data(), 1, file_in.size() / sizeof(char16_t));
+    for (const auto &writer : writers) {
+        auto start = std::chrono::steady_clock::now();
+        FILE *file_out = fopen(path_out, "wb");
+        if (file_out == nullptr) {
+            throw std::runtime_error((std::string)"run_bench: cannot open " + path_out);
+        }
+        write_lines(file_out, lines, path_out, writer.buffer_size);
+        if (fclose(file_out) != 0) {
+            throw std::runtime_error((std::string)"run_bench: cannot close " + path_out);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        printf("%s,%s,%zu,%zu,%.3f,%.0f\n", name, writer.name, megabytes, lines.size(), seconds, lines.size() / seconds);
+        fflush(stdout);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    size_t megabytes = 256;
+    bool compare_lines = false, writing = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-l") == 0) {
+            compare_lines = true;
+        } else if (strcmp(argv[i], "-w") == 0) {
+            writing = true;
+        } else if ((megabytes = strtoull(argv[i], nullptr, 10)) == 0) {
+            fprintf(stderr, "Usage: %s [-l] [-w] [megabytes]\n"
+                            "  -l  also sort with COMPARE_LINES (QuickSort is slow on the long runs of equal lines)\n"
+                            "  -w  measure writing the lines with several buffer sizes instead of sorting\n", argv[0]);
+            return 1;
+        }
+    }
+
+    const struct {
+        const char *name;
+        const char *path;
+        language lang;
+    } texts[] = {
+        {"romeo_and_juliet", "romeo_and_juliet.txt", ENGLISH},
+        {"eugene_onegin",    "eugene_onegin.txt",    RUSSIAN},
+    };
+    const struct {
+        const char *name;
+        sorting_method method;
+    } methods[] = {
+        {"compare_lines", COMPARE_LINES},
+        {"compare_keys",  COMPARE_KEYS},
+        {"multikey_keys", MULTIKEY_KEYS},
+    };
+
+    printf("text,method,megabytes,lines,seconds,lines_per_sec\n");
+    try {
+        for (const auto &text : texts) {
+            const std::string path = (std::string)"bench_" + text.name + ".txt";
+            const std::string sorted = (std::string)"bench_" + text.name + "_sorted.txt";
+            const std::string sorted_back = (std::string)"bench_" + text.name + "_sorted_back.txt";
+            const std::string origin = (std::string)"bench_" + text.name + "_origin.txt";
+            size_t nlines = replicate_text(text.path, path.c_str(), megabytes);
+            if (writing) {
+                bench_writing(text.name, path.c_str(), sorted.c_str(), megabytes);
+            }
+            for (const auto &method : methods) {
+                if (writing || (method.method == COMPARE_LINES && !compare_lines)) {
+                    continue;
+                }
+                auto start = std::chrono::steady_clock::now();
+                sort_text(path.c_str(), sorted.c_str(), sorted_back.c_str(), origin.c_str(), text.lang, method.method);
+                double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                printf("%s,%s,%zu,%zu,%.3f,%.0f\n", text.name, method.name, megabytes, nlines, seconds, nlines / seconds);
+                fflush(stdout);
+            }
+            remove(path.c_str());
+            remove(sorted.c_str());
+            remove(sorted_back.c_str());
+            remove(origin.c_str());
+        }
+    } catch (const std::exception &e) {
+        fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
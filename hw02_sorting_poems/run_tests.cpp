@@ -1,12 +1,23 @@
 #include "qsort.h"
+#include "parallel_sort.h"
 #include "windows_unit_tests.h"
 #include "text_sorting.h"
+#include "collation_keys.h"
+#include "multikey_qsort.h"
+#include "mapped_file.h"
+#include "external_sorting.h"
+#include "line_splitting.h"
+#include "line_writing.h"
 
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <string>
 #include <string_view>
 #include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
 
 
 #define $test_qsort(vec, cmp)                    \
@@ -51,6 +62,447 @@ std::ostream& operator<< (std::ostream &out, const std::basic_string_view<char16
     return out;
 }
 
+/*
+Sorts n random numbers from 0 to max_value with parallel_sort in nthreads threads and returns true if the result is the same as of std::sort
+*/
+bool parallel_sort_matches(size_t n, int max_value, unsigned nthreads)
+{
+    std::vector<int> vec1(n);
+    for (size_t i = 0; i < n; i++) {
+        vec1[i] = rand() % (max_value + 1);
+    }
+    std::vector<int> vec2 = vec1;
+    parallel_sort<int>(&vec1[0], &vec1[0] + vec1.size(), [](const int &arg1, const int &arg2) { return (arg1 <= arg2); }, nthreads);
+    std::sort(vec2.begin(), vec2.end());
+    return vec1 == vec2;
+}
+
+/*
+Makes n random lines of symbols from alphabet and returns the number of pairs of neighbour lines
+which collation keys compare not as the lines by cmp
+*/
+size_t count_key_mismatches(size_t n, const std::basic_string_view<char16_t> &alphabet, language lang, bool reverse,
+                            int (*cmp)(const std::basic_string_view<char16_t> &, const std::basic_string_view<char16_t> &))
+{
+    std::vector< std::basic_string<char16_t> > strings(n);
+    for (std::basic_string<char16_t> &str : strings) {
+        size_t size = rand() % 40;
+        for (size_t i = 0; i < size; i++) {
+            str.push_back(alphabet[rand() % alphabet.size()]);
+        }
+    }
+    std::vector< std::basic_string_view<char16_t> > lines(strings.begin(), strings.end());
+    collation_keys keys(lines, lang, reverse);
+    size_t mismatches = 0;
+    for (size_t i = 0; i + 1 < n; i++) {
+        if (compare_collation_keys(keys.keys()[i], keys.keys()[i + 1]) != cmp(lines[i], lines[i + 1])) {
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+/*
+Sorts collation keys of n random lines of symbols from alphabet with multikey_qsort and returns true
+if the result is the same as of std::sort with compare_collation_keys (equal keys by their indices)
+*/
+bool multikey_qsort_matches(size_t n, const std::basic_string_view<char16_t> &alphabet, language lang, size_t max_size)
+{
+    std::vector< std::basic_string<char16_t> > strings(n);
+    for (std::basic_string<char16_t> &str : strings) {
+        size_t size = rand() % (max_size + 1);
+        for (size_t i = 0; i < size; i++) {
+            str.push_back(alphabet[rand() % alphabet.size()]);
+        }
+    }
+    std::vector< std::basic_string_view<char16_t> > lines(strings.begin(), strings.end());
+    collation_keys keys(lines, lang, false);
+    std::vector<collation_key> keys1 = keys.keys(), keys2 = keys.keys();
+    multikey_qsort(&keys1[0], &keys1[0] + keys1.size());
+    std::sort(keys2.begin(), keys2.end(), [](const collation_key &key1, const collation_key &key2) {
+        int res = compare_collation_keys(key1, key2);
+        return res < 0 || (res == 0 && key1.index < key2.index);
+    });
+    for (size_t i = 0; i < n; i++) {
+        if (keys1[i].index != keys2[i].index) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+Writes size bytes to the file at path, maps it and returns true if the mapping has the same size and bytes
+*/
+bool mapped_file_matches(const char *path, size_t size)
+{
+    std::vector<char> bytes(size);
+    for (size_t i = 0; i < size; i++) {
+        bytes[i] = (char)rand();
+    }
+    FILE *file = fopen(path, "wb");
+    if (file == nullptr || fwrite(bytes.data(), 1, size, file) != size || fclose(file) != 0) {
+        return false;
+    }
+    bool matches = false;
+    {
+        mapped_file mapping(path);
+        mapping.advise(NORMAL_ACCESS);
+        matches = (mapping.size() == size && (size == 0 ? mapping.data() == nullptr : memcmp(mapping.data(), bytes.data(), size) == 0));
+    }
+    remove(path);
+    return matches;
+}
+
+/*
+Returns true if mapping the file at path throws std::runtime_error
+*/
+bool mapped_file_throws(const char *path)
+{
+    try {
+        mapped_file mapping(path);
+    } catch (const std::runtime_error &) {
+        return true;
+    }
+    return false;
+}
+
+/*
+Returns true if the files have the same bytes
+*/
+bool files_equal(const char *path1, const char *path2)
+{
+    FILE *file1 = fopen(path1, "rb"), *file2 = fopen(path2, "rb");
+    bool equal = (file1 != nullptr && file2 != nullptr);
+    while (equal) {
+        int c1 = fgetc(file1), c2 = fgetc(file2);
+        equal = (c1 == c2);
+        if (c1 == EOF) {
+            break;
+        }
+    }
+    if (file1 != nullptr) {
+        fclose(file1);
+    }
+    if (file2 != nullptr) {
+        fclose(file2);
+    }
+    return equal;
+}
+
+/*
+Writes a text of n random lines of symbols from alphabet, sorts it with sort_text and sort_text_external
+and returns true if all the output files are the same
+*/
+bool external_sort_matches(size_t n, const std::basic_string_view<char16_t> &alphabet, language lang, size_t memory_budget)
+{
+    std::basic_string<char16_t> text(1, 0xfeff);
+    for (size_t i = 0; i < n; i++) {
+        if (i > 0) {
+            text += u"\r\n";
+        }
+        size_t size = rand() % 60;
+        for (size_t j = 0; j < size; j++) {
+            text.push_back(alphabet[rand() % alphabet.size()]);
+        }
+    }
+    FILE *file = fopen("external_test.txt", "wb");
+    if (file == nullptr || fwrite(text.data(), sizeof(text[0]), text.size(), file) != text.size() || fclose(file) != 0) {
+        return false;
+    }
+    const char *paths[] = {"external_test_sorted.txt", "external_test_sorted_back.txt", "external_test_origin.txt",
+                           "external_test_sorted_ext.txt", "external_test_sorted_back_ext.txt", "external_test_origin_ext.txt"};
+    sort_text("external_test.txt", paths[0], paths[1], paths[2], lang);
+    sort_text_external("external_test.txt", paths[3], paths[4], paths[5], lang, memory_budget);
+    bool matches = files_equal(paths[0], paths[3]) && files_equal(paths[1], paths[4]) && files_equal(paths[2], paths[5]);
+    remove("external_test.txt");
+    for (const char *path : paths) {
+        remove(path);
+    }
+    return matches;
+}
+
+/*
+Returns the result of find_line_end for the text, size if it throws
+*/
+size_t line_end_or_size(const std::basic_string<char16_t> &text, size_t begin)
+{
+    try {
+        return find_line_end(text.data(), begin, text.size());
+    } catch (const std::invalid_argument &) {
+        return text.size() + 1;
+    }
+}
+
+/*
+Makes ntexts random texts of symbols from alphabet (with some "\r\n"), returns true if find_line_end
+finds the same ends of the lines as the symbol by symbol search
+*/
+bool find_line_end_matches(size_t ntexts, const std::basic_string_view<char16_t> &alphabet)
+{
+    for (size_t t = 0; t < ntexts; t++) {
+        std::basic_string<char16_t> text;
+        size_t size = rand() % 100;
+        while (text.size() < size) {
+            if (rand() % 20 == 0) {
+                text += u"\r\n";
+            } else {
+                text.push_back(alphabet[rand() % alphabet.size()]);
+            }
+        }
+        size_t begin = rand() % (text.size() + 1);
+        size_t expected = text.size();
+        for (size_t i = begin; i < text.size(); i++) {
+            if (text[i] == '\r' && i + 1 < text.size() && text[i + 1] == '\n') {
+                expected = i;
+                break;
+            }
+            if (text[i] == '\r' || text[i] == '\n' || text[i] == '\0') {
+                expected = text.size() + 1;
+                break;
+            }
+        }
+        if (line_end_or_size(text, begin) != expected) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+Makes ntexts random texts of symbols from alphabet (with many "\r\n"), returns true if split_lines in nthreads threads
+with chunks of chunk_size symbols splits them as find_line_end line by line (or throws if find_line_end throws)
+*/
+bool split_lines_matches(size_t ntexts, const std::basic_string_view<char16_t> &alphabet, unsigned nthreads, size_t chunk_size)
+{
+    for (size_t t = 0; t < ntexts; t++) {
+        std::basic_string<char16_t> text(1, 0xfeff);
+        size_t size = rand() % 200;
+        while (text.size() < size) {
+            if (rand() % 4 == 0) {
+                text += u"\r\n";
+            } else {
+                text.push_back(alphabet[rand() % alphabet.size()]);
+            }
+        }
+        std::vector< std::basic_string_view<char16_t> > expected;
+        bool expected_throws = false;
+        try {
+            for (size_t begin = 1; ; ) {
+                size_t end = find_line_end(text.data(), begin, text.size());
+                expected.push_back({text.data() + begin, end - begin});
+                if (end == text.size()) {
+                    break;
+                }
+                begin = end + 2;
+            }
+        } catch (const std::invalid_argument &) {
+            expected_throws = true;
+        }
+        try {
+            bool same_lines = (split_lines(text.data(), 1, text.size(), nthreads, chunk_size) == expected);
+            if (expected_throws || !same_lines) {
+                return false;
+            }
+        } catch (const std::invalid_argument &) {
+            if (!expected_throws) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/*
+Writes n random lines of up to max_size symbols with write_lines with the buffer of buffer_size bytes to the file at path
+and returns true if the file has the lines separated by "\r\n"
+*/
+bool write_lines_matches(const char *path, size_t n, size_t max_size, size_t buffer_size)
+{
+    std::vector< std::basic_string<char16_t> > strings(n);
+    std::basic_string<char16_t> expected;
+    for (size_t i = 0; i < n; i++) {
+        size_t size = rand() % (max_size + 1);
+        for (size_t j = 0; j < size; j++) {
+            strings[i].push_back((char16_t)(1 + rand() % 0xfffe));
+        }
+        if (i > 0) {
+            expected += u"\r\n";
+        }
+        expected += strings[i];
+    }
+    std::vector< std::basic_string_view<char16_t> > lines(strings.begin(), strings.end());
+    FILE *file = fopen(path, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    write_lines(file, lines, path, buffer_size);
+    if (fclose(file) != 0) {
+        return false;
+    }
+    bool matches = false;
+    {
+        mapped_file mapping(path);
+        matches = (mapping.size() == expected.size() * sizeof(char16_t) &&
+                   (expected.empty() || memcmp(mapping.data(), expected.data(), mapping.size()) == 0));
+    }
+    remove(path);
+    return matches;
+}
+
+/*
+Returns UTF-8 version of the string (the symbols must not be surrogates)
+*/
+std::string to_utf8(const std::basic_string_view<char16_t> &str)
+{
+    std::string utf8;
+    for (char16_t c : str) {
+        if (c < 0x80) {
+            utf8.push_back((char)c);
+        } else if (c < 0x800) {
+            utf8.push_back((char)(0xc0 | (c >> 6)));
+            utf8.push_back((char)(0x80 | (c & 0x3f)));
+        } else {
+            utf8.push_back((char)(0xe0 | (c >> 12)));
+            utf8.push_back((char)(0x80 | ((c >> 6) & 0x3f)));
+            utf8.push_back((char)(0x80 | (c & 0x3f)));
+        }
+    }
+    return utf8;
+}
+
+/*
+Makes n random lines of symbols from alphabet and returns the number of pairs of neighbour lines
+which UTF-8 versions compare by cmp8 not as the lines by cmp16
+*/
+size_t count_utf8_mismatches(size_t n, const std::basic_string_view<char16_t> &alphabet,
+                             int (*cmp16)(const std::basic_string_view<char16_t> &, const std::basic_string_view<char16_t> &),
+                             int (*cmp8)(const std::string_view &, const std::string_view &))
+{
+    std::vector< std::basic_string<char16_t> > strings(n);
+    for (std::basic_string<char16_t> &str : strings) {
+        size_t size = rand() % 20;
+        for (size_t i = 0; i < size; i++) {
+            str.push_back(alphabet[rand() % alphabet.size()]);
+        }
+    }
+    size_t mismatches = 0;
+    for (size_t i = 0; i + 1 < n; i++) {
+        if (cmp8(to_utf8(strings[i]), to_utf8(strings[i + 1])) != cmp16(strings[i], strings[i + 1])) {
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+/*
+Reads the whole file, returns an empty string if it cannot be opened
+*/
+std::string read_file(const char *path)
+{
+    std::string data;
+    FILE *file = fopen(path, "rb");
+    if (file == nullptr) {
+        return data;
+    }
+    char buffer[1 << 12];
+    size_t nread = 0;
+    while ((nread = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data.append(buffer, nread);
+    }
+    fclose(file);
+    return data;
+}
+
+/*
+Writes a text of n random lines of symbols from alphabet in UTF-16 and in UTF-8 (with byte order mask if bom),
+sorts both with sort_text and returns true if the UTF-8 output files are the UTF-8 versions of the UTF-16 ones
+*/
+bool utf8_sort_matches(size_t n, const std::basic_string_view<char16_t> &alphabet, language lang, sorting_method method, bool bom)
+{
+    std::basic_string<char16_t> text;
+    for (size_t i = 0; i < n; i++) {
+        if (i > 0) {
+            text += u"\r\n";
+        }
+        size_t size = rand() % 30;
+        for (size_t j = 0; j < size; j++) {
+            text.push_back(alphabet[rand() % alphabet.size()]);
+        }
+    }
+    const std::string utf8_bom = (bom ? "\xef\xbb\xbf" : "");
+    // the UTF-8 text has "\n" instead of "\r\n"
+    auto utf8_version = [&](std::basic_string<char16_t> utf16) {
+        utf16.erase(std::remove(utf16.begin(), utf16.end(), u'\r'), utf16.end());
+        return utf8_bom + to_utf8(utf16);
+    };
+    const std::basic_string<char16_t> utf16_text = u"\ufeff" + text;
+    const std::string utf8_text = utf8_version(text);
+    FILE *file16 = fopen("utf16_test.txt", "wb"), *file8 = fopen("utf8_test.txt", "wb");
+    bool written = (file16 != nullptr && file8 != nullptr &&
+                    fwrite(utf16_text.data(), sizeof(char16_t), utf16_text.size(), file16) == utf16_text.size() &&
+                    fwrite(utf8_text.data(), 1, utf8_text.size(), file8) == utf8_text.size());
+    if (file16 != nullptr) {
+        written = (fclose(file16) == 0 && written);
+    }
+    if (file8 != nullptr) {
+        written = (fclose(file8) == 0 && written);
+    }
+    if (!written) {
+        return false;
+    }
+    const char *paths16[] = {"utf16_test_sorted.txt", "utf16_test_sorted_back.txt", "utf16_test_origin.txt"};
+    const char *paths8[] = {"utf8_test_sorted.txt", "utf8_test_sorted_back.txt", "utf8_test_origin.txt"};
+    sort_text("utf16_test.txt", paths16[0], paths16[1], paths16[2], lang, method);
+    sort_text("utf8_test.txt", paths8[0], paths8[1], paths8[2], lang, method);
+    bool matches = true;
+    for (size_t i = 0; i < 3; i++) {
+        std::string output16 = read_file(paths16[i]);
+        std::basic_string<char16_t> lines16((const char16_t *)output16.data() + 1, output16.size() / sizeof(char16_t) - 1);
+        matches = matches && (read_file(paths8[i]) == utf8_version(lines16));
+        remove(paths16[i]);
+        remove(paths8[i]);
+    }
+    remove("utf16_test.txt");
+    remove("utf8_test.txt");
+    return matches;
+}
+
+/*
+Returns true if split_utf8_lines throws std::invalid_argument on the text
+*/
+bool split_utf8_lines_throws(const std::string_view &text)
+{
+    try {
+        split_utf8_lines(text.data(), 0, text.size());
+    } catch (const std::invalid_argument &) {
+        return true;
+    }
+    return false;
+}
+
+/*
+Writes the UTF-16 text without byte order mask to the file and returns true if sort_text throws std::invalid_argument on it
+*/
+bool sort_text_throws_without_bom(const std::basic_string_view<char16_t> &text, language lang)
+{
+    FILE *file = fopen("no_bom_test.txt", "wb");
+    if (file == nullptr || fwrite(text.data(), sizeof(text[0]), text.size(), file) != text.size() || fclose(file) != 0) {
+        return false;
+    }
+    bool thrown = false;
+    try {
+        sort_text("no_bom_test.txt", "no_bom_test_sorted.txt", "no_bom_test_sorted_back.txt", "no_bom_test_origin.txt", lang);
+    } catch (const std::invalid_argument &) {
+        thrown = true;
+    }
+    remove("no_bom_test.txt");
+    remove("no_bom_test_sorted.txt");
+    remove("no_bom_test_sorted_back.txt");
+    remove("no_bom_test_origin.txt");
+    return thrown;
+}
+
 int main() {
     comparator<int> int_cmp = [](const int &arg1, const int &arg2) { return (arg1 <= arg2); };
 
@@ -116,6 +568,16 @@ int main() {
     }
     $test_qsort(big_vec, int_cmp);
 
+    std::cout << "Testing parallel_sort" << std::endl;
+
+    $unit_test(parallel_sort_matches(100, RAND_MAX, 4), true);
+    $unit_test(parallel_sort_matches(100000, RAND_MAX, 1), true);
+    $unit_test(parallel_sort_matches(100000, RAND_MAX, 3), true);
+    $unit_test(parallel_sort_matches(100000, 10, 4), true);
+    $unit_test(parallel_sort_matches(300001, 0, 7), true);
+    $unit_test(parallel_sort_matches(1000000, RAND_MAX, 0), true);
+    std::cout << std::endl;
+
     std::cout << "Testing comparators" << std::endl;
 
     const char16_t char_arr1[] = {'h', 'e', 'l', 'l', 'o', ' ', 'w', 'o', 'r', 'l', 'd' };
@@ -149,6 +611,115 @@ int main() {
     $test_str_cmp(compare_en_strings_r, str1, str2, 1);
     $test_str_cmp(compare_en_strings_r, str2, str1, -1);
 
+    std::cout << "Testing collation keys" << std::endl;
+
+    // few symbols, so that the lines often have long common prefixes
+    const char16_t en_alphabet[] = u"aAbB09 .,!-\u0430";
+    const char16_t ru_alphabet[] = u"\u0430\u0410\u0435\u0415\u0451\u0401\u0436\u0416\u044f\u042f09 .,!a";
+    const std::basic_string_view<char16_t> en_chars(en_alphabet), ru_chars(ru_alphabet);
+    $unit_test(count_key_mismatches(10000, en_chars, ENGLISH, false, compare_en_strings) == 0, true);
+    $unit_test(count_key_mismatches(10000, en_chars, ENGLISH, true, compare_en_strings_r) == 0, true);
+    $unit_test(count_key_mismatches(10000, ru_chars, RUSSIAN, false, compare_ru_strings) == 0, true);
+    $unit_test(count_key_mismatches(10000, ru_chars, RUSSIAN, true, compare_ru_strings_r) == 0, true);
+    $unit_test(count_key_mismatches(10000, en_chars.substr(0, 2), ENGLISH, false, compare_en_strings) == 0, true);
+    $unit_test(count_key_mismatches(10000, ru_chars.substr(4, 4), RUSSIAN, true, compare_ru_strings_r) == 0, true);
+    std::cout << std::endl;
+
+    std::cout << "Testing find_line_end" << std::endl;
+
+    const char16_t special_alphabet[] = {'a', 'b', 0x430, 0x0d0a, '\r', '\n', 0};
+    $unit_test(find_line_end_matches(100000, en_chars), true);
+    $unit_test(find_line_end_matches(100000, std::basic_string_view<char16_t>(special_alphabet, 4)), true);
+    $unit_test(find_line_end_matches(100000, std::basic_string_view<char16_t>(special_alphabet, 7)), true);
+    std::cout << std::endl;
+
+    std::cout << "Testing split_lines" << std::endl;
+
+    $unit_test(split_lines_matches(10000, en_chars, 1, 1), true);
+    $unit_test(split_lines_matches(10000, en_chars, 3, 1), true);
+    $unit_test(split_lines_matches(10000, en_chars, 4, 2), true);
+    $unit_test(split_lines_matches(10000, en_chars, 2, 7), true);
+    $unit_test(split_lines_matches(10000, en_chars, 0, SPLIT_CHUNK_SIZE), true);
+    $unit_test(split_lines_matches(10000, std::basic_string_view<char16_t>(special_alphabet, 7), 4, 3), true);
+    $unit_test(split_lines_matches(10000, std::basic_string_view<char16_t>(special_alphabet, 7), 2, 64), true);
+    std::cout << std::endl;
+
+    std::cout << "Testing UTF-8 comparators" << std::endl;
+
+    const char16_t utf8_en_alphabet[] = u"aAbB09 .,!-\u0430\u00e9\u2014";
+    const char16_t utf8_ru_alphabet[] = u"\u0430\u0410\u0435\u0415\u0451\u0401\u0436\u0416\u044f\u042f09 .,!a\u00e9\u2014";
+    const std::basic_string_view<char16_t> utf8_en_chars(utf8_en_alphabet), utf8_ru_chars(utf8_ru_alphabet);
+    $unit_test(count_utf8_mismatches(10000, utf8_en_chars, compare_en_strings, compare_en_strings) == 0, true);
+    $unit_test(count_utf8_mismatches(10000, utf8_en_chars, compare_en_strings_r, compare_en_strings_r) == 0, true);
+    $unit_test(count_utf8_mismatches(10000, utf8_ru_chars, compare_ru_strings, compare_ru_strings) == 0, true);
+    $unit_test(count_utf8_mismatches(10000, utf8_ru_chars, compare_ru_strings_r, compare_ru_strings_r) == 0, true);
+    $unit_test(compare_ru_strings(std::string_view("\xd1\x91"), std::string_view("\xd0\xb6")), -1);
+    $unit_test(compare_en_strings_r(std::string_view("a\xd0\xb0"), std::string_view("\xd0\xb0" "A")), 0);
+    std::cout << std::endl;
+
+    std::cout << "Testing sort_text on UTF-8" << std::endl;
+
+    $unit_test(utf8_sort_matches(0, utf8_en_chars, ENGLISH, COMPARE_KEYS, false), true);
+    $unit_test(utf8_sort_matches(1000, utf8_en_chars, ENGLISH, COMPARE_KEYS, false), true);
+    $unit_test(utf8_sort_matches(1000, utf8_en_chars, ENGLISH, COMPARE_LINES, true), true);
+    $unit_test(utf8_sort_matches(1000, utf8_ru_chars, RUSSIAN, COMPARE_KEYS, true), true);
+    $unit_test(utf8_sort_matches(1000, utf8_ru_chars, RUSSIAN, COMPARE_LINES, false), true);
+    $unit_test(utf8_sort_matches(1000, utf8_ru_chars, RUSSIAN, MULTIKEY_KEYS, false), true);
+    $unit_test(utf8_sort_matches(50000, utf8_ru_chars, RUSSIAN, COMPARE_KEYS, false), true);
+    $unit_test(split_utf8_lines_throws(std::string_view("abc\n\xd0\xb0\xe2\x80\x94\xf0\x9f\x98\x80\r\n")), false);
+    $unit_test(split_utf8_lines_throws(std::string_view("0123456789abcdef0123456789abcdef\xd1\x91")), false);
+    $unit_test(split_utf8_lines_throws(std::string_view("ab\0c", 4)), true);
+    $unit_test(split_utf8_lines_throws(std::string_view("0123456789abcdef0123456789\0abcdef", 33)), true);
+    $unit_test(split_utf8_lines_throws(std::string_view("\xc0\x80")), true);
+    $unit_test(split_utf8_lines_throws(std::string_view("\xed\xa0\x80")), true);
+    $unit_test(split_utf8_lines_throws(std::string_view("\xf4\x90\x80\x80")), true);
+    $unit_test(split_utf8_lines_throws(std::string_view("a\xe2\x80")), true);
+    $unit_test(split_utf8_lines_throws(std::string_view("\xd0" "a")), true);
+    $unit_test(split_utf8_lines_throws(std::string_view("\xff")), true);
+    $unit_test(sort_text_throws_without_bom(u"Two households\r\nboth alike", ENGLISH), true);
+    $unit_test(sort_text_throws_without_bom(u"\u0430\u0431\r\n\u0432", RUSSIAN), true);
+    std::cout << std::endl;
+
+    std::cout << "Testing write_lines" << std::endl;
+
+    $unit_test(write_lines_matches("write_lines_test.txt", 0, 10, WRITE_BUFFER_SIZE), true);
+    $unit_test(write_lines_matches("write_lines_test.txt", 1, 0, WRITE_BUFFER_SIZE), true);
+    $unit_test(write_lines_matches("write_lines_test.txt", 1000, 50, 0), true);
+    $unit_test(write_lines_matches("write_lines_test.txt", 1000, 50, 1), true);
+    $unit_test(write_lines_matches("write_lines_test.txt", 1000, 50, 7), true);
+    $unit_test(write_lines_matches("write_lines_test.txt", 1000, 50, 64), true);
+    $unit_test(write_lines_matches("write_lines_test.txt", 10000, 50, WRITE_BUFFER_SIZE), true);
+    $unit_test(write_lines_matches("write_lines_test.txt", 100, 5000, 1 << 12), true);
+    std::cout << std::endl;
+
+    std::cout << "Testing mapped_file" << std::endl;
+
+    $unit_test(mapped_file_matches("mapped_file_test.txt", 0), true);
+    $unit_test(mapped_file_matches("mapped_file_test.txt", 1), true);
+    $unit_test(mapped_file_matches("mapped_file_test.txt", 100000), true);
+    $unit_test(mapped_file_throws("no_such_directory/no_such_file.txt"), true);
+    std::cout << std::endl;
+
+    std::cout << "Testing sort_text_external" << std::endl;
+
+    $unit_test(external_sort_matches(1, en_chars, ENGLISH, 4096), true);
+    $unit_test(external_sort_matches(100, en_chars, ENGLISH, 1 << 20), true);
+    $unit_test(external_sort_matches(10000, en_chars, ENGLISH, 4096), true);
+    $unit_test(external_sort_matches(10000, ru_chars, RUSSIAN, 4096), true);
+    $unit_test(external_sort_matches(50000, ru_chars.substr(0, 4), RUSSIAN, 1 << 16), true);
+    $unit_test(external_sort_matches(50000, en_chars.substr(0, 2), ENGLISH, 1 << 18), true);
+    std::cout << std::endl;
+
+    std::cout << "Testing multikey_qsort" << std::endl;
+
+    $unit_test(multikey_qsort_matches(1, en_chars, ENGLISH, 10), true);
+    $unit_test(multikey_qsort_matches(10, en_chars, ENGLISH, 10), true);
+    $unit_test(multikey_qsort_matches(10000, en_chars, ENGLISH, 40), true);
+    $unit_test(multikey_qsort_matches(10000, ru_chars, RUSSIAN, 40), true);
+    $unit_test(multikey_qsort_matches(10000, en_chars.substr(0, 2), ENGLISH, 100), true);
+    $unit_test(multikey_qsort_matches(100000, en_chars.substr(5, 5), ENGLISH, 3), true);
+    std::cout << std::endl;
+
     $testing_result();
 
     return 0;
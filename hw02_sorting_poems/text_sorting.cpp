@@ -5,67 +5,41 @@
 #include <cctype>
 #include <string>
 #include <string_view>
-#include <windows.h>
 #include <vector>
 #include <cstdio>
+#include <cstdint>
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <thread>
 
 #include "text_sorting.h"
 #include "qsort.h"
+#include "parallel_sort.h"
+#include "collation_keys.h"
+#include "multikey_qsort.h"
+#include "mapped_file.h"
+#include "line_splitting.h"
+#include "line_writing.h"
+#include "utf8_symbols.h"
 
 
-std::string GetLastErrorAsString()
+std::vector< std::basic_string_view<char16_t> > data_to_strings(const char16_t *file_data, size_t file_size)
 {
-    LPSTR messageBuffer = nullptr;
-    size_t size = FormatMessageA(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
-                                 NULL, GetLastError(), MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT), (LPSTR)&messageBuffer, 0, NULL);
-    std::string message(messageBuffer, size);
-    LocalFree(messageBuffer);
-    return message;
-}
-
-std::vector< std::basic_string_view<char16_t> > data_to_strings(const char16_t *file_data, uint32_t file_size)
-{
-    assert(file_data);
     size_t file_data_size = file_size / sizeof(file_data[0]);
-
-    size_t string_num = 1; // the last string ends with EOF not "\r\n"
-    for (size_t i = 0; i < file_data_size; i++) {
-        if (file_data[i] == '\r') {
-            if (i + 1 < file_data_size && file_data[i + 1] == '\n') {
-                string_num++;
-                i++; // skipping '\n'
-            } else {
-                throw std::invalid_argument("data_to_strings: in file file_in_path there is '\r' which is not belong to \"\r\n\"");
-            }
-        } else if (file_data[i] == '\n'){
-            throw std::invalid_argument("data_to_strings: in file file_in_path there is '\n' which is not belong to \"\r\n\"");
-        } else if (file_data[i] == '\0') {
-            throw std::invalid_argument("data_to_strings: in file file_in_path there is '\0'");
-        }
-    }
-
-    std::vector< std::basic_string_view<char16_t> > string_vec(string_num);
-
-    { //initializing string_vec
-        size_t cur_char = 0, cur_string = 0, cur_string_begin_char = 0;
-        if (file_data[0] == 0xfeff) { // skipping Byte Order Mark
-            cur_char++;
-            cur_string_begin_char = cur_char;
-            for (; cur_char < file_data_size; cur_char++) {
-                if(file_data[cur_char] == '\r') {
-                    string_vec[cur_string++] = {&file_data[cur_string_begin_char], cur_char - cur_string_begin_char};
-                    cur_char++; // skipping '\n'
-                    cur_string_begin_char = cur_char + 1;
-                }
-            }
-            string_vec[cur_string++] = {&file_data[cur_string_begin_char], cur_char - cur_string_begin_char};
-            assert(cur_string == string_num);
-        } else if (file_data[0] == 0xfffe) {
-            throw std::invalid_argument("data_to_strings: file has incorrect endianness");
-        } else {
-            throw std::invalid_argument("data_to_strings: file has no byte order mask");
-        }
+    if (file_data_size == 0) {
+        throw std::invalid_argument("data_to_strings: file has no byte order mask");
     }
+    assert(file_data);
+    if (file_data[0] == 0xfffe) {
+        throw std::invalid_argument("data_to_strings: file has incorrect endianness");
+    } else if (file_data[0] != 0xfeff) {
+        throw std::invalid_argument("data_to_strings: file has no byte order mask");
+    }
+
+    // skipping Byte Order Mark
+    std::vector< std::basic_string_view<char16_t> > string_vec = split_lines(file_data, 1, file_data_size);
+    assert(!string_vec.empty());
 
     return string_vec;
 }
@@ -280,135 +254,269 @@ int compare_ru_strings_r(const std::basic_string_view<char16_t> &str1, const std
 
 //---------------------------------------------------------------------------------------------------
 
-void print_to_file (FILE *file_out, std::vector< std::basic_string_view<char16_t> > &string_vec, const char *file_name) {
-    char16_t endline[2] = {'\r', '\n' };
-    if (string_vec.size() > 0) {
-        size_t i = 0;
-        for (; i < string_vec.size() - 1; i++) {
-            size_t written = fwrite((void *)string_vec[i].data(), sizeof(string_vec[i][0]), string_vec[i].size(), file_out);
-            if (written != string_vec[i].size()) {
-                throw std::runtime_error((std::string)"sort_text: error occurred while writing in" + file_name);
-            }
-            if (fwrite((void *)endline, sizeof(endline[0]), 2, file_out) != 2) {
-                throw std::runtime_error((std::string)"sort_text: error occurred while writing in " + file_name);
-            }
+/*
+Returns the next English letter (lowercased) or digit of UTF-8 str from i and moves i after it, 0 if there is none.
+English letters and digits are ASCII, so the bytes are not decoded
+*/
+inline char next_en_char_dig(const std::string_view &str, size_t &i) {
+    while (i < str.size()) {
+        char c = str[i++];
+        if (is_en_char_dig(c)) {
+            return (char)std::tolower(c);
         }
-        size_t written = fwrite((void *)string_vec[i].data(), sizeof(string_vec[i][0]), string_vec[i].size(), file_out);
-        if (written != string_vec[i].size()) {
-            throw std::runtime_error((std::string)"sort_text: error occurred while writing in" + file_name);
+    }
+    return 0;
+}
+
+/*
+Returns the previous English letter (lowercased) or digit of UTF-8 str before end and moves end to it, 0 if there is none
+*/
+inline char prev_en_char_dig(const std::string_view &str, size_t &end) {
+    while (end > 0) {
+        char c = str[--end];
+        if (is_en_char_dig(c)) {
+            return (char)std::tolower(c);
         }
     }
+    return 0;
 }
 
-void sort_text(const char *file_in_path, const char *file_out_sorted_path, const char *file_out_sorted_back_path, const char *file_out_origin_path, language lang)
-{
-    HANDLE file_in_handle = CreateFile(file_in_path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
-    if (file_in_handle == INVALID_HANDLE_VALUE) {
-        throw std::runtime_error((std::string)"sort_text: cannot open file_in_path: " + GetLastErrorAsString());
+/*
+Returns the next Russian letter (lowercased) or digit of UTF-8 str from i and moves i after it, 0 if there is none
+*/
+inline char16_t next_ru_char_dig(const std::string_view &str, size_t &i) {
+    while (i < str.size()) {
+        char16_t c = is_ru_char_dig_tolower(next_utf8_symbol(str, i));
+        if (c != 0) {
+            return c;
+        }
+    }
+    return 0;
+}
+
+/*
+Returns the previous Russian letter (lowercased) or digit of UTF-8 str before end and moves end to it, 0 if there is none
+*/
+inline char16_t prev_ru_char_dig(const std::string_view &str, size_t &end) {
+    while (end > 0) {
+        char16_t c = is_ru_char_dig_tolower(prev_utf8_symbol(str, end));
+        if (c != 0) {
+            return c;
+        }
+    }
+    return 0;
+}
+
+int compare_en_strings(const std::string_view &str1, const std::string_view &str2) {
+    size_t i1 = 0, i2 = 0;
+    while (true) {
+        char c1 = next_en_char_dig(str1, i1), c2 = next_en_char_dig(str2, i2);
+        if (c1 != c2) {
+            return (c1 < c2 ? -1 : 1);
+        }
+        if (c1 == 0) {
+            return 0;
+        }
+    }
+}
+
+int compare_en_strings_r(const std::string_view &str1, const std::string_view &str2) {
+    size_t end1 = str1.size(), end2 = str2.size();
+    while (true) {
+        char c1 = prev_en_char_dig(str1, end1), c2 = prev_en_char_dig(str2, end2);
+        if (c1 != c2) {
+            return (c1 < c2 ? -1 : 1);
+        }
+        if (c1 == 0) {
+            return 0;
+        }
+    }
+}
+
+int compare_ru_strings(const std::string_view &str1, const std::string_view &str2) {
+    size_t i1 = 0, i2 = 0;
+    while (true) {
+        char16_t c1 = next_ru_char_dig(str1, i1), c2 = next_ru_char_dig(str2, i2);
+        if (c1 == 0 || c2 == 0) {
+            return (c1 != 0) - (c2 != 0);
+        }
+        int cmp_chars_res = ru_char_cmp(c1, c2);
+        if (cmp_chars_res != 0) {
+            return cmp_chars_res;
+        }
     }
-    uint32_t file_in_size = GetFileSize(file_in_handle, NULL);
-    if (file_in_size == INVALID_FILE_SIZE) {
-        throw std::runtime_error((std::string)"sort_text: cannot get size of file_in_path: " + GetLastErrorAsString());
+}
+
+int compare_ru_strings_r(const std::string_view &str1, const std::string_view &str2) {
+    size_t end1 = str1.size(), end2 = str2.size();
+    while (true) {
+        char16_t c1 = prev_ru_char_dig(str1, end1), c2 = prev_ru_char_dig(str2, end2);
+        if (c1 == 0 || c2 == 0) {
+            return (c1 != 0) - (c2 != 0);
+        }
+        int cmp_chars_res = ru_char_cmp(c1, c2);
+        if (cmp_chars_res != 0) {
+            return cmp_chars_res;
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------------------------
+
+/*
+Writes bom and lines separated by "\r\n" (UTF-16) or '\n' (UTF-8) to the file at file_name
+*/
+template<typename Char>
+void write_text_file(const char *file_name, const std::basic_string_view<Char> &bom,
+                     const std::vector< std::basic_string_view<Char> > &string_vec) {
+    std::unique_ptr<FILE, int (*)(FILE *)> file_out(fopen(file_name, "wb"), fclose);
+    if (file_out == nullptr) {
+        throw std::runtime_error((std::string)"sort_text: cannot open " + file_name);
     }
-    HANDLE file_in_mapping = CreateFileMapping(file_in_handle, NULL, PAGE_READONLY, 0, 0, NULL);
-    if (file_in_mapping == NULL) {
-        throw std::runtime_error((std::string)"sort_text: cannot map file_in_path: " + GetLastErrorAsString());
+    if (fwrite((const void *)bom.data(), sizeof(bom[0]), bom.size(), file_out.get()) != bom.size()) {
+        throw std::runtime_error((std::string)"sort_text: error occurred while writing in " + file_name);
     }
-    const char16_t *file_in_data = (const char16_t *)MapViewOfFile(file_in_mapping, FILE_MAP_READ, 0, 0, 0);
-    if (file_in_data == NULL) {
-        throw std::runtime_error((std::string)"sort_text: cannot map file_in_path: " + GetLastErrorAsString());
+    write_lines(file_out.get(), string_vec, file_name);
+    if (fclose(file_out.release()) != 0) {
+        throw std::runtime_error((std::string)"sort_text: cannot close " + file_name);
     }
+}
 
-    std::vector< std::basic_string_view<char16_t> > string_vec = data_to_strings(file_in_data, file_in_size);
+/*
+Writes lines sorted by their collation keys to sorted_vec, lines must be in the order of the file
+*/
+template<typename Char>
+void sort_by_keys(const std::vector< std::basic_string_view<Char> > &string_vec, std::vector< std::basic_string_view<Char> > &sorted_vec,
+                  language lang, bool reverse, sorting_method method, unsigned nthreads) {
+    collation_keys keys(string_vec, lang, reverse);
+    std::vector<collation_key> &key_vec = keys.keys();
+    if (method == MULTIKEY_KEYS) {
+        multikey_qsort(&(key_vec[0]), &(key_vec[0]) + key_vec.size());
+    } else {
+        parallel_sort<collation_key>(&(key_vec[0]), &(key_vec[0]) + key_vec.size(),
+              [](const collation_key &key1, const collation_key &key2) -> bool
+              {
+                  int res = compare_collation_keys(key1, key2);
+                  return res < 0 || (res == 0 && key1.index <= key2.index);
+              }, nthreads);
+    }
+    for (size_t i = 0; i < key_vec.size(); i++) {
+        sorted_vec[i] = string_vec[key_vec[i].index];
+    }
+}
 
-    comparator< std::basic_string_view<char16_t> > cmp_strings   = nullptr;
-    comparator< std::basic_string_view<char16_t> > cmp_strings_r = nullptr;
+/*
+Does sort_text for the lines of the file (UTF-16 or UTF-8), every output file begins with bom
+*/
+template<typename Char>
+void sort_lines(const std::vector< std::basic_string_view<Char> > &string_vec, const std::basic_string_view<Char> &bom,
+                const char *file_out_sorted_path, const char *file_out_sorted_back_path, const char *file_out_origin_path,
+                language lang, sorting_method method)
+{
+    /* Equal lines keep their order, so the result does not depend on the number of threads */
+    comparator< std::basic_string_view<Char> > cmp_strings   = nullptr;
+    comparator< std::basic_string_view<Char> > cmp_strings_r = nullptr;
     switch(lang) {
     case ENGLISH:
-        cmp_strings =   [](const std::basic_string_view<char16_t> &str1, const std::basic_string_view<char16_t> &str2) -> bool
+        cmp_strings =   [](const std::basic_string_view<Char> &str1, const std::basic_string_view<Char> &str2) -> bool
                         {
-                            return compare_en_strings(str1, str2) <= 0;
+                            int res = compare_en_strings(str1, str2);
+                            return res < 0 || (res == 0 && str1.data() <= str2.data());
                         };
-        cmp_strings_r = [](const std::basic_string_view<char16_t> &str1, const std::basic_string_view<char16_t> &str2) -> bool
+        cmp_strings_r = [](const std::basic_string_view<Char> &str1, const std::basic_string_view<Char> &str2) -> bool
                         {
-                            return compare_en_strings_r(str1, str2) <= 0;
+                            int res = compare_en_strings_r(str1, str2);
+                            return res < 0 || (res == 0 && str1.data() <= str2.data());
                         };
         break;
     case RUSSIAN:
-        cmp_strings =   [](const std::basic_string_view<char16_t> &str1, const std::basic_string_view<char16_t> &str2) -> bool
+        cmp_strings =   [](const std::basic_string_view<Char> &str1, const std::basic_string_view<Char> &str2) -> bool
                         {
-                            return compare_ru_strings(str1, str2) <= 0;
+                            int res = compare_ru_strings(str1, str2);
+                            return res < 0 || (res == 0 && str1.data() <= str2.data());
                         };
-        cmp_strings_r = [](const std::basic_string_view<char16_t> &str1, const std::basic_string_view<char16_t> &str2) -> bool
+        cmp_strings_r = [](const std::basic_string_view<Char> &str1, const std::basic_string_view<Char> &str2) -> bool
                         {
-                            return compare_ru_strings_r(str1, str2) <= 0;
+                            int res = compare_ru_strings_r(str1, str2);
+                            return res < 0 || (res == 0 && str1.data() <= str2.data());
                         };
         break;
     default: throw std::invalid_argument("sort_text: unknown language");
     }
-
-    FILE *file_out = fopen(file_out_sorted_path, "wb");
-    if (file_out == nullptr) {
-        throw std::runtime_error((std::string)"sort_text: cannot open " + file_out_sorted_path);
-    }
-    char16_t bom = 0xfeff;
-    if (fwrite((void *)&bom, sizeof(bom), 1, file_out) != 1) {
-        throw std::runtime_error((std::string)"sort_text: error occurred while writing in " + file_out_sorted_path);
-    }
-
-    qsort< std::basic_string_view<char16_t> >(&(string_vec[0]), &(string_vec[0]) + string_vec.size(), cmp_strings);
-    print_to_file(file_out, string_vec, file_out_sorted_path);
-
-    if (fclose(file_out) != 0) {
-        throw std::runtime_error((std::string)"sort_text: cannot close " + file_out_sorted_path);
-    }
-
-
-    file_out = fopen(file_out_sorted_back_path, "wb");
-    if (file_out == nullptr) {
-        throw std::runtime_error((std::string)"sort_text: cannot open " + file_out_sorted_back_path);
-    }
-    if (fwrite((void *)&bom, sizeof(bom), 1, file_out) != 1) {
-        throw std::runtime_error((std::string)"sort_text: error occurred while writing in " + file_out_sorted_back_path);
-    }
-
-    qsort< std::basic_string_view<char16_t> >(&(string_vec[0]), &(string_vec[0]) + string_vec.size(), cmp_strings_r);
-    print_to_file(file_out, string_vec, file_out_sorted_back_path);
-
-    if (fclose(file_out) != 0) {
-        throw std::runtime_error((std::string)"sort_text: cannot close " + file_out_sorted_back_path);
-    }
-
-
-    file_out = fopen(file_out_origin_path, "wb");
-    if (file_out == nullptr) {
-        throw std::runtime_error((std::string)"sort_text: cannot open " + file_out_origin_path);
+    if (method != COMPARE_LINES && method != COMPARE_KEYS && method != MULTIKEY_KEYS) {
+        throw std::invalid_argument("sort_text: unknown sorting method");
     }
-    if (fwrite((void *)&bom, sizeof(bom), 1, file_out) != 1) {
-        throw std::runtime_error((std::string)"sort_text: error occurred while writing in " + file_out_origin_path);
+    if (string_vec.size() > UINT32_MAX) {
+        throw std::invalid_argument("sort_text: too many lines in file_in_path");
     }
 
-    /* We can just write data from file_in_data to file_out, but that's not interesting. Let's sort */
-
-    qsort< std::basic_string_view<char16_t> >(&(string_vec[0]), &(string_vec[0]) + string_vec.size(),
-          [](const std::basic_string_view<char16_t> &str1, const std::basic_string_view<char16_t> &str2) -> bool
-          {
-              return str1.data() <= str2.data();
-          });
-    print_to_file(file_out, string_vec, file_out_origin_path);
-
-    if (fclose(file_out) != 0) {
-        throw std::runtime_error((std::string)"sort_text: cannot close " + file_out_origin_path);
+    /*
+    string_vec stays in the order of the file, so the origin version is written from it at once. Both sorted versions
+    are made at the same time, each by its own thread, which writes its file as soon as its lines are sorted.
+    */
+    const unsigned sort_threads = std::max(1u, std::thread::hardware_concurrency() / 2);
+    auto sort_and_write = [&](bool reverse, const char *file_out_path) {
+        std::vector< std::basic_string_view<Char> > sorted_vec(string_vec.size());
+        if (method != COMPARE_LINES) {
+            sort_by_keys(string_vec, sorted_vec, lang, reverse, method, sort_threads);
+        } else {
+            sorted_vec = string_vec;
+            parallel_sort< std::basic_string_view<Char> >(&(sorted_vec[0]), &(sorted_vec[0]) + sorted_vec.size(),
+                                                          reverse ? cmp_strings_r : cmp_strings, sort_threads);
+        }
+        write_text_file(file_out_path, bom, sorted_vec);
+    };
+
+    // errors of the sorted, sorted from back and origin versions, the first one is thrown
+    std::exception_ptr errors[3];
+    std::thread sorted_thread([&]() {
+        try {
+            sort_and_write(false, file_out_sorted_path);
+        } catch (...) {
+            errors[0] = std::current_exception();
+        }
+    });
+    std::thread sorted_back_thread([&]() {
+        try {
+            sort_and_write(true, file_out_sorted_back_path);
+        } catch (...) {
+            errors[1] = std::current_exception();
+        }
+    });
+    try {
+        write_text_file(file_out_origin_path, bom, string_vec);
+    } catch (...) {
+        errors[2] = std::current_exception();
+    }
+    sorted_thread.join();
+    sorted_back_thread.join();
+    for (const std::exception_ptr &error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
     }
+}
 
-
-    if (UnmapViewOfFile((LPCVOID)file_in_data) == 0) {
-        throw std::runtime_error("sort_text: cannot unmap file_in_path: " + GetLastErrorAsString());
-    }
-    if (CloseHandle(file_in_mapping) == 0) {
-        throw std::runtime_error("sort_text: cannot unmap file_in_path: " + GetLastErrorAsString());
-    }
-    if (CloseHandle(file_in_handle) == 0) {
-        throw std::runtime_error("sort_text: cannot close file_in_path: " + GetLastErrorAsString());
+void sort_text(const char *file_in_path, const char *file_out_sorted_path, const char *file_out_sorted_back_path, const char *file_out_origin_path, language lang,
+               sorting_method method)
+{
+    mapped_file file_in(file_in_path);
+    const char *file_data = file_in.data();
+    const size_t file_size = file_in.size();
+    if (file_size >= sizeof(char16_t) && (*(const char16_t *)file_data == 0xfeff || *(const char16_t *)file_data == 0xfffe)) {
+        std::vector< std::basic_string_view<char16_t> > string_vec = data_to_strings((const char16_t *)file_data, file_size);
+        // the lines are read in any order from now on
+        file_in.advise(NORMAL_ACCESS);
+        const char16_t bom = 0xfeff;
+        sort_lines(string_vec, std::basic_string_view<char16_t>(&bom, 1),
+                   file_out_sorted_path, file_out_sorted_back_path, file_out_origin_path, lang, method);
+    } else {
+        // UTF-8, the lines are views of the mapped file, the byte order mask is written back if it is there
+        const std::string_view utf8_bom("\xef\xbb\xbf");
+        size_t bom_size = (std::string_view(file_data, file_size).substr(0, utf8_bom.size()) == utf8_bom ? utf8_bom.size() : 0);
+        std::vector<std::string_view> string_vec = split_utf8_lines(file_data, bom_size, file_size);
+        file_in.advise(NORMAL_ACCESS);
+        sort_lines(string_vec, utf8_bom.substr(0, bom_size),
+                   file_out_sorted_path, file_out_sorted_back_path, file_out_origin_path, lang, method);
     }
 }
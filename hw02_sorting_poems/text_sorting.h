@@ -8,6 +8,12 @@ enum language {
     ENGLISH
 };
 
+enum sorting_method {
+    COMPARE_LINES, //!< The comparators are called on the lines themselves
+    COMPARE_KEYS,  //!< Every line is converted to a collation key once, then the keys are compared (see collation_keys.h)
+    MULTIKEY_KEYS  //!< The collation keys are sorted byte by byte with multikey quicksort in one thread (see multikey_qsort.h)
+};
+
 ///-------------------------------------------------------------------------------------
 //! <b> That is the function that performs the algorithm specified at the main page of the documentation. </b>
 //! Sorts lines in text from file three times: in ascending order, in ascending order from the back of the line, to its original version.
@@ -17,14 +23,25 @@ enum language {
 //! @param [in] file_out_sorted_back_path  Path to the file where to write the sorted from back version
 //! @param [in] file_out_origin_path       Path to the file where to write the origin version
 //! @param [in] lang                       The language of the text
+//! @param [in] method                     How to compare the lines (the result is the same)
 //!
 //! @attention If @c file_out_path exists, it will be overwritten
 //!
 //! @note While comparing lines not alpha and not digit symbols are ignored, uppercase and lowercase symbols are considered equal.
 //!       Only letters of the specified ( @c lang ) alphabet are not ignored.
 //!
+//! @note The file can be UTF-16 with byte order mask and lines separated by "\r\n" or, if it does not begin with UTF-16
+//!       byte order mask, UTF-8 with lines separated by '\n'. UTF-8 lines are compared right in the mapped file,
+//!       without converting them to UTF-16. The output files have the encoding, the line separators and the byte order
+//!       mask (UTF-8 one is optional) of the input file.
+//!
+//! @note The origin version is written from the lines in the order of the file while the sorted and sorted from back
+//!       versions are made in two other threads, each of them writes its file as soon as its lines are sorted.
+//!       Every sort gets half of the hardware threads.
+//!
 ///-------------------------------------------------------------------------------------
-void sort_text(const char *file_in_path, const char *file_out_sorted_path, const char *file_out_sorted_back_path, const char *file_out_origin_path, language lang);
+void sort_text(const char *file_in_path, const char *file_out_sorted_path, const char *file_out_sorted_back_path, const char *file_out_origin_path, language lang,
+               sorting_method method = COMPARE_KEYS);
 
 ///-------------------------------------------------------------------------------------
 //! Compares two strings ignoring not English alpha and not digit symbols and considering uppercase and lowercase symbols equal.
@@ -70,4 +87,51 @@ int compare_ru_strings(const std::basic_string_view<char16_t> &str1, const std::
 ///-------------------------------------------------------------------------------------
 int compare_ru_strings_r(const std::basic_string_view<char16_t> &str1, const std::basic_string_view<char16_t> &str2);
 
+///-------------------------------------------------------------------------------------
+//! Compares two UTF-8 strings like @c compare_en_strings compares the same strings in UTF-16.
+//! English letters and digits are ASCII, so the bytes are compared without decoding.
+//!
+//! @param [in] str1  First string
+//! @param [in] str2  Second string
+//!
+//! @return -1 if str1 is less than str2. 1 if str1 is greater than str2. 0 if they are equal.
+//!
+///-------------------------------------------------------------------------------------
+int compare_en_strings(const std::string_view &str1, const std::string_view &str2);
+
+///-------------------------------------------------------------------------------------
+//! Compares two UTF-8 strings like @c compare_en_strings_r compares the same strings in UTF-16
+//!
+//! @param [in] str1  First string
+//! @param [in] str2  Second string
+//!
+//! @return -1 if str1 is less than str2. 1 if str1 is greater than str2. 0 if they are equal.
+//!
+///-------------------------------------------------------------------------------------
+int compare_en_strings_r(const std::string_view &str1, const std::string_view &str2);
+
+///-------------------------------------------------------------------------------------
+//! Compares two UTF-8 strings like @c compare_ru_strings compares the same strings in UTF-16.
+//! ASCII bytes are taken as they are, two-byte symbols (Russian letters) are decoded, other symbols are skipped
+//! byte by byte (see utf8_symbols.h).
+//!
+//! @param [in] str1  First string
+//! @param [in] str2  Second string
+//!
+//! @return -1 if str1 is less than str2. 1 if str1 is greater than str2. 0 if they are equal.
+//!
+///-------------------------------------------------------------------------------------
+int compare_ru_strings(const std::string_view &str1, const std::string_view &str2);
+
+///-------------------------------------------------------------------------------------
+//! Compares two UTF-8 strings like @c compare_ru_strings_r compares the same strings in UTF-16
+//!
+//! @param [in] str1  First string
+//! @param [in] str2  Second string
+//!
+//! @return -1 if str1 is less than str2. 1 if str1 is greater than str2. 0 if they are equal.
+//!
+///-------------------------------------------------------------------------------------
+int compare_ru_strings_r(const std::string_view &str1, const std::string_view &str2);
+
 #endif
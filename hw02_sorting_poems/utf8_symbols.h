@@ -0,0 +1,58 @@
+#ifndef __UTF8_SYMBOLS_FOR_ONEGIN
+#define __UTF8_SYMBOLS_FOR_ONEGIN
+
+#include <cassert>
+#include <cstddef>
+#include <string_view>
+
+///-------------------------------------------------------------------------------------
+//! Reads the symbol of UTF-8 string, that begins at @c i, and moves @c i to the next symbol
+//!
+//! @param [in]     str  The string
+//! @param [in,out] i    Index of the first byte of the symbol
+//!
+//! @return The symbol if it is ASCII or is coded with two bytes (like all Russian letters), 0 otherwise.
+//!         Other symbols are skipped byte by byte, every their byte gives 0.
+//!
+///-------------------------------------------------------------------------------------
+inline char16_t next_utf8_symbol(const std::string_view &str, size_t &i)
+{
+    assert(i < str.size());
+    unsigned char byte = (unsigned char)str[i++];
+    if (byte < 0x80) {
+        return byte;
+    }
+    if (byte >= 0xc0 && byte < 0xe0 && i < str.size() && ((unsigned char)str[i] & 0xc0) == 0x80) {
+        return (char16_t)(((byte & 0x1f) << 6) | ((unsigned char)str[i++] & 0x3f));
+    }
+    return 0;
+}
+
+///-------------------------------------------------------------------------------------
+//! Reads the symbol of UTF-8 string, that ends right before @c end, and moves @c end to the beginning of the symbol.
+//! For valid UTF-8 gives the same symbols as @c next_utf8_symbol in the reverse order.
+//!
+//! @param [in]     str  The string
+//! @param [in,out] end  Index of the byte after the symbol
+//!
+//! @return The same as @c next_utf8_symbol
+//!
+///-------------------------------------------------------------------------------------
+inline char16_t prev_utf8_symbol(const std::string_view &str, size_t &end)
+{
+    assert(end > 0 && end <= str.size());
+    unsigned char byte = (unsigned char)str[--end];
+    if (byte < 0x80) {
+        return byte;
+    }
+    if ((byte & 0xc0) == 0x80 && end > 0) {
+        unsigned char lead = (unsigned char)str[end - 1];
+        if (lead >= 0xc0 && lead < 0xe0) {
+            end--;
+            return (char16_t)(((lead & 0x1f) << 6) | (byte & 0x3f));
+        }
+    }
+    return 0;
+}
+
+#endif // __UTF8_SYMBOLS_FOR_ONEGIN